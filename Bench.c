@@ -0,0 +1,555 @@
+//-----------------------------------------------------------------------------
+// Bench.c
+// Benchmark driver for Graph ADT, reporting results as JSON
+//-----------------------------------------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "GraphGen.h"
+#include "Builder.h"
+#include "Centrality.h"
+#include "Coloring.h"
+#include "PageRank.h"
+#include "GraphIO.h"
+#include "HybridBFS.h"
+#include "Loader.h"
+#include "SpanningForest.h"
+#include "Triangle.h"
+
+// Searches per queryBatch() call in the queryBatch scenario
+#define BENCH_INTERLEAVE 8
+
+// Length of the random walk from each source to its destination in the
+// queryPairs and queryBatch scenarios
+#define BENCH_HOPS 3
+
+// Most scenarios one run can report; keepResult() exits if they outgrow it
+#define BENCH_SCENARIOS 32
+
+// Samples --------------------------------------------------------------------
+
+// Timings of one scenario. work[i] is the number of units (edges or path
+// vertices) processed by the i'th sample, used to report throughput.
+typedef struct Samples {
+    const char *name;
+    const char *unit;
+    double *seconds;
+    double *work;
+    int count;
+} Samples;
+
+// now()
+// Returns a monotonic timestamp in seconds.
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+// peakRSS()
+// Returns the peak resident set size of this process in kilobytes.
+static long peakRSS(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// newSamples()
+// Returns empty Samples called name, with room for capacity samples whose work
+// is counted in unit.
+static Samples newSamples(const char *name, const char *unit, int capacity) {
+    Samples S;
+    S.name = name;
+    S.unit = unit;
+    S.seconds = malloc(sizeof(double) * (size_t) capacity);
+    S.work = malloc(sizeof(double) * (size_t) capacity);
+    S.count = 0;
+    return S;
+}
+
+// addSample()
+// Records one sample that did work units in seconds.
+static void addSample(Samples *S, double seconds, double work) {
+    S->seconds[S->count] = seconds;
+    S->work[S->count] = work;
+    S->count++;
+}
+
+// compareDouble()
+// qsort() comparator for double arrays.
+static int compareDouble(const void *a, const void *b) {
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+// keepResult()
+// Appends S to results[0..*count-1], exiting if all BENCH_SCENARIOS are taken.
+static void keepResult(Samples *results, int *count, Samples S) {
+    if (*count == BENCH_SCENARIOS) {
+        printf("Bench Error: more than %d scenarios; raise BENCH_SCENARIOS\n", BENCH_SCENARIOS);
+        exit(1);
+    }
+    results[(*count)++] = S;
+}
+
+// percentile()
+// Returns the nearest-rank p'th percentile of the sorted array x[0..n-1].
+static double percentile(const double *x, int n, double p) {
+    int rank = (int) (p / 100.0 * n + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+    return x[rank - 1];
+}
+
+// printSamples()
+// Writes S as a JSON object to out and frees its arrays. Throughput is given
+// as the median per-sample rate and as the harmonic mean (total work over
+// total time), which is the convention for TEPS.
+static void printSamples(FILE *out, Samples *S, int last) {
+    double totalTime = 0;
+    double totalWork = 0;
+    double *rate = malloc(sizeof(double) * (size_t) (S->count > 0 ? S->count : 1));
+
+    for (int i = 0; i < S->count; i++) {
+        totalTime += S->seconds[i];
+        totalWork += S->work[i];
+        rate[i] = S->seconds[i] > 0 ? S->work[i] / S->seconds[i] : 0;
+    }
+    qsort(S->seconds, (size_t) S->count, sizeof(double), compareDouble);
+    qsort(rate, (size_t) S->count, sizeof(double), compareDouble);
+
+    fprintf(out, "    {\"name\": \"%s\", \"samples\": %d", S->name, S->count);
+    if (S->count > 0) {
+        fprintf(out, ", \"seconds\": {\"min\": %.9f, \"mean\": %.9f, \"p50\": %.9f, \"p90\": %.9f, "
+                     "\"p99\": %.9f, \"max\": %.9f}",
+                S->seconds[0], totalTime / S->count, percentile(S->seconds, S->count, 50),
+                percentile(S->seconds, S->count, 90), percentile(S->seconds, S->count, 99),
+                S->seconds[S->count - 1]);
+        fprintf(out, ", \"rate\": {\"unit\": \"%s\", \"p50\": %.1f, \"harmonic_mean\": %.1f}",
+                S->unit, percentile(rate, S->count, 50), totalTime > 0 ? totalWork / totalTime : 0);
+    }
+    fprintf(out, ", \"peak_rss_kb\": %ld}%s\n", peakRSS(), last ? "" : ",");
+
+    free(rate);
+    free(S->seconds);
+    free(S->work);
+}
+
+
+// Graph construction ---------------------------------------------------------
+
+// buildGraph()
+// Returns a Graph holding the edges of E, as undirected edges or as arcs.
+static Graph buildGraph(EdgeList E, int directed) {
+    Graph G = newGraph(edgeOrder(E));
+    Vertex *source = edgeSources(E);
+    Vertex *target = edgeTargets(E);
+
+    for (EdgeIndex i = 0; i < edgeCount(E); i++) {
+        if (directed)
+            addArc(G, source[i], target[i]);
+        else
+            addEdge(G, source[i], target[i]);
+    }
+    return G;
+}
+
+// generate()
+// Returns the edge list named by gen, or NULL if gen is unknown.
+static EdgeList generate(const char *gen, Vertex n, EdgeIndex m, int scale,
+                         Vertex rows, Vertex cols, uint64_t seed) {
+    if (strcmp(gen, "er") == 0)
+        return genErdosRenyi(n, m, seed);
+    if (strcmp(gen, "rmat") == 0)
+        return genRMAT(scale, m, 0.57, 0.19, 0.19, seed);
+    if (strcmp(gen, "grid") == 0)
+        return genGrid2D(rows, cols);
+    if (strcmp(gen, "path") == 0)
+        return genPath(n);
+    if (strcmp(gen, "star") == 0)
+        return genStar(n);
+    return NULL;
+}
+
+// wants()
+// Returns true (1) if the comma-separated -t list scenarios names the scenario
+// name exactly, or is "all".
+static int wants(const char *scenarios, const char *name) {
+    size_t length = strlen(name);
+
+    if (strcmp(scenarios, "all") == 0)
+        return 1;
+    for (const char *token = scenarios; ; token++) {
+        size_t span = strcspn(token, ",");
+        if (span == length && strncmp(token, name, length) == 0)
+            return 1;
+        token += span;
+        if (*token == '\0')
+            return 0;
+    }
+}
+
+// usage()
+// Prints the command line options and exits.
+static void usage(const char *prog) {
+    printf("Usage: %s [-g er|rmat|grid|path|star] [-n vertices] [-m edges] [-s scale]\n"
+           "          [-r rows] [-c cols] [-k reps] [-q queries] [-x seed] [-d]\n"
+           "          [-t load,loadPipelined,addArc,build,BFS,getPath,printGraph,triangles,\n"
+           "              hybridBFS,betweenness,pageRank,queryPairs,queryBatch,\n"
+           "              kruskal,boruvka,greedyColoring,parallelColoring,lubyMIS]\n"
+           "          [-o output.json]\n", prog);
+    exit(1);
+}
+
+int main(int argc, char *argv[]) {
+    const char *gen = "rmat";
+    const char *scenarios = "all";
+    const char *outName = NULL;
+    Vertex n = 1 << 16;
+    EdgeIndex m = 1 << 20;
+    int scale = 16;
+    Vertex rows = 256;
+    Vertex cols = 256;
+    int reps = 5;
+    int queries = 64;
+    uint64_t seed = 1;
+    int directed = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "g:n:m:s:r:c:k:q:x:dt:o:")) != -1) {
+        switch (opt) {
+            case 'g': gen = optarg; break;
+            case 'n': n = (Vertex) strtoll(optarg, NULL, 10); break;
+            case 'm': m = (EdgeIndex) strtoll(optarg, NULL, 10); break;
+            case 's': scale = atoi(optarg); break;
+            case 'r': rows = (Vertex) strtoll(optarg, NULL, 10); break;
+            case 'c': cols = (Vertex) strtoll(optarg, NULL, 10); break;
+            case 'k': reps = atoi(optarg); break;
+            case 'q': queries = atoi(optarg); break;
+            case 'x': seed = strtoull(optarg, NULL, 10); break;
+            case 'd': directed = 1; break;
+            case 't': scenarios = optarg; break;
+            case 'o': outName = optarg; break;
+            default: usage(argv[0]);
+        }
+    }
+    if (reps < 1 || queries < 1)
+        usage(argv[0]);
+
+    FILE *out = stdout;
+    if (outName != NULL && (out = fopen(outName, "w")) == NULL) {
+        printf("Unable to open file %s for writing\n", outName);
+        exit(1);
+    }
+
+    double start = now();
+    EdgeList E = generate(gen, n, m, scale, rows, cols, seed);
+    if (E == NULL)
+        usage(argv[0]);
+    double genTime = now() - start;
+
+    Vertex order = edgeOrder(E);
+    EdgeIndex edges = edgeCount(E);
+    double arcs = directed ? (double) edges : 2.0 * (double) edges;
+    uint64_t state = seed ^ 0x5DEECE66DULL;
+
+    // Out-degrees, used to count the edges a BFS traverses
+    EdgeIndex *degree = calloc((size_t) order + 1, sizeof(EdgeIndex));
+    for (EdgeIndex i = 0; i < edges; i++) {
+        degree[edgeSource(E, i)]++;
+        if (!directed)
+            degree[edgeTarget(E, i)]++;
+    }
+
+    Samples results[BENCH_SCENARIOS];
+    int numResults = 0;
+
+    // load: parse FindPath input text and build the Graph
+    if (wants(scenarios, "load")) {
+        FILE *text = tmpfile();
+        writeGraphInput(text, E);
+        Samples S = newSamples("load", "edges/s", reps);
+        for (int i = 0; i < reps; i++) {
+            rewind(text);
+            start = now();
+            Graph G = readGraph(text);
+            addSample(&S, now() - start, (double) edges);
+            freeGraph(&G);
+        }
+        fclose(text);
+        keepResult(results, &numResults, S);
+    }
+
+    // loadPipelined: the same input through the pipelined parallel loader
+    if (wants(scenarios, "loadPipelined") && !directed) {
+        FILE *text = tmpfile();
+        writeGraphInput(text, E);
+        Samples S = newSamples("loadPipelined", "edges/s", reps);
+        for (int i = 0; i < reps; i++) {
+            rewind(text);
+            start = now();
+            Graph G = loadGraph(text, NULL, 0);
+            addSample(&S, now() - start, (double) edges);
+            freeGraph(&G);
+        }
+        fclose(text);
+        keepResult(results, &numResults, S);
+    }
+
+    // addArc: insert the generated edges into an empty Graph
+    if (wants(scenarios, "addArc")) {
+        Samples S = newSamples("addArc", "arcs/s", reps);
+        for (int i = 0; i < reps; i++) {
+            start = now();
+            Graph G = buildGraph(E, directed);
+            addSample(&S, now() - start, arcs);
+            freeGraph(&G);
+        }
+        keepResult(results, &numResults, S);
+    }
+
+    // build: the parallel compact builder over the same edges
+    if (wants(scenarios, "build")) {
+        Samples S = newSamples("build", "arcs/s", reps);
+        for (int i = 0; i < reps; i++) {
+            start = now();
+            Graph G = newGraphFromEdges(E, !directed, 0, 0);
+            addSample(&S, now() - start, arcs);
+            freeGraph(&G);
+        }
+        keepResult(results, &numResults, S);
+    }
+
+    // Same adjacency buildGraph() gives, without the serial sorted inserts
+    Graph G = newGraphFromEdges(E, !directed, 0, 0);
+
+    // BFS: single-source traversals from random non-isolated sources
+    if (wants(scenarios, "BFS")) {
+        Samples S = newSamples("BFS", "TEPS", queries);
+        for (int i = 0; i < queries; i++) {
+            Vertex s = genRandomVertex(&state, order);
+            for (int tries = 0; degree[s] == 0 && tries < 64; tries++)
+                s = genRandomVertex(&state, order);
+
+            start = now();
+            BFS(G, s);
+            double seconds = now() - start;
+
+            double traversed = 0;
+            for (Vertex v = 1; v <= order; v++)
+                if (getDist(G, v) != INF)
+                    traversed += (double) degree[v];
+            addSample(&S, seconds, traversed);
+        }
+        keepResult(results, &numResults, S);
+    }
+
+    // hybridBFS: direction-optimizing traversals from the same kind of sources
+    if (wants(scenarios, "hybridBFS")) {
+        Vertex *distance = malloc(sizeof(Vertex) * ((size_t) order + 1));
+        Vertex *parent = malloc(sizeof(Vertex) * ((size_t) order + 1));
+        Samples S = newSamples("hybridBFS", "TEPS", queries);
+        for (int i = 0; i < queries; i++) {
+            Vertex s = genRandomVertex(&state, order);
+            for (int tries = 0; degree[s] == 0 && tries < 64; tries++)
+                s = genRandomVertex(&state, order);
+
+            start = now();
+            hybridBFS(G, s, distance, parent);
+            double seconds = now() - start;
+
+            double traversed = 0;
+            for (Vertex v = 1; v <= order; v++)
+                if (distance[v] != INF)
+                    traversed += (double) degree[v];
+            addSample(&S, seconds, traversed);
+        }
+        free(distance);
+        free(parent);
+        keepResult(results, &numResults, S);
+    }
+
+    // queryPairs, queryBatch: point-to-point searches to the end of a short
+    // random walk, one at a time or BENCH_INTERLEAVE at a time interleaved
+    for (int batched = 0; batched <= 1; batched++) {
+        const char *name = batched ? "queryBatch" : "queryPairs";
+        if (!wants(scenarios, name))
+            continue;
+        int group = batched ? BENCH_INTERLEAVE : 1;
+        const EdgeIndex *offset;
+        const Vertex *target;
+        getAdjacency(G, &offset, &target);
+        Query Q[BENCH_INTERLEAVE];
+        Vertex source[BENCH_INTERLEAVE];
+        Vertex dest[BENCH_INTERLEAVE];
+        for (int k = 0; k < group; k++)
+            Q[k] = newQuery(G);
+
+        Samples S = newSamples(name, "queries/s", reps);
+        for (int i = 0; i < reps; i++) {
+            start = now();
+            for (int q = 0; q < queries; q += group) {
+                int count = queries - q < group ? queries - q : group;
+                for (int k = 0; k < count; k++) {
+                    source[k] = genRandomVertex(&state, order);
+                    dest[k] = source[k];
+                    for (int h = 0; h < BENCH_HOPS && offset[dest[k] + 1] > offset[dest[k]]; h++)
+                        dest[k] = target[offset[dest[k]] + (EdgeIndex) (genRandom(&state) %
+                                  (uint64_t) (offset[dest[k] + 1] - offset[dest[k]]))];
+                }
+                queryBatch(Q, source, dest, count);
+            }
+            addSample(&S, now() - start, (double) queries);
+        }
+        for (int k = 0; k < group; k++)
+            freeQuery(&Q[k]);
+        keepResult(results, &numResults, S);
+    }
+
+    // getPath: path extraction to random destinations after an untimed BFS
+    if (wants(scenarios, "getPath")) {
+        Samples S = newSamples("getPath", "vertices/s", queries);
+        List L = newList();
+        for (int i = 0; i < queries; i++) {
+            BFS(G, genRandomVertex(&state, order));
+            Vertex d = genRandomVertex(&state, order);
+
+            start = now();
+            getPath(L, G, d);
+            addSample(&S, now() - start, (double) length(L));
+            clear(L);
+        }
+        freeList(&L);
+        keepResult(results, &numResults, S);
+    }
+
+    // printGraph: format the adjacency lists, discarding the output
+    if (wants(scenarios, "printGraph")) {
+        FILE *sink = fopen("/dev/null", "w");
+        Samples S = newSamples("printGraph", "arcs/s", reps);
+        for (int i = 0; i < reps && sink != NULL; i++) {
+            start = now();
+            printGraph(sink, G);
+            fflush(sink);
+            addSample(&S, now() - start, arcs);
+        }
+        if (sink != NULL)
+            fclose(sink);
+        keepResult(results, &numResults, S);
+    }
+
+    // triangles: triangle count with the default thread count (undirected only)
+    if (wants(scenarios, "triangles") && !directed) {
+        Samples S = newSamples("triangles", "edges/s", reps);
+        for (int i = 0; i < reps; i++) {
+            start = now();
+            countTriangles(G, NULL, 0);
+            addSample(&S, now() - start, (double) edges);
+        }
+        keepResult(results, &numResults, S);
+    }
+
+    // kruskal, boruvka: minimum spanning forest of the edges with random
+    // weights, default thread count
+    for (int boruvka = 0; boruvka <= 1; boruvka++) {
+        const char *name = boruvka ? "boruvka" : "kruskal";
+        if (!wants(scenarios, name))
+            continue;
+        if (edgeWeights(E) == NULL)
+            genWeights(E, seed);
+
+        Samples S = newSamples(name, "edges/s", reps);
+        for (int i = 0; i < reps; i++) {
+            start = now();
+            EdgeList F = boruvka ? boruvkaForest(E, NULL, 0) : kruskalForest(E, NULL, 0);
+            addSample(&S, now() - start, (double) edges);
+            freeEdgeList(&F);
+        }
+        keepResult(results, &numResults, S);
+    }
+
+    // greedyColoring, parallelColoring: smallest-last greedy and Jones-Plassmann
+    // with the default thread count (undirected only)
+    for (int parallel = 0; parallel <= 1; parallel++) {
+        const char *name = parallel ? "parallelColoring" : "greedyColoring";
+        if (!wants(scenarios, name) || directed)
+            continue;
+
+        Vertex *color = malloc(sizeof(Vertex) * ((size_t) order + 1));
+        Samples S = newSamples(name, "edges/s", reps);
+        for (int i = 0; i < reps; i++) {
+            start = now();
+            if (parallel)
+                parallelColoring(G, color, seed + (uint64_t) i, 0);
+            else
+                greedyColoring(G, COLOR_SMALLEST_LAST, color);
+            addSample(&S, now() - start, (double) edges);
+        }
+        free(color);
+        keepResult(results, &numResults, S);
+    }
+
+    // lubyMIS: maximal independent set, default thread count (undirected only)
+    if (wants(scenarios, "lubyMIS") && !directed) {
+        int *inSet = malloc(sizeof(int) * ((size_t) order + 1));
+        Samples S = newSamples("lubyMIS", "edges/s", reps);
+        for (int i = 0; i < reps; i++) {
+            start = now();
+            lubyMIS(G, inSet, seed + (uint64_t) i, 0);
+            addSample(&S, now() - start, (double) edges);
+        }
+        free(inSet);
+        keepResult(results, &numResults, S);
+    }
+
+    // betweenness: Brandes from queries sampled sources, default thread count
+    if (wants(scenarios, "betweenness")) {
+        double *score = malloc(sizeof(double) * ((size_t) order + 1));
+        Samples S = newSamples("betweenness", "TEPS", reps);
+        for (int i = 0; i < reps; i++) {
+            start = now();
+            betweenness(G, score, (Vertex) queries, seed + (uint64_t) i, 0);
+            addSample(&S, now() - start, arcs * (double) (queries < order ? queries : order));
+        }
+        free(score);
+        keepResult(results, &numResults, S);
+    }
+
+    // pageRank: pull iterations to convergence, default thread count
+    if (wants(scenarios, "pageRank")) {
+        float *rank = malloc(sizeof(float) * ((size_t) order + 1));
+        Samples S = newSamples("pageRank", "iterations/s", reps);
+        for (int i = 0; i < reps; i++) {
+            start = now();
+            int iterations = pageRank(G, rank, 0.85, 1e-6, 100, NULL, 0);
+            addSample(&S, now() - start, (double) iterations);
+        }
+        free(rank);
+        keepResult(results, &numResults, S);
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"generator\": \"%s\", \"directed\": %s, \"seed\": %" PRIu64 ",\n",
+            gen, directed ? "true" : "false", seed);
+    fprintf(out, "  \"order\": %" PRIvertex ", \"edges\": %" PRIedge ", \"vertex_bits\": %d,\n",
+            order, edges, (int) (sizeof(Vertex) * 8));
+    fprintf(out, "  \"generate_seconds\": %.9f,\n", genTime);
+    fprintf(out, "  \"scenarios\": [\n");
+    for (int i = 0; i < numResults; i++)
+        printSamples(out, &results[i], i == numResults - 1);
+    fprintf(out, "  ],\n");
+    fprintf(out, "  \"peak_rss_kb\": %ld\n", peakRSS());
+    fprintf(out, "}\n");
+
+    freeGraph(&G);
+    freeEdgeList(&E);
+    free(degree);
+    if (out != stdout)
+        fclose(out);
+    return 0;
+}
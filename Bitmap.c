@@ -0,0 +1,261 @@
+//-----------------------------------------------------------------------------
+// Bitmap.c
+// Implementation file for vertex bitmap kernels used by frontier-based
+// traversals
+//-----------------------------------------------------------------------------
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Bitmap.h"
+
+// The gather kernels index 32-bit lanes, so the SIMD kernels are only built
+// for x86 with the default vertex width. Each is compiled for its own target
+// and chosen at run time, so the library itself needs no -m flags. Bitmaps
+// are read as 32-bit words by the gathers, which on little-endian x86 puts
+// vertex v at bit v % 32 of word v / 32.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && !defined(GRAPHADT_VERTEX64)
+#define BITMAP_X86
+#include <immintrin.h>
+#endif
+
+typedef EdgeIndex (*CountKernel)(const uint64_t *, EdgeIndex);
+typedef EdgeIndex (*MergeKernel)(uint64_t *, const uint64_t *, EdgeIndex);
+typedef EdgeIndex (*FindKernel)(const uint64_t *, const Vertex *, EdgeIndex);
+
+static EdgeIndex countScalar(const uint64_t *a, EdgeIndex words);
+static EdgeIndex mergeScalar(uint64_t *into, const uint64_t *from, EdgeIndex words);
+static EdgeIndex findScalar(const uint64_t *bits, const Vertex *list, EdgeIndex len);
+
+static CountKernel countKernel = countScalar;
+static MergeKernel mergeKernel = mergeScalar;
+static FindKernel findKernel = findScalar;
+static const char *kernelName = "scalar";
+static pthread_once_t kernelOnce = PTHREAD_ONCE_INIT;
+
+
+// Scalar kernels -------------------------------------------------------------
+
+// countScalar()
+// Counts bits a word at a time.
+// Private.
+static EdgeIndex countScalar(const uint64_t *a, EdgeIndex words) {
+    EdgeIndex count = 0;
+    for (EdgeIndex i = 0; i < words; i++)
+        count += __builtin_popcountll(a[i]);
+    return count;
+}
+
+// mergeScalar()
+// Merges and counts a word at a time.
+// Private.
+static EdgeIndex mergeScalar(uint64_t *into, const uint64_t *from, EdgeIndex words) {
+    EdgeIndex count = 0;
+    for (EdgeIndex i = 0; i < words; i++) {
+        into[i] |= from[i];
+        count += __builtin_popcountll(from[i]);
+    }
+    return count;
+}
+
+// findScalar()
+// Tests one neighbor at a time.
+// Private.
+static EdgeIndex findScalar(const uint64_t *bits, const Vertex *list, EdgeIndex len) {
+    for (EdgeIndex i = 0; i < len; i++)
+        if (BITMAP_TEST(bits, list[i]))
+            return i;
+    return len;
+}
+
+
+// SIMD kernels ---------------------------------------------------------------
+
+#ifdef BITMAP_X86
+
+// Neighbors tested one at a time before gathering: bottom-up searches often
+// stop at the first few, where a gather would cost more than it saves
+#define FIND_HEAD 4
+
+// countPopcnt()
+// Counts bits with the popcnt instruction, which every AVX2 CPU has.
+// Private.
+__attribute__((target("popcnt")))
+static EdgeIndex countPopcnt(const uint64_t *a, EdgeIndex words) {
+    EdgeIndex count = 0;
+    for (EdgeIndex i = 0; i < words; i++)
+        count += _mm_popcnt_u64(a[i]);
+    return count;
+}
+
+// popcountAVX2()
+// Returns the bit counts of the four 64-bit lanes of v, by nibble lookup.
+// Private.
+__attribute__((target("avx2")))
+static __m256i popcountAVX2(__m256i v) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, low));
+    __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+    return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+
+// mergeAVX2()
+// Merges four words per step, counting the merged-in bits by nibble lookup.
+// Private.
+__attribute__((target("avx2,popcnt")))
+static EdgeIndex mergeAVX2(uint64_t *into, const uint64_t *from, EdgeIndex words) {
+    __m256i sum = _mm256_setzero_si256();
+    EdgeIndex i = 0;
+
+    for (; i + 4 <= words; i += 4) {
+        __m256i f = _mm256_loadu_si256((const __m256i *) (from + i));
+        __m256i t = _mm256_loadu_si256((const __m256i *) (into + i));
+        _mm256_storeu_si256((__m256i *) (into + i), _mm256_or_si256(t, f));
+        sum = _mm256_add_epi64(sum, popcountAVX2(f));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *) lanes, sum);
+    EdgeIndex count = (EdgeIndex) (lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    for (; i < words; i++) {
+        into[i] |= from[i];
+        count += _mm_popcnt_u64(from[i]);
+    }
+    return count;
+}
+
+// findAVX2()
+// Gathers the bitmap words of eight neighbors per step and tests their bits
+// with per-lane shifts.
+// Private.
+__attribute__((target("avx2")))
+static EdgeIndex findAVX2(const uint64_t *bits, const Vertex *list, EdgeIndex len) {
+    const int *words = (const int *) bits;
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i low = _mm256_set1_epi32(31);
+    EdgeIndex i = findScalar(bits, list, len < FIND_HEAD ? len : FIND_HEAD);
+
+    if (i < FIND_HEAD)
+        return i;
+
+    for (; i + 8 <= len; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *) (list + i));
+        __m256i w = _mm256_i32gather_epi32(words, _mm256_srli_epi32(v, 5), 4);
+        __m256i bit = _mm256_and_si256(_mm256_srlv_epi32(w, _mm256_and_si256(v, low)), one);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(bit, one)));
+        if (mask != 0)
+            return i + __builtin_ctz((unsigned) mask);
+    }
+    return i + findScalar(bits, list + i, len - i);
+}
+
+// mergeAVX512()
+// Merges eight words per step, counting by nibble lookup in 512-bit lanes.
+// Private.
+__attribute__((target("avx512f,avx512bw,popcnt")))
+static EdgeIndex mergeAVX512(uint64_t *into, const uint64_t *from, EdgeIndex words) {
+    const __m512i table = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3,
+                                                               1, 2, 2, 3, 2, 3, 3, 4));
+    const __m512i low = _mm512_set1_epi8(0x0F);
+    __m512i sum = _mm512_setzero_si512();
+    EdgeIndex i = 0;
+
+    for (; i + 8 <= words; i += 8) {
+        __m512i f = _mm512_loadu_si512((const void *) (from + i));
+        __m512i t = _mm512_loadu_si512((const void *) (into + i));
+        _mm512_storeu_si512((void *) (into + i), _mm512_or_si512(t, f));
+        __m512i lo = _mm512_shuffle_epi8(table, _mm512_and_si512(f, low));
+        __m512i hi = _mm512_shuffle_epi8(table, _mm512_and_si512(_mm512_srli_epi16(f, 4), low));
+        sum = _mm512_add_epi64(sum, _mm512_sad_epu8(_mm512_add_epi8(lo, hi), _mm512_setzero_si512()));
+    }
+
+    EdgeIndex count = (EdgeIndex) _mm512_reduce_add_epi64(sum);
+    for (; i < words; i++) {
+        into[i] |= from[i];
+        count += _mm_popcnt_u64(from[i]);
+    }
+    return count;
+}
+
+// findAVX512()
+// Gathers the bitmap words of sixteen neighbors per step and tests their bits
+// into a mask register.
+// Private.
+__attribute__((target("avx512f")))
+static EdgeIndex findAVX512(const uint64_t *bits, const Vertex *list, EdgeIndex len) {
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i low = _mm512_set1_epi32(31);
+    EdgeIndex i = findScalar(bits, list, len < FIND_HEAD ? len : FIND_HEAD);
+
+    if (i < FIND_HEAD)
+        return i;
+
+    for (; i + 16 <= len; i += 16) {
+        __m512i v = _mm512_loadu_si512((const void *) (list + i));
+        __m512i w = _mm512_i32gather_epi32(_mm512_srli_epi32(v, 5), (const void *) bits, 4);
+        __mmask16 mask = _mm512_test_epi32_mask(_mm512_srlv_epi32(w, _mm512_and_si512(v, low)), one);
+        if (mask != 0)
+            return i + __builtin_ctz((unsigned) mask);
+    }
+    return i + findScalar(bits, list + i, len - i);
+}
+
+#endif
+
+
+// Dispatch -------------------------------------------------------------------
+
+// selectKernels()
+// Picks the widest kernels this CPU supports, capped by GRAPHADT_SIMD. Runs
+// once.
+// Private.
+static void selectKernels(void) {
+#ifdef BITMAP_X86
+    const char *cap = getenv("GRAPHADT_SIMD");
+    int wide = cap == NULL || strcmp(cap, "avx512") == 0;
+    int any = cap == NULL || (strcmp(cap, "scalar") != 0 && strcmp(cap, "ssse3") != 0);
+
+    __builtin_cpu_init();
+    if (any && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        countKernel = countPopcnt;
+        mergeKernel = mergeAVX2;
+        findKernel = findAVX2;
+        kernelName = "avx2";
+        if (wide && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+            mergeKernel = mergeAVX512;
+            findKernel = findAVX512;
+            kernelName = "avx512";
+        }
+    }
+#endif
+}
+
+// bitmapCount()
+// Returns the number of bits set in a[0..words-1].
+EdgeIndex bitmapCount(const uint64_t *a, EdgeIndex words) {
+    pthread_once(&kernelOnce, selectKernels);
+    return countKernel(a, words);
+}
+
+// bitmapMerge()
+// ORs from into into and returns the number of bits set in from.
+EdgeIndex bitmapMerge(uint64_t *into, const uint64_t *from, EdgeIndex words) {
+    pthread_once(&kernelOnce, selectKernels);
+    return mergeKernel(into, from, words);
+}
+
+// bitmapFindAny()
+// Returns the index of the first listed vertex whose bit is set, or len.
+EdgeIndex bitmapFindAny(const uint64_t *bits, const Vertex *list, EdgeIndex len) {
+    pthread_once(&kernelOnce, selectKernels);
+    return findKernel(bits, list, len);
+}
+
+// bitmapKernel()
+// Returns the name of the kernels in use.
+const char *bitmapKernel(void) {
+    pthread_once(&kernelOnce, selectKernels);
+    return kernelName;
+}
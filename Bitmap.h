@@ -0,0 +1,44 @@
+//-----------------------------------------------------------------------------
+// Bitmap.h
+// Header file for vertex bitmap kernels used by frontier-based traversals
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_BITMAP_H
+#define GRAPHADT_BITMAP_H
+
+#include"GraphTypes.h"
+
+// A bitmap over vertices 0..n is an array of BITMAP_WORDS(n) 64-bit words,
+// vertex v being bit v % 64 of word v / 64.
+#define BITMAP_WORDS(n) (((EdgeIndex) (n) + 64) / 64)
+#define BITMAP_TEST(b, v) (((b)[(v) >> 6] >> ((v) & 63)) & 1)
+#define BITMAP_SET(b, v) ((b)[(v) >> 6] |= (uint64_t) 1 << ((v) & 63))
+
+// Each entry point dispatches to the widest kernel the CPU supports, picked
+// once at first use: AVX-512, AVX2 or scalar. Setting the GRAPHADT_SIMD
+// environment variable to "avx2" or "scalar" caps the choice, for comparing
+// kernels on one machine; "ssse3", which only Intersect.h has kernels for,
+// means scalar here.
+
+// bitmapCount()
+// Returns the number of bits set in a[0..words-1].
+EdgeIndex bitmapCount(const uint64_t *a, EdgeIndex words);
+
+// bitmapMerge()
+// Sets into[i] |= from[i] for 0 <= i < words and returns the number of bits
+// set in from, so a frontier can be folded into the visited set and sized in
+// one pass.
+EdgeIndex bitmapMerge(uint64_t *into, const uint64_t *from, EdgeIndex words);
+
+// bitmapFindAny()
+// Returns the index of the first vertex of list[0..len-1] whose bit is set
+// in bits, or len if there is none. Vectorized kernels test a whole block of
+// neighbors per step with a gather.
+EdgeIndex bitmapFindAny(const uint64_t *bits, const Vertex *list, EdgeIndex len);
+
+// bitmapKernel()
+// Returns the name of the kernels the entry points dispatch to on this CPU:
+// "avx512", "avx2" or "scalar".
+const char *bitmapKernel(void);
+
+#endif //GRAPHADT_BITMAP_H
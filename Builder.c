@@ -0,0 +1,277 @@
+//-----------------------------------------------------------------------------
+// Builder.c
+// Implementation file for parallel compact Graph construction from edge arrays
+//-----------------------------------------------------------------------------
+
+#include <string.h>
+#include "Builder.h"
+#include "Memory.h"
+#include "Parallel.h"
+#include "Sort.h"
+
+// structs --------------------------------------------------------------------
+
+// private BuildJob type: state shared by the threads of one build
+typedef struct BuildJob {
+    Vertex n;
+    EdgeIndex m;
+    const Vertex *source;
+    const Vertex *target;
+    int symmetric;
+    int policy;
+
+    // count[t][u] is thread t's histogram of sources, later its write cursor
+    // for u. With shared set, all threads use count[0] atomically, which
+    // saves memory when threads * n would outweigh the edges.
+    EdgeIndex **count;
+    int histograms;
+    int shared;
+
+    EdgeIndex *offset;
+    Vertex *adj;
+
+    // Kept degrees, then offsets, of the filtered adjacency
+    EdgeIndex *kept;
+    Vertex *out;
+
+    EdgeIndex *partial;
+    int phase;
+} BuildJob;
+
+enum { PHASE_HISTOGRAM, PHASE_COMBINE, PHASE_POSITION, PHASE_SCATTER, PHASE_SORT, PHASE_COMPACT };
+
+
+// countArc()
+// Counts one arc out of u in histogram h.
+// Private.
+static void countArc(const BuildJob *J, EdgeIndex *h, Vertex u) {
+    if (J->shared)
+        __atomic_fetch_add(&h[u], 1, __ATOMIC_RELAXED);
+    else
+        h[u]++;
+}
+
+// placeArc()
+// Writes the arc (u, v) at u's next cursor position in h.
+// Private.
+static void placeArc(BuildJob *J, EdgeIndex *h, Vertex u, Vertex v) {
+    EdgeIndex pos = J->shared ? __atomic_fetch_add(&h[u], 1, __ATOMIC_RELAXED) : h[u]++;
+    J->adj[pos] = v;
+}
+
+// sortRange()
+// Sorts u's adjacency range and, under an edge policy, filters it in place
+// and records its kept degree in kept[u]. Returns the number of kept arcs
+// that count towards getSize() for a filtered symmetric graph: those with
+// v >= u, so each edge is counted once.
+// Private.
+static EdgeIndex sortRange(BuildJob *J, Vertex u) {
+    Vertex *a = J->adj + J->offset[u];
+    EdgeIndex len = J->offset[u + 1] - J->offset[u];
+    EdgeIndex edges = 0;
+
+    sortVertices(a, len);
+    if (J->policy == EDGES_MULTI)
+        return 0;
+
+    if (J->policy & EDGES_DEDUP)
+        len = uniqueVertices(a, len);
+    if (J->policy & EDGES_NO_LOOPS) {
+        // Sorted, so u's loops form one run
+        EdgeIndex k = 0;
+        for (EdgeIndex i = 0; i < len; i++)
+            if (a[i] != u)
+                a[k++] = a[i];
+        len = k;
+    }
+    J->kept[u] = len;
+    if (J->symmetric)
+        for (EdgeIndex i = 0; i < len; i++)
+            edges += a[i] >= u;
+    return edges;
+}
+
+// buildWorker()
+// Runs the current phase of J. Histogram and scatter phases split the edges
+// statically so each thread's cursors line up with its own counts; combine and
+// position phases split the vertices statically. Sort and compact phases run
+// in buildRange() instead.
+// Private.
+static void buildWorker(int tid, int threads, void *arg) {
+    BuildJob *J = arg;
+    EdgeIndex *h = NULL;
+    EdgeIndex lo;
+    EdgeIndex hi;
+
+    if (J->phase == PHASE_HISTOGRAM || J->phase == PHASE_SCATTER)
+        h = J->count[J->shared ? 0 : tid];
+
+    switch (J->phase) {
+        case PHASE_HISTOGRAM:
+            threadSlice(J->m, tid, threads, &lo, &hi);
+            for (EdgeIndex i = lo; i < hi; i++) {
+                countArc(J, h, J->source[i]);
+                if (J->symmetric)
+                    countArc(J, h, J->target[i]);
+            }
+            break;
+
+        case PHASE_COMBINE:
+            // Each histogram entry becomes that thread's start within u's
+            // range, and offset[u] u's degree
+            threadSlice((EdgeIndex) J->n + 2, tid, threads, &lo, &hi);
+            for (EdgeIndex u = lo; u < hi; u++) {
+                EdgeIndex degree = 0;
+                for (int t = 0; t < J->histograms; t++) {
+                    EdgeIndex c = J->count[t][u];
+                    J->count[t][u] = degree;
+                    degree += c;
+                }
+                J->offset[u] = degree;
+            }
+            break;
+
+        case PHASE_POSITION:
+            threadSlice((EdgeIndex) J->n + 2, tid, threads, &lo, &hi);
+            for (EdgeIndex u = lo; u < hi; u++)
+                for (int t = 0; t < J->histograms; t++)
+                    J->count[t][u] += J->offset[u];
+            break;
+
+        case PHASE_SCATTER:
+            threadSlice(J->m, tid, threads, &lo, &hi);
+            for (EdgeIndex i = lo; i < hi; i++) {
+                placeArc(J, h, J->source[i], J->target[i]);
+                if (J->symmetric)
+                    placeArc(J, h, J->target[i], J->source[i]);
+            }
+            break;
+
+    }
+}
+
+// buildRange()
+// Runs the sort or compact phase of J over vertices lo..hi-1.
+// Private.
+static void buildRange(EdgeIndex lo, EdgeIndex hi, int tid, void *arg) {
+    BuildJob *J = arg;
+    EdgeIndex edges = 0;
+
+    for (Vertex u = (Vertex) lo; u < hi; u++) {
+        if (J->phase == PHASE_SORT)
+            edges += sortRange(J, u);
+        else
+            memcpy(J->out + J->kept[u], J->adj + J->offset[u],
+                   sizeof(Vertex) * (size_t) (J->kept[u + 1] - J->kept[u]));
+    }
+    J->partial[tid] += edges;
+}
+
+// runPhase()
+// Runs one phase of J on threads threads. Sorting and compacting go through
+// parallelFor(), each vertex weighted by its unfiltered or kept degree, since
+// degrees can be very uneven.
+// Private.
+static void runPhase(BuildJob *J, int phase, int threads) {
+    J->phase = phase;
+    if (phase == PHASE_SORT)
+        parallelFor(1, (EdgeIndex) J->n + 1, J->offset, 0, buildRange, J, threads);
+    else if (phase == PHASE_COMPACT)
+        parallelFor(1, (EdgeIndex) J->n + 1, J->kept, 0, buildRange, J, threads);
+    else
+        parallelRun(threads, buildWorker, J);
+}
+
+
+// newGraphFromEdges() --------------------------------------------------------
+
+// newGraphFromEdges()
+// Counts degrees in per-thread histograms, prefix sums them into offsets,
+// scatters the targets, then sorts (and filters, under an edge policy) every
+// adjacency range in parallel.
+Graph newGraphFromEdges(EdgeList E, int symmetric, int policy, int threads) {
+    if (E == NULL) {
+        printf("Builder Error: newGraphFromEdges() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    if (policy & ~(EDGES_DEDUP | EDGES_NO_LOOPS)) {
+        printf("Builder Error: newGraphFromEdges() called with unknown policy\n");
+        exit(1);
+    }
+    if (threads <= 0)
+        threads = defaultThreads();
+
+    BuildJob J;
+    J.n = edgeOrder(E);
+    J.m = edgeCount(E);
+    J.source = edgeSources(E);
+    J.target = edgeTargets(E);
+    J.symmetric = symmetric;
+    J.policy = policy;
+
+    EdgeIndex arcs = symmetric ? 2 * J.m : J.m;
+    J.shared = threads > 1 && (double) threads * ((double) J.n + 2) > (double) arcs;
+    J.histograms = J.shared ? 1 : threads;
+
+    // Peak is the histograms beside the scattered arcs, or under a policy
+    // possibly the kept offsets and arcs beside them
+    size_t offsets = sizeof(EdgeIndex) * ((size_t) J.n + 2);
+    size_t targets = sizeof(Vertex) * (size_t) (arcs > 0 ? arcs : 1);
+    size_t peak = (size_t) J.histograms * offsets;
+    if (policy != EDGES_MULTI && peak < offsets + targets)
+        peak = offsets + targets;
+    peak += offsets + targets;
+    if (!reserveMemory(peak))
+        return NULL;
+
+    J.count = malloc(sizeof(EdgeIndex *) * (size_t) J.histograms);
+    for (int t = 0; t < J.histograms; t++)
+        J.count[t] = calloc((size_t) J.n + 2, sizeof(EdgeIndex));
+    J.offset = malloc(sizeof(EdgeIndex) * ((size_t) J.n + 2));
+    J.adj = malloc(sizeof(Vertex) * (size_t) (arcs > 0 ? arcs : 1));
+    J.partial = calloc((size_t) threads, sizeof(EdgeIndex));
+    if (J.offset == NULL || J.adj == NULL) {
+        printf("Builder Error: newGraphFromEdges() unable to allocate %" PRIedge " arcs\n", arcs);
+        exit(1);
+    }
+
+    runPhase(&J, PHASE_HISTOGRAM, threads);
+    runPhase(&J, PHASE_COMBINE, threads);
+    prefixSum(J.offset, (EdgeIndex) J.n + 2, threads);
+    runPhase(&J, PHASE_POSITION, threads);
+    runPhase(&J, PHASE_SCATTER, threads);
+
+    for (int t = 0; t < J.histograms; t++)
+        free(J.count[t]);
+    free(J.count);
+
+    EdgeIndex size = J.m;
+    if (policy != EDGES_MULTI) {
+        J.kept = calloc((size_t) J.n + 2, sizeof(EdgeIndex));
+        runPhase(&J, PHASE_SORT, threads);
+        EdgeIndex total = prefixSum(J.kept, (EdgeIndex) J.n + 2, threads);
+
+        J.out = malloc(sizeof(Vertex) * (size_t) (total > 0 ? total : 1));
+        runPhase(&J, PHASE_COMPACT, threads);
+        free(J.adj);
+        free(J.offset);
+        J.adj = J.out;
+        J.offset = J.kept;
+
+        size = total;
+        if (symmetric) {
+            size = 0;
+            for (int t = 0; t < threads; t++)
+                size += J.partial[t];
+        }
+    } else {
+        runPhase(&J, PHASE_SORT, threads);
+    }
+    free(J.partial);
+
+    releaseMemory(peak);
+    Graph G = newGraphCompact(J.n, J.offset, J.adj, size);
+    setEdgePolicy(G, policy);
+    addDroppedEdges(G, J.m - size);
+    return G;
+}
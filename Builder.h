@@ -0,0 +1,26 @@
+//-----------------------------------------------------------------------------
+// Builder.h
+// Header file for parallel compact Graph construction from edge arrays
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_BUILDER_H
+#define GRAPHADT_BUILDER_H
+
+#include"Graph.h"
+#include"EdgeList.h"
+
+// newGraphFromEdges()
+// Returns a Graph over vertices 1..edgeOrder(E) built from the edges of E in
+// compact form, without addArc(). If symmetric is true each edge is added in
+// both directions, as addEdge() would; otherwise as an arc. Adjacency is
+// sorted ascending, so printGraph() output matches the addEdge()/addArc()
+// construction under the same edge policy (see setEdgePolicy()): with
+// EDGES_DEDUP repeated neighbors are dropped, with EDGES_NO_LOOPS self-loops,
+// and getSize() counts the edges (or arcs) kept. The Graph keeps the policy
+// for later insertions, and getDroppedEdges() reports how many of E's edges
+// were refused. threads <= 0 means defaultThreads(). Returns NULL, having
+// allocated nothing, if the arrays it needs at its peak do not fit in the
+// memory budget (see Memory.h).
+Graph newGraphFromEdges(EdgeList E, int symmetric, int policy, int threads);
+
+#endif //GRAPHADT_BUILDER_H
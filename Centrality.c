@@ -0,0 +1,173 @@
+//-----------------------------------------------------------------------------
+// Centrality.c
+// Implementation file for betweenness centrality
+//-----------------------------------------------------------------------------
+
+#include "Centrality.h"
+#include "GraphGen.h"
+#include "Parallel.h"
+
+// structs --------------------------------------------------------------------
+
+// private CentralityJob type: state shared by the threads of one run
+typedef struct CentralityJob {
+    Vertex n;
+    const EdgeIndex *offset;
+    const Vertex *target;
+
+    // Sources to search, claimed one at a time since each is a full BFS
+    const Vertex *source;
+    Vertex sources;
+
+    // partial[t] is thread t's score sum, merged once all have finished
+    double **partial;
+    EdgeIndex next;
+} CentralityJob;
+
+
+// accumulate()
+// Runs one Brandes iteration from s, adding every vertex's dependency on s to
+// score. distance must be all INF and sigma all 0 on entry, and are restored
+// to that for the vertices this search reaches, so the cost of each source is
+// proportional to what it explores. order needs room for n vertices.
+// Rather than storing each vertex's predecessor set, the backward pass finds
+// its successors (neighbors one level further out) again in the adjacency.
+// Private.
+static void accumulate(const CentralityJob *J, Vertex s, Vertex *distance, double *sigma,
+                       double *delta, Vertex *order, double *score) {
+    const EdgeIndex *offset = J->offset;
+    const Vertex *target = J->target;
+    Vertex head = 0;
+    Vertex tail = 0;
+
+    // Forward pass: BFS counting shortest paths
+    distance[s] = 0;
+    sigma[s] = 1;
+    order[tail++] = s;
+    while (head != tail) {
+        Vertex u = order[head++];
+        Vertex prev = NIL;
+        for (EdgeIndex e = offset[u]; e < offset[u + 1]; e++) {
+            Vertex v = target[e];
+            if (v == prev)
+                continue;
+            prev = v;
+            if (distance[v] == INF) {
+                distance[v] = distance[u] + 1;
+                order[tail++] = v;
+            }
+            if (distance[v] == distance[u] + 1)
+                sigma[v] += sigma[u];
+        }
+    }
+
+    // Backward pass: farthest vertices first, so successors are done
+    for (Vertex i = tail - 1; i >= 0; i--) {
+        Vertex u = order[i];
+        Vertex prev = NIL;
+        double d = 0;
+        for (EdgeIndex e = offset[u]; e < offset[u + 1]; e++) {
+            Vertex v = target[e];
+            if (v == prev)
+                continue;
+            prev = v;
+            if (distance[v] == distance[u] + 1)
+                d += sigma[u] / sigma[v] * (1.0 + delta[v]);
+        }
+        delta[u] = d;
+        if (u != s)
+            score[u] += d;
+    }
+
+    for (Vertex i = 0; i < tail; i++) {
+        distance[order[i]] = INF;
+        sigma[order[i]] = 0;
+    }
+}
+
+// centralityWorker()
+// Claims sources until none are left, accumulating into the thread's own
+// score array.
+// Private.
+static void centralityWorker(int tid, int threads, void *arg) {
+    CentralityJob *J = arg;
+    size_t n = (size_t) J->n + 1;
+    Vertex *distance = malloc(sizeof(Vertex) * n);
+    double *sigma = calloc(n, sizeof(double));
+    double *delta = malloc(sizeof(double) * n);
+    Vertex *order = malloc(sizeof(Vertex) * n);
+    double *score = J->partial[tid];
+    EdgeIndex lo;
+    EdgeIndex hi;
+    (void) threads;
+
+    for (size_t u = 0; u < n; u++)
+        distance[u] = INF;
+
+    while (nextChunk(&J->next, J->sources, 1, &lo, &hi))
+        accumulate(J, J->source[lo], distance, sigma, delta, order, score);
+
+    free(distance);
+    free(sigma);
+    free(delta);
+    free(order);
+}
+
+// betweenness()
+// Sets score[u] to the (possibly sampled) betweenness centrality of u.
+void betweenness(Graph G, double *score, Vertex samples, uint64_t seed, int threads) {
+    if (G == NULL) {
+        printf("Centrality Error: betweenness() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (score == NULL) {
+        printf("Centrality Error: betweenness() called on NULL output array\n");
+        exit(1);
+    }
+    if (threads <= 0)
+        threads = defaultThreads();
+
+    CentralityJob J;
+    J.n = getOrder(G);
+    getAdjacency(G, &J.offset, &J.target);
+
+    // Every vertex, or the first samples of a partial Fisher-Yates shuffle
+    Vertex *source = malloc(sizeof(Vertex) * ((size_t) J.n + 1));
+    for (Vertex u = 0; u < J.n; u++)
+        source[u] = u + 1;
+    J.sources = J.n;
+    if (samples > 0 && samples < J.n) {
+        uint64_t state = seed;
+        for (Vertex i = 0; i < samples; i++) {
+            Vertex j = i + (Vertex) (genRandom(&state) % (uint64_t) (J.n - i));
+            Vertex t = source[i];
+            source[i] = source[j];
+            source[j] = t;
+        }
+        J.sources = samples;
+    }
+    J.source = source;
+    J.next = 0;
+
+    if (threads > J.sources)
+        threads = J.sources > 0 ? (int) J.sources : 1;
+    J.partial = malloc(sizeof(double *) * (size_t) threads);
+    for (int t = 0; t < threads; t++)
+        J.partial[t] = calloc((size_t) J.n + 1, sizeof(double));
+
+    parallelRun(threads, centralityWorker, &J);
+
+    double scale = J.sources < J.n ? (double) J.n / (double) J.sources : 1.0;
+    score[0] = 0;
+    for (Vertex u = 1; u <= J.n; u++) {
+        double sum = 0;
+        for (int t = 0; t < threads; t++)
+            sum += J.partial[t][u];
+        score[u] = sum * scale;
+    }
+
+    for (int t = 0; t < threads; t++)
+        free(J.partial[t]);
+    free(J.partial);
+    free(source);
+}
@@ -0,0 +1,28 @@
+//-----------------------------------------------------------------------------
+// Centrality.h
+// Header file for betweenness centrality
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_CENTRALITY_H
+#define GRAPHADT_CENTRALITY_H
+
+#include"Graph.h"
+
+// Betweenness follows Brandes: one BFS per source counts the shortest paths
+// to every vertex, then a pass back through the BFS order accumulates each
+// vertex's dependency on the source. Sources are spread over threads threads,
+// each with private per-vertex state; threads <= 0 means defaultThreads().
+// Arcs are followed as stored, so undirected graphs count every pair in both
+// directions and give twice the usual undirected scores. Repeated arcs and
+// self-loops are ignored.
+
+// betweenness()
+// Sets score[u], for 1 <= u <= getOrder(G), to the betweenness centrality of
+// u: the sum over ordered pairs (s, t) of distinct vertices other than u of
+// the fraction of shortest s-t paths through u. If 0 < samples < getOrder(G),
+// only samples distinct sources drawn pseudo-randomly from seed are searched
+// and the scores are scaled up by getOrder(G) / samples, an unbiased estimate
+// of the exact value; otherwise every vertex is a source.
+void betweenness(Graph G, double *score, Vertex samples, uint64_t seed, int threads);
+
+#endif //GRAPHADT_CENTRALITY_H
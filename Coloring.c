@@ -0,0 +1,451 @@
+//-----------------------------------------------------------------------------
+// Coloring.c
+// Implementation file for vertex coloring and maximal independent sets
+//-----------------------------------------------------------------------------
+
+#include "Coloring.h"
+#include "GraphGen.h"
+#include "Parallel.h"
+
+// structs --------------------------------------------------------------------
+
+// private ColorJob type: state shared by the threads of one parallelColoring()
+// or lubyMIS()
+typedef struct ColorJob {
+    Vertex n;
+    const EdgeIndex *offset;
+    const Vertex *target;
+    EdgeIndex maxDegree;
+    uint64_t seed;
+
+    // parallelColoring(): colors, and the uncolored neighbors of higher
+    // priority each vertex still waits for
+    Vertex *color;
+    EdgeIndex *waiting;
+
+    // lubyMIS(): the set, the vertices that left it, and this round's picks
+    int *inSet;
+    char *removed;
+    char *chosen;
+
+    // Vertices to process this round; the next round's are appended to next
+    // through an atomic cursor, so their order varies but not the result
+    Vertex *frontier;
+    Vertex size;
+    Vertex *next;
+    Vertex nextSize;
+
+    // Per-thread scratch for smallestFree(), allocated on first use, and
+    // per-thread largest color or set size
+    Vertex **mark;
+    Vertex *partial;
+    int phase;
+} ColorJob;
+
+enum { PHASE_WAIT, PHASE_COLOR, PHASE_SELECT, PHASE_RESOLVE };
+
+
+// priority()
+// Returns v's pseudo-random priority under seed.
+// Private.
+static uint64_t priority(uint64_t seed, Vertex v) {
+    uint64_t state = seed ^ ((uint64_t) v * 0xD1B54A32D192ED03ULL);
+    return genRandom(&state);
+}
+
+// outranks()
+// Returns true (1) if u, of priority pu, comes before v under seed: higher
+// priority, ties broken by ID.
+// Private.
+static int outranks(uint64_t seed, Vertex u, uint64_t pu, Vertex v) {
+    uint64_t pv = priority(seed, v);
+    return pu > pv || (pu == pv && u > v);
+}
+
+// smallestFree()
+// Returns the smallest color, 1 or more, that no colored neighbor of u has.
+// mark needs maxDegree + 2 entries, none of them u; entries marked u are left
+// behind, which only u itself would mistake for its own.
+// Private.
+static Vertex smallestFree(const EdgeIndex *offset, const Vertex *target, const Vertex *color,
+                           Vertex u, Vertex *mark) {
+    EdgeIndex limit = offset[u + 1] - offset[u] + 1;
+
+    for (EdgeIndex e = offset[u]; e < offset[u + 1]; e++) {
+        Vertex c = color[target[e]];
+        if (c > 0 && c <= limit && target[e] != u)
+            mark[c] = u;
+    }
+
+    Vertex c = 1;
+    while (mark[c] == u)
+        c++;
+    return c;
+}
+
+// maxDegree()
+// Returns the largest number of arcs out of any vertex.
+// Private.
+static EdgeIndex maxDegree(const EdgeIndex *offset, Vertex n) {
+    EdgeIndex best = 0;
+    for (Vertex u = 1; u <= n; u++)
+        if (offset[u + 1] - offset[u] > best)
+            best = offset[u + 1] - offset[u];
+    return best;
+}
+
+
+// Greedy ---------------------------------------------------------------------
+
+// largestFirst()
+// Fills order with the vertices by non-loop degree, largest first, ties by
+// ID, with a counting sort.
+// Private.
+static void largestFirst(const EdgeIndex *offset, const Vertex *target, Vertex n, EdgeIndex most,
+                         Vertex *order) {
+    EdgeIndex *degree = malloc(sizeof(EdgeIndex) * ((size_t) n + 1));
+    EdgeIndex *start = calloc((size_t) most + 2, sizeof(EdgeIndex));
+
+    for (Vertex u = 1; u <= n; u++) {
+        EdgeIndex d = 0;
+        for (EdgeIndex e = offset[u]; e < offset[u + 1]; e++)
+            d += target[e] != u;
+        degree[u] = d;
+        start[most - d + 1]++;
+    }
+    for (EdgeIndex d = 1; d <= most + 1; d++)
+        start[d] += start[d - 1];
+    for (Vertex u = 1; u <= n; u++)
+        order[start[most - degree[u]]++] = u;
+
+    free(degree);
+    free(start);
+}
+
+// smallestLast()
+// Fills order with the vertices in reverse of the order they are removed by
+// repeatedly taking one of least remaining degree (Matula and Beck), using
+// the bucket arrays of Batagelj and Zaversnik's core decomposition.
+// Private.
+static void smallestLast(const EdgeIndex *offset, const Vertex *target, Vertex n, EdgeIndex most,
+                         Vertex *order) {
+    EdgeIndex *degree = malloc(sizeof(EdgeIndex) * ((size_t) n + 1));
+    EdgeIndex *bin = calloc((size_t) most + 1, sizeof(EdgeIndex));
+    Vertex *vert = malloc(sizeof(Vertex) * ((size_t) n + 1));
+    EdgeIndex *pos = malloc(sizeof(EdgeIndex) * ((size_t) n + 1));
+
+    for (Vertex u = 1; u <= n; u++) {
+        EdgeIndex d = 0;
+        for (EdgeIndex e = offset[u]; e < offset[u + 1]; e++)
+            d += target[e] != u;
+        degree[u] = d;
+        bin[d]++;
+    }
+
+    // bin[d] becomes the position of the first vertex of degree d
+    EdgeIndex running = 0;
+    for (EdgeIndex d = 0; d <= most; d++) {
+        EdgeIndex count = bin[d];
+        bin[d] = running;
+        running += count;
+    }
+    for (Vertex u = 1; u <= n; u++) {
+        pos[u] = bin[degree[u]]++;
+        vert[pos[u]] = u;
+    }
+    for (EdgeIndex d = most; d > 0; d--)
+        bin[d] = bin[d - 1];
+    bin[0] = 0;
+
+    // vert[i] is removed i-th; each removal moves its neighbors of larger
+    // remaining degree down one bucket, to the front of their own
+    for (Vertex i = 0; i < n; i++) {
+        Vertex v = vert[i];
+        for (EdgeIndex e = offset[v]; e < offset[v + 1]; e++) {
+            Vertex w = target[e];
+            if (w == v || degree[w] <= degree[v])
+                continue;
+            EdgeIndex first = bin[degree[w]];
+            Vertex x = vert[first];
+            if (x != w) {
+                vert[pos[w]] = x;
+                pos[x] = pos[w];
+                vert[first] = w;
+                pos[w] = first;
+            }
+            bin[degree[w]]++;
+            degree[w]--;
+        }
+    }
+
+    for (Vertex i = 0; i < n; i++)
+        order[i] = vert[n - 1 - i];
+
+    free(degree);
+    free(bin);
+    free(vert);
+    free(pos);
+}
+
+// greedyColoring()
+// Colors the vertices in the given order with the smallest free color.
+Vertex greedyColoring(Graph G, int order, Vertex *color) {
+    if (G == NULL) {
+        printf("Coloring Error: greedyColoring() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (color == NULL) {
+        printf("Coloring Error: greedyColoring() called on NULL output array\n");
+        exit(1);
+    }
+    if (order != COLOR_NATURAL && order != COLOR_LARGEST_FIRST && order != COLOR_SMALLEST_LAST) {
+        printf("Coloring Error: greedyColoring() called with unknown order\n");
+        exit(1);
+    }
+
+    Vertex n = getOrder(G);
+    const EdgeIndex *offset;
+    const Vertex *target;
+    getAdjacency(G, &offset, &target);
+
+    EdgeIndex most = maxDegree(offset, n);
+    Vertex *sequence = malloc(sizeof(Vertex) * ((size_t) n + 1));
+    Vertex *mark = calloc((size_t) most + 2, sizeof(Vertex));
+
+    if (order == COLOR_LARGEST_FIRST)
+        largestFirst(offset, target, n, most, sequence);
+    else if (order == COLOR_SMALLEST_LAST)
+        smallestLast(offset, target, n, most, sequence);
+    else
+        for (Vertex i = 0; i < n; i++)
+            sequence[i] = i + 1;
+
+    for (Vertex u = 1; u <= n; u++)
+        color[u] = 0;
+
+    Vertex colors = 0;
+    for (Vertex i = 0; i < n; i++) {
+        Vertex u = sequence[i];
+        color[u] = smallestFree(offset, target, color, u, mark);
+        if (color[u] > colors)
+            colors = color[u];
+    }
+
+    free(sequence);
+    free(mark);
+    return colors;
+}
+
+
+// Parallel -------------------------------------------------------------------
+
+// pushNext()
+// Appends u to the next round's frontier.
+// Private.
+static void pushNext(ColorJob *J, Vertex u) {
+    J->next[__atomic_fetch_add(&J->nextSize, 1, __ATOMIC_RELAXED)] = u;
+}
+
+// colorRange()
+// Runs the current phase of J over vertices lo..hi-1 (PHASE_WAIT) or
+// frontier entries lo..hi-1 (the others).
+// Private.
+static void colorRange(EdgeIndex lo, EdgeIndex hi, int tid, void *arg) {
+    ColorJob *J = arg;
+    const EdgeIndex *offset = J->offset;
+    const Vertex *target = J->target;
+    Vertex largest = 0;
+
+    if (J->phase == PHASE_COLOR && J->mark[tid] == NULL)
+        J->mark[tid] = calloc((size_t) J->maxDegree + 2, sizeof(Vertex));
+
+    for (EdgeIndex i = lo; i < hi; i++) {
+        Vertex u = J->phase == PHASE_WAIT ? (Vertex) i : J->frontier[i];
+        uint64_t pu = J->phase == PHASE_RESOLVE ? 0 : priority(J->seed, u);
+
+        switch (J->phase) {
+            case PHASE_WAIT: {
+                EdgeIndex waiting = 0;
+                for (EdgeIndex e = offset[u]; e < offset[u + 1]; e++)
+                    if (target[e] != u && !outranks(J->seed, u, pu, target[e]))
+                        waiting++;
+                J->color[u] = 0;
+                J->waiting[u] = waiting;
+                if (waiting == 0)
+                    pushNext(J, u);
+                break;
+            }
+            case PHASE_COLOR: {
+                // Neighbors of higher priority were colored in earlier
+                // rounds; those of lower priority are still waiting for u
+                Vertex c = smallestFree(offset, target, J->color, u, J->mark[tid]);
+                J->color[u] = c;
+                if (c > largest)
+                    largest = c;
+                for (EdgeIndex e = offset[u]; e < offset[u + 1]; e++) {
+                    Vertex w = target[e];
+                    if (w != u && outranks(J->seed, u, pu, w)
+                        && __atomic_sub_fetch(&J->waiting[w], 1, __ATOMIC_RELAXED) == 0)
+                        pushNext(J, w);
+                }
+                break;
+            }
+            case PHASE_SELECT: {
+                // Picked if above every undecided neighbor, which are exactly
+                // the other frontier vertices; decisions change in RESOLVE
+                int pick = 1;
+                for (EdgeIndex e = offset[u]; e < offset[u + 1] && pick; e++) {
+                    Vertex w = target[e];
+                    if (w != u && !J->inSet[w] && !J->removed[w] && !outranks(J->seed, u, pu, w))
+                        pick = 0;
+                }
+                J->chosen[u] = (char) pick;
+                break;
+            }
+            case PHASE_RESOLVE: {
+                if (J->chosen[u]) {
+                    J->inSet[u] = 1;
+                    largest++;
+                    break;
+                }
+                int out = 0;
+                for (EdgeIndex e = offset[u]; e < offset[u + 1] && !out; e++)
+                    out = J->chosen[target[e]];
+                if (out)
+                    J->removed[u] = 1;
+                else
+                    pushNext(J, u);
+                break;
+            }
+        }
+    }
+
+    if (J->phase == PHASE_COLOR && largest > J->partial[tid])
+        J->partial[tid] = largest;
+    if (J->phase == PHASE_RESOLVE)
+        J->partial[tid] += largest;
+}
+
+// runRound()
+// Runs one phase of J on threads threads, over all vertices weighted by
+// degree for PHASE_WAIT, otherwise over the frontier, and makes the vertices
+// it pushed the next frontier.
+// Private.
+static void runRound(ColorJob *J, int phase, int threads) {
+    J->phase = phase;
+    J->nextSize = 0;
+    if (phase == PHASE_WAIT)
+        parallelFor(1, (EdgeIndex) J->n + 1, J->offset, 0, colorRange, J, threads);
+    else
+        parallelFor(0, J->size, NULL, 0, colorRange, J, threads);
+
+    if (phase != PHASE_SELECT) {
+        Vertex *t = J->frontier;
+        J->frontier = J->next;
+        J->next = t;
+        J->size = J->nextSize;
+    }
+}
+
+// initJob()
+// Fills the fields of J both parallel algorithms use.
+// Private.
+static void initJob(ColorJob *J, Graph G, uint64_t seed, int threads) {
+    J->n = getOrder(G);
+    getAdjacency(G, &J->offset, &J->target);
+    J->maxDegree = 0;
+    J->seed = seed;
+    J->frontier = malloc(sizeof(Vertex) * ((size_t) J->n + 1));
+    J->next = malloc(sizeof(Vertex) * ((size_t) J->n + 1));
+    J->size = 0;
+    J->mark = calloc((size_t) threads, sizeof(Vertex *));
+    J->partial = calloc((size_t) threads, sizeof(Vertex));
+}
+
+// freeJob()
+// Frees what initJob() allocated.
+// Private.
+static void freeJob(ColorJob *J, int threads) {
+    for (int t = 0; t < threads; t++)
+        free(J->mark[t]);
+    free(J->mark);
+    free(J->partial);
+    free(J->frontier);
+    free(J->next);
+}
+
+// parallelColoring()
+// Counts each vertex's neighbors of higher priority, then colors in rounds
+// the vertices left waiting for none, each releasing its lower neighbors.
+Vertex parallelColoring(Graph G, Vertex *color, uint64_t seed, int threads) {
+    if (G == NULL) {
+        printf("Coloring Error: parallelColoring() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (color == NULL) {
+        printf("Coloring Error: parallelColoring() called on NULL output array\n");
+        exit(1);
+    }
+    if (threads <= 0)
+        threads = defaultThreads();
+
+    ColorJob J;
+    initJob(&J, G, seed, threads);
+    J.maxDegree = maxDegree(J.offset, J.n);
+    J.color = color;
+    J.waiting = malloc(sizeof(EdgeIndex) * ((size_t) J.n + 1));
+
+    runRound(&J, PHASE_WAIT, threads);
+    while (J.size > 0)
+        runRound(&J, PHASE_COLOR, threads);
+
+    Vertex colors = 0;
+    for (int t = 0; t < threads; t++)
+        if (J.partial[t] > colors)
+            colors = J.partial[t];
+
+    free(J.waiting);
+    freeJob(&J, threads);
+    return colors;
+}
+
+// lubyMIS()
+// Alternates picking local priority maxima among the undecided vertices and
+// removing their neighbors, with fresh priorities every round.
+Vertex lubyMIS(Graph G, int *inSet, uint64_t seed, int threads) {
+    if (G == NULL) {
+        printf("Coloring Error: lubyMIS() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (inSet == NULL) {
+        printf("Coloring Error: lubyMIS() called on NULL output array\n");
+        exit(1);
+    }
+    if (threads <= 0)
+        threads = defaultThreads();
+
+    ColorJob J;
+    initJob(&J, G, seed, threads);
+    J.inSet = inSet;
+    J.removed = calloc((size_t) J.n + 1, sizeof(char));
+    J.chosen = calloc((size_t) J.n + 1, sizeof(char));
+
+    for (Vertex u = 1; u <= J.n; u++) {
+        inSet[u] = 0;
+        J.frontier[J.size++] = u;
+    }
+    for (uint64_t round = 0; J.size > 0; round++) {
+        J.seed = seed + round * 0x9E3779B97F4A7C15ULL;
+        runRound(&J, PHASE_SELECT, threads);
+        runRound(&J, PHASE_RESOLVE, threads);
+    }
+
+    Vertex size = 0;
+    for (int t = 0; t < threads; t++)
+        size += J.partial[t];
+
+    free(J.removed);
+    free(J.chosen);
+    freeJob(&J, threads);
+    return size;
+}
@@ -0,0 +1,46 @@
+//-----------------------------------------------------------------------------
+// Coloring.h
+// Header file for vertex coloring and maximal independent sets
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_COLORING_H
+#define GRAPHADT_COLORING_H
+
+#include"Graph.h"
+
+// Vertex orders for greedyColoring()
+#define COLOR_NATURAL 0         // by vertex ID
+#define COLOR_LARGEST_FIRST 1   // by degree, largest first, ties by ID
+#define COLOR_SMALLEST_LAST 2   // repeatedly remove a vertex of least degree,
+                                // then color in reverse removal order
+
+// These functions treat G as undirected, i.e. built with addEdge(), and
+// ignore self-loops. Results go into arrays of getOrder(G) + 1 entries,
+// indexed by vertex; entry 0 is left alone. Colors are 1..k, and a coloring
+// never gives two adjacent vertices the same color. threads <= 0 means
+// defaultThreads().
+
+// greedyColoring()
+// Colors the vertices one at a time in the given order, each with the
+// smallest color none of its colored neighbors has, and returns the number of
+// colors used. Smallest-last uses at most one more color than the graph's
+// degeneracy.
+Vertex greedyColoring(Graph G, int order, Vertex *color);
+
+// parallelColoring()
+// Jones-Plassmann coloring: every vertex gets a pseudo-random priority from
+// seed, and is colored, in parallel rounds, once all neighbors of higher
+// priority are, with the smallest color none of them has. Returns the number
+// of colors used. The result is greedyColoring() in priority order, so it
+// depends on seed but not on threads.
+Vertex parallelColoring(Graph G, Vertex *color, uint64_t seed, int threads);
+
+// lubyMIS()
+// Luby's maximal independent set: in each round every undecided vertex draws
+// a pseudo-random priority from seed and the round, those above all their
+// undecided neighbors join the set, and their neighbors leave. Sets inSet[u]
+// to 1 for the vertices in the set, 0 for the others, and returns its size.
+// The result depends on seed but not on threads.
+Vertex lubyMIS(Graph G, int *inSet, uint64_t seed, int threads);
+
+#endif //GRAPHADT_COLORING_H
@@ -0,0 +1,838 @@
+//-----------------------------------------------------------------------------
+// DiffTest.c
+// Randomized differential test of the Graph ADT's storage and BFS backends
+//-----------------------------------------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include "GraphGen.h"
+#include "GraphIO.h"
+#include "Builder.h"
+#include "ExtGraph.h"
+#include "HybridBFS.h"
+#include "Intersect.h"
+#include "Loader.h"
+#include "Partition.h"
+#include "Server.h"
+#include "SharedGraph.h"
+#include "Snapshot.h"
+
+// Failures printed in full; later ones are only counted
+#define MAX_REPORTS 20
+
+// BFS sources tried on each Graph of a trial
+#define TRIAL_SOURCES 3
+
+// Random sorted array pairs intersected per trial
+#define TRIAL_INTERSECTIONS 64
+
+// Queries per queryBatch() call and per served stream
+#define TRIAL_BATCH 4
+#define TRIAL_REQUESTS 16
+
+// Failure reporting ----------------------------------------------------------
+
+static int trial;
+static uint64_t trialSeed;
+static const char *backend = "";
+static long checks;
+static long failures;
+
+// fail()
+// Counts a failed check, printing it with the trial and backend that hit it.
+static void fail(const char *format, ...) {
+    va_list args;
+
+    if (++failures > MAX_REPORTS)
+        return;
+    printf("FAIL trial %d (seed %llu) %s: ", trial, (unsigned long long) trialSeed, backend);
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    printf("\n");
+}
+
+
+// Reference ------------------------------------------------------------------
+// The edges as a sorted compact adjacency built straight from the EdgeList,
+// searched by a textbook BFS. Self-loops and repeated edges never change
+// distances, so the reference ignores edge policies.
+
+typedef struct Reference {
+    Vertex n;
+    EdgeIndex *offset;   // n + 2 entries
+    Vertex *target;
+    Vertex *dist;        // from the last refBFS()
+    Vertex *queue;
+    Vertex source;
+} Reference;
+
+// compareVertex()
+// qsort() comparator for Vertex arrays.
+static int compareVertex(const void *a, const void *b) {
+    Vertex x = *(const Vertex *) a;
+    Vertex y = *(const Vertex *) b;
+    return (x > y) - (x < y);
+}
+
+// newReference()
+// Returns the reference adjacency of E, with each edge both ways unless
+// directed.
+static Reference newReference(EdgeList E, int directed) {
+    Reference R;
+    Vertex n = edgeOrder(E);
+    EdgeIndex m = edgeCount(E);
+    Vertex *source = edgeSources(E);
+    Vertex *target = edgeTargets(E);
+
+    R.n = n;
+    R.offset = calloc((size_t) n + 2, sizeof(EdgeIndex));
+    R.target = malloc(sizeof(Vertex) * (size_t) (2 * m + 1));
+    R.dist = malloc(sizeof(Vertex) * ((size_t) n + 1));
+    R.queue = malloc(sizeof(Vertex) * ((size_t) n + 1));
+    R.source = NIL;
+
+    for (EdgeIndex i = 0; i < m; i++) {
+        R.offset[source[i] + 1]++;
+        if (!directed)
+            R.offset[target[i] + 1]++;
+    }
+    for (Vertex u = 1; u <= n; u++)
+        R.offset[u + 1] += R.offset[u];
+
+    EdgeIndex *next = malloc(sizeof(EdgeIndex) * ((size_t) n + 2));
+    memcpy(next, R.offset, sizeof(EdgeIndex) * ((size_t) n + 2));
+    for (EdgeIndex i = 0; i < m; i++) {
+        R.target[next[source[i]]++] = target[i];
+        if (!directed)
+            R.target[next[target[i]]++] = source[i];
+    }
+    free(next);
+
+    for (Vertex u = 1; u <= n; u++)
+        qsort(R.target + R.offset[u], (size_t) (R.offset[u + 1] - R.offset[u]), sizeof(Vertex), compareVertex);
+    return R;
+}
+
+// freeReference()
+// Frees the arrays of R.
+static void freeReference(Reference *R) {
+    free(R->offset);
+    free(R->target);
+    free(R->dist);
+    free(R->queue);
+}
+
+// hasArc()
+// Returns true (1) if the reference has an arc from u to v.
+static int hasArc(Reference *R, Vertex u, Vertex v) {
+    EdgeIndex lo = R->offset[u];
+    EdgeIndex hi = R->offset[u + 1];
+    while (lo < hi) {
+        EdgeIndex mid = lo + (hi - lo) / 2;
+        if (R->target[mid] < v)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < R->offset[u + 1] && R->target[lo] == v;
+}
+
+// refBFS()
+// Sets R->dist to the distances from s.
+static void refBFS(Reference *R, Vertex s) {
+    Vertex head = 0;
+    Vertex tail = 0;
+
+    for (Vertex u = 1; u <= R->n; u++)
+        R->dist[u] = INF;
+    R->source = s;
+    R->dist[s] = 0;
+    R->queue[tail++] = s;
+    while (head < tail) {
+        Vertex u = R->queue[head++];
+        for (EdgeIndex i = R->offset[u]; i < R->offset[u + 1]; i++) {
+            Vertex v = R->target[i];
+            if (R->dist[v] == INF) {
+                R->dist[v] = R->dist[u] + 1;
+                R->queue[tail++] = v;
+            }
+        }
+    }
+}
+
+
+// Checks ---------------------------------------------------------------------
+// Each compares one result against the last refBFS(). Distances must match
+// exactly; parents and paths need only be valid, since a vertex may have
+// several parents one level up.
+
+// checkDist()
+// Checks the distance d reported for v.
+static void checkDist(Reference *R, Vertex v, Vertex d) {
+    checks++;
+    if (d != R->dist[v])
+        fail("distance from %" PRIvertex " to %" PRIvertex " should be %" PRIvertex ", got %" PRIvertex,
+             R->source, v, R->dist[v], d);
+}
+
+// checkDistances()
+// Checks distance[1..n], reporting only the first mismatch.
+static void checkDistances(Reference *R, const Vertex *distance) {
+    for (Vertex v = 1; v <= R->n; v++) {
+        if (distance[v] != R->dist[v]) {
+            checkDist(R, v, distance[v]);
+            return;
+        }
+    }
+    checks++;
+}
+
+// checkParent()
+// Checks that p is NIL for the source and unreachable vertices, and otherwise
+// an in-neighbor of v one step closer to the source.
+static void checkParent(Reference *R, Vertex v, Vertex p) {
+    checks++;
+    if (v == R->source || R->dist[v] == INF) {
+        if (p != NIL)
+            fail("parent of %" PRIvertex " should be NIL, got %" PRIvertex, v, p);
+    } else if (p < 1 || p > R->n || !hasArc(R, p, v) || R->dist[p] != R->dist[v] - 1) {
+        fail("parent %" PRIvertex " of %" PRIvertex " is not an in-neighbor at distance %" PRIvertex,
+             p, v, R->dist[v] - 1);
+    }
+}
+
+// checkParents()
+// Checks parent[1..n], reporting only the first invalid one.
+static void checkParents(Reference *R, const Vertex *parent) {
+    long before = failures;
+    for (Vertex v = 1; v <= R->n && failures == before; v++)
+        checkParent(R, v, parent[v]);
+}
+
+// checkPath()
+// Checks that L holds a shortest path from the source to v, or just NIL if v
+// is unreachable, then clears L.
+static void checkPath(Reference *R, List L, Vertex v) {
+    EdgeIndex len = length(L);
+    Vertex *path = malloc(sizeof(Vertex) * (size_t) (len + 1));
+    int valid;
+
+    toArray(L, path);
+    if (R->dist[v] == INF) {
+        valid = len == 1 && path[0] == NIL;
+    } else {
+        valid = len == R->dist[v] + 1 && path[0] == R->source && path[len - 1] == v;
+        for (EdgeIndex i = 1; valid && i < len; i++)
+            valid = path[i] >= 1 && path[i] <= R->n && hasArc(R, path[i - 1], path[i]);
+    }
+    checks++;
+    if (!valid)
+        fail("path from %" PRIvertex " to %" PRIvertex " of length %" PRIedge " is not a shortest path",
+             R->source, v, len);
+    clear(L);
+    free(path);
+}
+
+// checkAdjacency()
+// Checks that G stores exactly the adjacency of want, which was built from the
+// same edges under the same policy.
+static void checkAdjacency(Graph G, Graph want) {
+    const EdgeIndex *offset;
+    const Vertex *target;
+    const EdgeIndex *wantOffset;
+    const Vertex *wantTarget;
+    Vertex n = getOrder(want);
+
+    checks++;
+    if (getOrder(G) != n || getSize(G) != getSize(want)) {
+        fail("order %" PRIvertex " and size %" PRIedge " should be %" PRIvertex " and %" PRIedge,
+             getOrder(G), getSize(G), n, getSize(want));
+        return;
+    }
+    getAdjacency(G, &offset, &target);
+    getAdjacency(want, &wantOffset, &wantTarget);
+    if (memcmp(offset, wantOffset, sizeof(EdgeIndex) * ((size_t) n + 2)) != 0 ||
+        memcmp(target, wantTarget, sizeof(Vertex) * (size_t) wantOffset[n + 1]) != 0)
+        fail("adjacency differs from the list-built Graph");
+}
+
+// checkPolicy()
+// Checks that G kept the edge policy and dropped edge count of want.
+static void checkPolicy(Graph G, Graph want) {
+    checks++;
+    if (getEdgePolicy(G) != getEdgePolicy(want) || getDroppedEdges(G) != getDroppedEdges(want))
+        fail("policy %d with %" PRIedge " dropped should be %d with %" PRIedge,
+             getEdgePolicy(G), getDroppedEdges(G), getEdgePolicy(want), getDroppedEdges(want));
+}
+
+// checkGraph()
+// Runs BFS() on G from each source and checks every distance, parent and
+// path.
+static void checkGraph(const char *name, Graph G, Reference *R, const Vertex *sources, List L) {
+    backend = name;
+    for (int i = 0; i < TRIAL_SOURCES; i++) {
+        long before = failures;
+        refBFS(R, sources[i]);
+        BFS(G, sources[i]);
+        checks++;
+        if (getSource(G) != sources[i])
+            fail("source should be %" PRIvertex ", got %" PRIvertex, sources[i], getSource(G));
+        for (Vertex v = 1; v <= R->n && failures == before; v++) {
+            checkDist(R, v, getDist(G, v));
+            checkParent(R, v, getParent(G, v));
+            getPath(L, G, v);
+            checkPath(R, L, v);
+        }
+    }
+}
+
+
+// Backends -------------------------------------------------------------------
+
+// checkTry()
+// Builds the Graph through the status-returning variants and checks their
+// results and the statuses of out-of-range and premature calls.
+static void checkTry(EdgeList E, int directed, int policy, Reference *R, const Vertex *sources, List L) {
+    Vertex n = edgeOrder(E);
+    Vertex *source = edgeSources(E);
+    Vertex *target = edgeTargets(E);
+    Graph G;
+    Vertex d;
+    Vertex p;
+
+    backend = "try";
+    checks++;
+    if (tryNewGraph(n, &G) != GRAPH_OK) {
+        fail("tryNewGraph() failed");
+        return;
+    }
+    setEdgePolicy(G, policy);
+    for (EdgeIndex i = 0; i < edgeCount(E); i++) {
+        GraphStatus status = directed ? tryAddArc(G, source[i], target[i]) : tryAddEdge(G, source[i], target[i]);
+        if (status != GRAPH_OK)
+            fail("adding edge %" PRIedge " gave %s", i, graphStatusName(status));
+    }
+
+    checks += 4;
+    if (tryGetPath(L, G, 1) != GRAPH_BAD_STATE)
+        fail("tryGetPath() before tryBFS() should be %s", graphStatusName(GRAPH_BAD_STATE));
+    if (tryAddEdge(G, 0, 1) != GRAPH_OUT_OF_RANGE || tryAddArc(G, 1, n + 1) != GRAPH_OUT_OF_RANGE)
+        fail("adding an edge outside the Graph should be %s", graphStatusName(GRAPH_OUT_OF_RANGE));
+    if (tryBFS(G, n + 1) != GRAPH_OUT_OF_RANGE)
+        fail("tryBFS() from %" PRIvertex " should be %s", n + 1, graphStatusName(GRAPH_OUT_OF_RANGE));
+    if (tryBFS(NULL, 1) != GRAPH_NULL_ARGUMENT)
+        fail("tryBFS() on NULL should be %s", graphStatusName(GRAPH_NULL_ARGUMENT));
+    clear(L);
+
+    for (int i = 0; i < TRIAL_SOURCES; i++) {
+        long before = failures;
+        refBFS(R, sources[i]);
+        checks++;
+        if (tryBFS(G, sources[i]) != GRAPH_OK)
+            fail("tryBFS() from %" PRIvertex " failed", sources[i]);
+        for (Vertex v = 1; v <= n && failures == before; v++) {
+            checks++;
+            if (tryGetDist(G, v, &d) != GRAPH_OK || tryGetParent(G, v, &p) != GRAPH_OK ||
+                tryGetPath(L, G, v) != GRAPH_OK) {
+                fail("getters on %" PRIvertex " failed", v);
+                clear(L);
+                continue;
+            }
+            checkDist(R, v, d);
+            checkParent(R, v, p);
+            checkPath(R, L, v);
+        }
+    }
+    freeGraph(&G);
+}
+
+// checkQueries()
+// Checks queryBFS(), queryKHop() and queryBatch() on G.
+static void checkQueries(Graph G, Reference *R, const Vertex *sources, uint64_t *state, List L) {
+    Vertex n = getOrder(G);
+    Vertex *out = malloc(sizeof(Vertex) * ((size_t) n + 1));
+    Query Q = newQuery(G);
+
+    backend = "queryBFS";
+    for (int i = 0; i < TRIAL_SOURCES; i++) {
+        long before = failures;
+        refBFS(R, sources[i]);
+        queryBFS(Q, sources[i]);
+        for (Vertex v = 1; v <= n && failures == before; v++) {
+            checkDist(R, v, getQueryDist(Q, v));
+            checkParent(R, v, getQueryParent(Q, v));
+            getQueryPath(L, Q, v);
+            checkPath(R, L, v);
+        }
+    }
+
+    // The last source searches without a depth bound
+    backend = "queryKHop";
+    Vertex *level = malloc(sizeof(Vertex) * ((size_t) n + 2));
+    for (int i = 0; i < TRIAL_SOURCES; i++) {
+        Vertex k = i == TRIAL_SOURCES - 1 ? VERTEX_MAX : (Vertex) (genRandom(state) % 5);
+        Vertex within = 0;
+        Vertex depth = 0;
+        long before = failures;
+
+        refBFS(R, sources[i]);
+        Vertex count = queryKHop(Q, sources[i], k, out, n, level);
+        for (Vertex v = 1; v <= n; v++) {
+            if (R->dist[v] != INF && R->dist[v] <= k) {
+                within++;
+                depth = R->dist[v] > depth ? R->dist[v] : depth;
+            }
+        }
+        checks++;
+        if (count != within || level[0] != 0 || level[depth + 1] != count) {
+            fail("%" PRIvertex "-hop count from %" PRIvertex " should be %" PRIvertex ", got %" PRIvertex,
+                 k, sources[i], within, count);
+            continue;
+        }
+        for (Vertex j = 0; j < count && failures == before; j++) {
+            Vertex d = R->dist[out[j]];
+            checks++;
+            if (d == INF || d > k || j < level[d] || j >= level[d + 1])
+                fail("%" PRIvertex "-hop entry %" PRIvertex " is %" PRIvertex " at distance %" PRIvertex,
+                     k, j, out[j], d);
+        }
+        for (Vertex v = 1; v <= n && failures == before; v++) {
+            Vertex want = R->dist[v] != INF && R->dist[v] <= k ? R->dist[v] : INF;
+            checks++;
+            if (getQueryDist(Q, v) != want)
+                fail("%" PRIvertex "-hop distance to %" PRIvertex " should be %" PRIvertex ", got %" PRIvertex,
+                     k, v, want, getQueryDist(Q, v));
+            else if (want != INF)
+                checkParent(R, v, getQueryParent(Q, v));
+        }
+    }
+    free(level);
+    freeQuery(&Q);
+
+    // Searches to a destination only promise that destination's answer
+    backend = "queryBatch";
+    Query batch[TRIAL_BATCH];
+    Vertex source[TRIAL_BATCH];
+    Vertex dest[TRIAL_BATCH];
+    for (int i = 0; i < TRIAL_BATCH; i++) {
+        batch[i] = newQuery(G);
+        source[i] = genRandomVertex(state, n);
+        dest[i] = genRandom(state) % 4 == 0 ? NIL : genRandomVertex(state, n);
+    }
+    queryBatch(batch, source, dest, TRIAL_BATCH);
+    for (int i = 0; i < TRIAL_BATCH; i++) {
+        refBFS(R, source[i]);
+        if (dest[i] == NIL) {
+            for (Vertex v = 1; v <= n; v++)
+                out[v] = getQueryDist(batch[i], v);
+            checkDistances(R, out);
+        } else {
+            checkDist(R, dest[i], getQueryDist(batch[i], dest[i]));
+            getQueryPath(L, batch[i], dest[i]);
+            checkPath(R, L, dest[i]);
+        }
+        freeQuery(&batch[i]);
+    }
+    free(out);
+}
+
+// checkArrays()
+// Checks hybridBFS() and partitionedBFS() on G.
+static void checkArrays(Graph G, Reference *R, const Vertex *sources, int parts) {
+    Vertex n = getOrder(G);
+    Vertex *distance = malloc(sizeof(Vertex) * ((size_t) n + 1));
+    Vertex *parent = malloc(sizeof(Vertex) * ((size_t) n + 1));
+
+    backend = "hybridBFS";
+    for (int i = 0; i < TRIAL_SOURCES; i++) {
+        refBFS(R, sources[i]);
+        hybridBFS(G, sources[i], distance, parent);
+        checkDistances(R, distance);
+        checkParents(R, parent);
+    }
+
+    backend = "partitionedBFS";
+    for (int strategy = PARTITION_BLOCK; strategy <= PARTITION_EDGES; strategy++) {
+        Partition P = newPartition(G, parts, strategy);
+        refBFS(R, sources[strategy]);
+        partitionedBFS(G, P, sources[strategy], distance);
+        checkDistances(R, distance);
+        freePartition(&P);
+    }
+    free(distance);
+    free(parent);
+}
+
+// checkSnapshot()
+// Saves G right after a BFS(), both plain and compressed, and checks that
+// the loaded Graph restores that search and matches want.
+static void checkSnapshot(Graph G, Graph want, Reference *R, const Vertex *sources, List L) {
+    char path[64];
+
+    snprintf(path, sizeof(path), "DiffTest.%ld.snap", (long) getpid());
+    for (int flags = 0; flags <= SNAPSHOT_COMPRESS; flags++) {
+        const char *name = flags ? "snapshot compressed" : "snapshot";
+        backend = name;
+        BFS(G, sources[0]);
+        saveSnapshot(G, path, flags);
+        Graph N = loadSnapshot(path);
+        remove(path);
+        checks++;
+        if (N == NULL) {
+            fail("loadSnapshot() returned NULL");
+            continue;
+        }
+
+        refBFS(R, sources[0]);
+        checks++;
+        if (getSource(N) != sources[0])
+            fail("restored source should be %" PRIvertex ", got %" PRIvertex, sources[0], getSource(N));
+        for (Vertex v = 1; v <= R->n; v++)
+            checkDist(R, v, getDist(N, v));
+        checkAdjacency(N, want);
+        checkPolicy(N, G);
+        checkGraph(name, N, R, sources, L);
+        freeGraph(&N);
+    }
+}
+
+// checkShared()
+// Publishes G to shared memory and checks a Graph attached to it. Skipped
+// where POSIX shared memory is unavailable.
+static void checkShared(Graph G, Graph want, Reference *R, const Vertex *sources, List L) {
+    char name[64];
+
+    backend = "attachGraph";
+    snprintf(name, sizeof(name), "/DiffTest.%ld", (long) getpid());
+    if (!publishGraph(G, name))
+        return;
+    Graph S = attachGraph(name);
+    unpublishGraph(name);
+    if (S == NULL)
+        return;
+    checkAdjacency(S, want);
+    checkPolicy(S, G);
+    checkGraph("attachGraph", S, R, sources, L);
+    freeGraph(&S);
+}
+
+// checkExternal()
+// Converts the input file in to an edge file, through a small buffer so the
+// arcs are sorted in several runs, and checks extBFS() on it.
+static void checkExternal(FILE *in, Reference *R, const Vertex *sources, List L) {
+    char path[64];
+
+    backend = "extBFS";
+    snprintf(path, sizeof(path), "DiffTest.%ld.gadj", (long) getpid());
+    rewind(in);
+    writeExtGraph(in, path, 1 << 10);
+    ExtGraph X = openExtGraph(path, 1 << 10);
+    for (int i = 0; i < TRIAL_SOURCES; i++) {
+        long before = failures;
+        refBFS(R, sources[i]);
+        extBFS(X, sources[i]);
+        for (Vertex v = 1; v <= R->n && failures == before; v++) {
+            checkDist(R, v, getExtDist(X, v));
+            checkParent(R, v, getExtParent(X, v));
+            getExtPath(L, X, v);
+            checkPath(R, L, v);
+        }
+    }
+    freeExtGraph(&X);
+    remove(path);
+}
+
+// checkServer()
+// Sends random requests, one out of range, through a Server on G and checks
+// each response line.
+static void checkServer(Graph G, Reference *R, uint64_t *state, int threads, List L) {
+    Vertex n = getOrder(G);
+    Vertex source[TRIAL_REQUESTS];
+    Vertex dest[TRIAL_REQUESTS];
+    FILE *request = tmpfile();
+    FILE *response = tmpfile();
+
+    backend = "Server";
+    for (int i = 0; i < TRIAL_REQUESTS; i++) {
+        // Few distinct sources, so requests share searches
+        source[i] = genRandomVertex(state, n < 3 ? n : 3);
+        dest[i] = i == TRIAL_REQUESTS / 2 ? n + 1 : genRandomVertex(state, n);
+        fprintf(request, "%" PRIvertex " %" PRIvertex "\n", source[i], dest[i]);
+    }
+    fflush(request);
+    lseek(fileno(request), 0, SEEK_SET);
+
+    Server S = newServer(G, threads, 1 + (int) (genRandom(state) % TRIAL_REQUESTS));
+    serveStream(S, fileno(request), fileno(response));
+    freeServer(&S);
+    lseek(fileno(response), 0, SEEK_SET);
+
+    for (int i = 0; i < TRIAL_REQUESTS; i++) {
+        long long s;
+        long long d;
+        char word[32];
+
+        checks++;
+        if (fscanf(response, "%lld %lld %31s", &s, &d, word) != 3 || s != source[i] || d != dest[i]) {
+            fail("response %d is not for request %" PRIvertex " %" PRIvertex, i, source[i], dest[i]);
+            break;
+        }
+        if (strcmp(word, "error") == 0) {
+            if (dest[i] <= n)
+                fail("request %" PRIvertex " %" PRIvertex " should not be an error", source[i], dest[i]);
+            continue;
+        }
+        if (dest[i] > n) {
+            fail("request %" PRIvertex " %" PRIvertex " should be an error", source[i], dest[i]);
+            break;
+        }
+
+        Vertex dist = (Vertex) strtoll(word, NULL, 10);
+        refBFS(R, source[i]);
+        checkDist(R, dest[i], dist);
+        if (dist == INF) {
+            append(L, NIL);
+        } else {
+            for (Vertex j = 0; j <= dist; j++) {
+                long long v;
+                if (fscanf(response, "%lld", &v) != 1)
+                    break;
+                append(L, (Vertex) v);
+            }
+        }
+        checkPath(R, L, dest[i]);
+    }
+    fclose(request);
+    fclose(response);
+}
+
+// randomSet()
+// Fills a[0..n-1] with a strictly increasing run of random gaps up to gap.
+static void randomSet(uint64_t *state, Vertex *a, EdgeIndex n, Vertex gap) {
+    Vertex x = 0;
+    for (EdgeIndex i = 0; i < n; i++) {
+        x += genRandomVertex(state, gap);
+        a[i] = x;
+    }
+}
+
+// checkIntersect()
+// Checks intersectSorted(), with whichever merge kernel GRAPHADT_SIMD leaves
+// it, against intersectMerge() on random pairs of sorted arrays, some lopsided
+// enough to gallop.
+static void checkIntersect(uint64_t *state) {
+    backend = intersectKernel();
+    for (int t = 0; t < TRIAL_INTERSECTIONS; t++) {
+        EdgeIndex na = (EdgeIndex) (genRandom(state) % 300);
+        EdgeIndex nb = genRandom(state) % 4 == 0 ? na * 40 + 1 : (EdgeIndex) (genRandom(state) % 300);
+        Vertex gap = 1 + (Vertex) (genRandom(state) % 4);
+        EdgeIndex room = (na < nb ? na : nb) + INTERSECT_PAD;
+        Vertex *a = malloc(sizeof(Vertex) * (size_t) (na + 1));
+        Vertex *b = malloc(sizeof(Vertex) * (size_t) (nb + 1));
+        Vertex *want = malloc(sizeof(Vertex) * (size_t) room);
+        Vertex *got = malloc(sizeof(Vertex) * (size_t) room);
+
+        randomSet(state, a, na, gap);
+        randomSet(state, b, nb, nb > na * 8 ? 1 : gap);
+        EdgeIndex count = intersectMerge(a, na, b, nb, want);
+        checks += 2;
+        if (intersectSorted(a, na, b, nb, NULL) != count)
+            fail("intersectSorted() count of %" PRIedge " and %" PRIedge " elements should be %" PRIedge,
+                 na, nb, count);
+        else if (intersectSorted(a, na, b, nb, got) != count ||
+                 memcmp(got, want, sizeof(Vertex) * (size_t) count) != 0)
+            fail("intersectSorted() of %" PRIedge " and %" PRIedge " elements differs from intersectMerge()",
+                 na, nb);
+        free(a);
+        free(b);
+        free(want);
+        free(got);
+    }
+}
+
+
+// Trials ---------------------------------------------------------------------
+
+// generate()
+// Returns a random graph of one of several shapes, with some self-loops and
+// repeated edges mixed in.
+static EdgeList generate(uint64_t *state) {
+    EdgeList E;
+
+    switch (genRandom(state) % 5) {
+        case 0: {
+            Vertex n = 2 + (Vertex) (genRandom(state) % 300);
+            E = genErdosRenyi(n, (EdgeIndex) (genRandom(state) % (3 * (uint64_t) n + 1)), genRandom(state));
+            break;
+        }
+        case 1: {
+            int scale = 4 + (int) (genRandom(state) % 6);
+            E = genRMAT(scale, (EdgeIndex) 4 << scale, 0.57, 0.19, 0.19, genRandom(state));
+            break;
+        }
+        case 2:
+            E = genPath(1 + (Vertex) (genRandom(state) % 500));
+            break;
+        case 3:
+            E = genStar(2 + (Vertex) (genRandom(state) % 2000));
+            break;
+        default:
+            E = genGrid2D(1 + (Vertex) (genRandom(state) % 30), 1 + (Vertex) (genRandom(state) % 30));
+    }
+
+    Vertex n = edgeOrder(E);
+    EdgeIndex m = edgeCount(E);
+    EdgeIndex extra = (EdgeIndex) (genRandom(state) % ((uint64_t) n / 10 + 2));
+    for (EdgeIndex i = 0; i < extra; i++) {
+        Vertex u = genRandomVertex(state, n);
+        if (m > 0 && genRandom(state) % 2)
+            appendEdge(E, edgeSource(E, (EdgeIndex) (genRandom(state) % (uint64_t) m)),
+                       edgeTarget(E, (EdgeIndex) (genRandom(state) % (uint64_t) m)));
+        else
+            appendEdge(E, u, u);
+    }
+    return E;
+}
+
+// runTrial()
+// Checks every backend on one random graph drawn from seed.
+static void runTrial(uint64_t seed, int threads, List L) {
+    uint64_t state = seed;
+    EdgeList E = generate(&state);
+    int directed = (int) (genRandom(&state) % 2);
+    int policy = (int) (genRandom(&state) % 4);
+    Vertex n = edgeOrder(E);
+    Vertex *source = edgeSources(E);
+    Vertex *target = edgeTargets(E);
+    Reference R = newReference(E, directed);
+    Vertex sources[TRIAL_SOURCES];
+
+    sources[0] = 1;
+    for (int i = 1; i < TRIAL_SOURCES; i++)
+        sources[i] = genRandomVertex(&state, n);
+
+    // The original adjacency lists, which every other store must reproduce
+    Graph G = newGraph(n);
+    setEdgePolicy(G, policy);
+    for (EdgeIndex i = 0; i < edgeCount(E); i++) {
+        if (directed)
+            addArc(G, source[i], target[i]);
+        else
+            addEdge(G, source[i], target[i]);
+    }
+    checkGraph("lists", G, &R, sources, L);
+    checkTry(E, directed, policy, &R, sources, L);
+
+    // Serial and parallel builds
+    int builders[2] = { 1, threads };
+    Graph B = NULL;
+    for (int i = 0; i < 2; i++) {
+        if (B != NULL)
+            freeGraph(&B);
+        B = newGraphFromEdges(E, !directed, policy, builders[i]);
+        backend = "newGraphFromEdges";
+        checkAdjacency(B, G);
+        checkGraph("newGraphFromEdges", B, &R, sources, L);
+    }
+
+    const EdgeIndex *offset;
+    const Vertex *adjacency;
+    getAdjacency(B, &offset, &adjacency);
+    Graph V = newGraphView(n, offset, adjacency, getSize(B), NULL, NULL);
+    checkGraph("newGraphView", V, &R, sources, L);
+    freeGraph(&V);
+
+    checkQueries(B, &R, sources, &state, L);
+    checkArrays(B, &R, sources, n < 3 ? (int) n : 2 + (int) (genRandom(&state) % 2));
+    checkArrays(G, &R, sources, 1);
+    checkSnapshot(B, G, &R, sources, L);
+    checkShared(B, G, &R, sources, L);
+    checkServer(B, &R, &state, threads, L);
+    checkIntersect(&state);
+
+    // The input file format holds undirected edges only, kept as repeated
+    if (!directed) {
+        FILE *text = tmpfile();
+        writeGraphInput(text, E);
+
+        Graph want = G;
+        if (policy != EDGES_MULTI)
+            want = newGraphFromEdges(E, 1, EDGES_MULTI, 1);
+
+        rewind(text);
+        Graph T = readGraph(text);
+        backend = "readGraph";
+        checkAdjacency(T, want);
+        checkGraph("readGraph", T, &R, sources, L);
+        freeGraph(&T);
+
+        rewind(text);
+        backend = "tryReadGraph";
+        checks++;
+        if (tryReadGraph(text, &T) != GRAPH_OK) {
+            fail("tryReadGraph() failed");
+        } else {
+            checkAdjacency(T, want);
+            freeGraph(&T);
+        }
+
+        for (int i = 0; i < 2; i++) {
+            rewind(text);
+            T = loadGraph(text, NULL, builders[i]);
+            backend = "loadGraph";
+            checkAdjacency(T, want);
+            checkGraph("loadGraph", T, &R, sources, L);
+            freeGraph(&T);
+        }
+
+        checkExternal(text, &R, sources, L);
+        fclose(text);
+        if (want != G)
+            freeGraph(&want);
+    }
+
+    freeGraph(&B);
+    freeGraph(&G);
+    freeReference(&R);
+    freeEdgeList(&E);
+}
+
+// usage()
+// Prints the command line options and exits.
+static void usage(const char *prog) {
+    printf("Usage: %s [-n trials] [-x seed] [-t threads]\n", prog);
+    exit(1);
+}
+
+int main(int argc, char *argv[]) {
+    int trials = 100;
+    uint64_t seed = 1;
+    int threads = 3;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:x:t:")) != -1) {
+        switch (opt) {
+            case 'n': trials = atoi(optarg); break;
+            case 'x': seed = strtoull(optarg, NULL, 10); break;
+            case 't': threads = atoi(optarg); break;
+            default: usage(argv[0]);
+        }
+    }
+    if (trials < 1 || threads < 1)
+        usage(argv[0]);
+
+    // Every trial gets its own seed, so a failure replays alone with -n 1 -x
+    List L = newList();
+    for (trial = 0; trial < trials; trial++) {
+        trialSeed = seed + (uint64_t) trial;
+        runTrial(trialSeed, threads, L);
+    }
+    freeList(&L);
+
+    printf("%d trials, %ld checks, %ld failures\n", trials, checks, failures);
+    return failures == 0 ? 0 : 1;
+}
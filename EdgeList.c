@@ -0,0 +1,277 @@
+//-----------------------------------------------------------------------------
+// EdgeList.c
+// Implementation file for EdgeList ADT
+//-----------------------------------------------------------------------------
+
+#include "EdgeList.h"
+
+// structs --------------------------------------------------------------------
+
+// private EdgeListObj type
+typedef struct EdgeListObj {
+    Vertex *source;
+    Vertex *target;
+
+    // NULL until the first weighted edge
+    Weight *weight;
+
+    Vertex order;
+    EdgeIndex count;
+    EdgeIndex capacity;
+} EdgeListObj;
+
+
+// Constructors-Destructors ---------------------------------------------------
+
+// newEdgeList()
+// Returns an empty EdgeList over vertices 1..order with room for capacity
+// edges before it has to grow.
+EdgeList newEdgeList(Vertex order, EdgeIndex capacity) {
+    if (order < 0 || capacity < 0) {
+        printf("EdgeList Error: newEdgeList() called with negative order or capacity\n");
+        exit(1);
+    }
+    if (capacity == 0)
+        capacity = 16;
+
+    EdgeList E = malloc(sizeof(EdgeListObj));
+    E->source = malloc(sizeof(Vertex) * (size_t) capacity);
+    E->target = malloc(sizeof(Vertex) * (size_t) capacity);
+    if (E->source == NULL || E->target == NULL) {
+        printf("EdgeList Error: newEdgeList() unable to allocate %" PRIedge " edges\n", capacity);
+        exit(1);
+    }
+
+    E->weight = NULL;
+    E->order = order;
+    E->count = 0;
+    E->capacity = capacity;
+    return (E);
+}
+
+// freeEdgeList()
+// Frees all heap memory associated with *pE, and sets *pE to NULL.
+void freeEdgeList(EdgeList *pE) {
+    if (pE == NULL || *pE == NULL) {
+        printf("EdgeList Error: freeEdgeList() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+
+    free((*pE)->source);
+    free((*pE)->target);
+    free((*pE)->weight);
+    free(*pE);
+    *pE = NULL;
+}
+
+
+// Access functions -----------------------------------------------------------
+
+// edgeOrder()
+// Returns the number of vertices E's edges range over.
+Vertex edgeOrder(EdgeList E) {
+    if (E == NULL) {
+        printf("EdgeList Error: edgeOrder() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    return E->order;
+}
+
+// edgeCount()
+// Returns the number of edges in E.
+EdgeIndex edgeCount(EdgeList E) {
+    if (E == NULL) {
+        printf("EdgeList Error: edgeCount() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    return E->count;
+}
+
+// edgeSource()
+// Returns the source of the i'th edge.
+// Pre: 0 <= i < edgeCount(E)
+Vertex edgeSource(EdgeList E, EdgeIndex i) {
+    if (E == NULL) {
+        printf("EdgeList Error: edgeSource() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    if (i < 0 || i >= E->count) {
+        printf("EdgeList Error: edgeSource() called on index outside range of EdgeList\n");
+        exit(1);
+    }
+    return E->source[i];
+}
+
+// edgeTarget()
+// Returns the target of the i'th edge.
+// Pre: 0 <= i < edgeCount(E)
+Vertex edgeTarget(EdgeList E, EdgeIndex i) {
+    if (E == NULL) {
+        printf("EdgeList Error: edgeTarget() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    if (i < 0 || i >= E->count) {
+        printf("EdgeList Error: edgeTarget() called on index outside range of EdgeList\n");
+        exit(1);
+    }
+    return E->target[i];
+}
+
+// edgeSources()
+// Returns the array of edge sources, valid until E is next modified.
+Vertex *edgeSources(EdgeList E) {
+    if (E == NULL) {
+        printf("EdgeList Error: edgeSources() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    return E->source;
+}
+
+// edgeTargets()
+// Returns the array of edge targets, valid until E is next modified.
+Vertex *edgeTargets(EdgeList E) {
+    if (E == NULL) {
+        printf("EdgeList Error: edgeTargets() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    return E->target;
+}
+
+// edgeWeight()
+// Returns the weight of the i'th edge, 1 if E is unweighted.
+// Pre: 0 <= i < edgeCount(E)
+Weight edgeWeight(EdgeList E, EdgeIndex i) {
+    if (E == NULL) {
+        printf("EdgeList Error: edgeWeight() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    if (i < 0 || i >= E->count) {
+        printf("EdgeList Error: edgeWeight() called on index outside range of EdgeList\n");
+        exit(1);
+    }
+    return E->weight != NULL ? E->weight[i] : 1;
+}
+
+// edgeWeights()
+// Returns the array of edge weights, or NULL if E is unweighted.
+Weight *edgeWeights(EdgeList E) {
+    if (E == NULL) {
+        printf("EdgeList Error: edgeWeights() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    return E->weight;
+}
+
+
+// Manipulation procedures ----------------------------------------------------
+
+// growEdges()
+// Doubles the capacity of E when it is full.
+// Private.
+static void growEdges(EdgeList E, const char *caller) {
+    if (E->count < E->capacity)
+        return;
+
+    EdgeIndex capacity = E->capacity * 2;
+    Vertex *source = realloc(E->source, sizeof(Vertex) * (size_t) capacity);
+    Vertex *target = realloc(E->target, sizeof(Vertex) * (size_t) capacity);
+    Weight *weight = E->weight;
+    if (weight != NULL)
+        weight = realloc(weight, sizeof(Weight) * (size_t) capacity);
+    if (source == NULL || target == NULL || (E->weight != NULL && weight == NULL)) {
+        printf("EdgeList Error: %s() unable to grow to %" PRIedge " edges\n", caller, capacity);
+        exit(1);
+    }
+    E->source = source;
+    E->target = target;
+    E->weight = weight;
+    E->capacity = capacity;
+}
+
+// appendEdge()
+// Appends the edge (u, v) to E, doubling its capacity when full.
+// Pre: 1 <= u, v <= edgeOrder(E)
+void appendEdge(EdgeList E, Vertex u, Vertex v) {
+    if (E == NULL) {
+        printf("EdgeList Error: appendEdge() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    if (u < 1 || u > E->order || v < 1 || v > E->order) {
+        printf("EdgeList Error: appendEdge() called on vertex outside range of EdgeList\n");
+        exit(1);
+    }
+
+    growEdges(E, "appendEdge");
+    E->source[E->count] = u;
+    E->target[E->count] = v;
+    if (E->weight != NULL)
+        E->weight[E->count] = 1;
+    E->count++;
+}
+
+// addWeights()
+// Gives E a weight array, every edge weighing 1, unless it has one.
+// Private.
+static void addWeights(EdgeList E, const char *caller) {
+    if (E->weight != NULL)
+        return;
+
+    E->weight = malloc(sizeof(Weight) * (size_t) E->capacity);
+    if (E->weight == NULL) {
+        printf("EdgeList Error: %s() unable to allocate %" PRIedge " weights\n", caller, E->capacity);
+        exit(1);
+    }
+    for (EdgeIndex i = 0; i < E->count; i++)
+        E->weight[i] = 1;
+}
+
+// appendWeightedEdge()
+// Appends the edge (u, v) with weight w to E, first giving an unweighted E a
+// weight array.
+// Pre: 1 <= u, v <= edgeOrder(E)
+void appendWeightedEdge(EdgeList E, Vertex u, Vertex v, Weight w) {
+    if (E == NULL) {
+        printf("EdgeList Error: appendWeightedEdge() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    if (u < 1 || u > E->order || v < 1 || v > E->order) {
+        printf("EdgeList Error: appendWeightedEdge() called on vertex outside range of EdgeList\n");
+        exit(1);
+    }
+
+    addWeights(E, "appendWeightedEdge");
+    growEdges(E, "appendWeightedEdge");
+
+    E->source[E->count] = u;
+    E->target[E->count] = v;
+    E->weight[E->count] = w;
+    E->count++;
+}
+
+// setEdgeWeight()
+// Sets the weight of the i'th edge, first giving an unweighted E a weight
+// array.
+// Pre: 0 <= i < edgeCount(E)
+void setEdgeWeight(EdgeList E, EdgeIndex i, Weight w) {
+    if (E == NULL) {
+        printf("EdgeList Error: setEdgeWeight() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    if (i < 0 || i >= E->count) {
+        printf("EdgeList Error: setEdgeWeight() called on index outside range of EdgeList\n");
+        exit(1);
+    }
+
+    addWeights(E, "setEdgeWeight");
+    E->weight[i] = w;
+}
+
+// clearEdges()
+// Removes all edges from E, keeping its order, capacity and weights array.
+void clearEdges(EdgeList E) {
+    if (E == NULL) {
+        printf("EdgeList Error: clearEdges() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    E->count = 0;
+}
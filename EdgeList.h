@@ -0,0 +1,95 @@
+//-----------------------------------------------------------------------------
+// EdgeList.h
+// Header file for EdgeList ADT
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_EDGELIST_H
+#define GRAPHADT_EDGELIST_H
+
+#include<stdio.h>
+#include<stdlib.h>
+#include"GraphTypes.h"
+
+// Exported type --------------------------------------------------------------
+// Growable array of (source, target) vertex pairs over vertices 1..order,
+// stored as two parallel arrays. A third array of weights is added when the
+// first weighted edge is appended; until then every edge weighs 1.
+typedef struct EdgeListObj *EdgeList;
+
+
+// Constructors-Destructors ---------------------------------------------------
+
+// newEdgeList()
+// Returns an empty EdgeList over vertices 1..order with room for capacity
+// edges before it has to grow.
+EdgeList newEdgeList(Vertex order, EdgeIndex capacity);
+
+// freeEdgeList()
+// Frees all heap memory associated with *pE, and sets *pE to NULL.
+void freeEdgeList(EdgeList *pE);
+
+
+// Access functions -----------------------------------------------------------
+
+// edgeOrder()
+// Returns the number of vertices E's edges range over.
+Vertex edgeOrder(EdgeList E);
+
+// edgeCount()
+// Returns the number of edges in E.
+EdgeIndex edgeCount(EdgeList E);
+
+// edgeSource()
+// Returns the source of the i'th edge.
+// Pre: 0 <= i < edgeCount(E)
+Vertex edgeSource(EdgeList E, EdgeIndex i);
+
+// edgeTarget()
+// Returns the target of the i'th edge.
+// Pre: 0 <= i < edgeCount(E)
+Vertex edgeTarget(EdgeList E, EdgeIndex i);
+
+// edgeSources()
+// Returns the array of edge sources, valid until E is next modified.
+Vertex *edgeSources(EdgeList E);
+
+// edgeTargets()
+// Returns the array of edge targets, valid until E is next modified.
+Vertex *edgeTargets(EdgeList E);
+
+// edgeWeight()
+// Returns the weight of the i'th edge, 1 if E is unweighted.
+// Pre: 0 <= i < edgeCount(E)
+Weight edgeWeight(EdgeList E, EdgeIndex i);
+
+// edgeWeights()
+// Returns the array of edge weights, valid until E is next modified, or NULL
+// if E is unweighted.
+Weight *edgeWeights(EdgeList E);
+
+
+// Manipulation procedures ----------------------------------------------------
+
+// appendEdge()
+// Appends the edge (u, v) to E.
+// Pre: 1 <= u, v <= edgeOrder(E)
+void appendEdge(EdgeList E, Vertex u, Vertex v);
+
+// appendWeightedEdge()
+// Appends the edge (u, v) with weight w to E. The first call on an
+// unweighted E gives its existing edges weight 1.
+// Pre: 1 <= u, v <= edgeOrder(E)
+void appendWeightedEdge(EdgeList E, Vertex u, Vertex v, Weight w);
+
+// setEdgeWeight()
+// Sets the weight of the i'th edge to w. The first call on an unweighted E
+// gives its other edges weight 1.
+// Pre: 0 <= i < edgeCount(E)
+void setEdgeWeight(EdgeList E, EdgeIndex i, Weight w);
+
+// clearEdges()
+// Removes all edges from E, keeping its order and capacity, and whether it is
+// weighted.
+void clearEdges(EdgeList E);
+
+#endif //GRAPHADT_EDGELIST_H
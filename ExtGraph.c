@@ -0,0 +1,599 @@
+//-----------------------------------------------------------------------------
+// ExtGraph.c
+// Implementation file for ExtGraph ADT
+//-----------------------------------------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64
+
+#include <string.h>
+#include <sys/types.h>
+#include "ExtGraph.h"
+#include "GraphIO.h"
+#include "Sort.h"
+
+#define EXT_MAGIC "GADJEXT1"
+
+// Smallest run and merge buffers, however small the memory budget
+#define MIN_RUN_ARCS 1024
+#define MIN_MERGE_ARCS 256
+
+// structs --------------------------------------------------------------------
+
+// private ExtHeader type: the fixed-size start of an edge file
+typedef struct ExtHeader {
+    char magic[8];
+    int64_t order;
+    int64_t size;
+    int64_t vertexBytes;
+    int64_t offsetsPos;
+} ExtHeader;
+
+// private Arc type: one directed half of an input edge
+typedef struct Arc {
+    Vertex u;
+    Vertex v;
+} Arc;
+
+// private Run type: a sorted run of arcs on a temporary file, being merged
+typedef struct Run {
+    FILE *file;
+    Arc *buf;
+    EdgeIndex cap;
+    EdgeIndex len;
+    EdgeIndex pos;
+} Run;
+
+// private RankKey type: orders a discovered vertex by its parent's rank
+typedef struct RankKey {
+    Vertex rank;
+    Vertex v;
+} RankKey;
+
+// private ExtGraphObj type
+typedef struct ExtGraphObj {
+    FILE *file;
+    Vertex order;
+    EdgeIndex size;
+    EdgeIndex arcs;
+    EdgeIndex *offset;
+
+    // Window buf[0..bufLen-1] holds targets bufBase.. of the file; filePos is
+    // the target index the file is positioned at
+    Vertex *buf;
+    EdgeIndex bufCap;
+    EdgeIndex bufBase;
+    EdgeIndex bufLen;
+    EdgeIndex filePos;
+    EdgeIndex bytesRead;
+
+    // BFS state. rank[u] is u's position in the queue order BFS() would use
+    // within u's level, which decides parents exactly as BFS() does.
+    Vertex *distance;
+    Vertex *parent;
+    Vertex *rank;
+    Vertex *frontier;
+    Vertex *next;
+    RankKey *keys;
+    Vertex source;
+} ExtGraphObj;
+
+
+// Helpers --------------------------------------------------------------------
+
+// compareArc()
+// qsort() comparator ordering arcs by source, then target.
+// Private.
+static int compareArc(const void *a, const void *b) {
+    const Arc *x = a;
+    const Arc *y = b;
+    if (x->u != y->u)
+        return (x->u > y->u) - (x->u < y->u);
+    return (x->v > y->v) - (x->v < y->v);
+}
+
+// compareRankKey()
+// qsort() comparator ordering keys by parent rank, then vertex.
+// Private.
+static int compareRankKey(const void *a, const void *b) {
+    const RankKey *x = a;
+    const RankKey *y = b;
+    if (x->rank != y->rank)
+        return (x->rank > y->rank) - (x->rank < y->rank);
+    return (x->v > y->v) - (x->v < y->v);
+}
+
+// writeAll()
+// Writes n items of size bytes from p to f, exiting on failure.
+// Private.
+static void writeAll(const void *p, size_t size, size_t n, FILE *f) {
+    if (fwrite(p, size, n, f) != n) {
+        printf("ExtGraph Error: unable to write edge file\n");
+        exit(1);
+    }
+}
+
+// flushRun()
+// Sorts arc[0..n-1] and writes it to a new temporary run file.
+// Private.
+static FILE *flushRun(Arc *arc, EdgeIndex n) {
+    FILE *f = tmpfile();
+    if (f == NULL) {
+        printf("ExtGraph Error: writeExtGraph() unable to create run file\n");
+        exit(1);
+    }
+    qsort(arc, (size_t) n, sizeof(Arc), compareArc);
+    writeAll(arc, sizeof(Arc), (size_t) n, f);
+    rewind(f);
+    return f;
+}
+
+// runHead()
+// Returns the next unmerged arc of R, refilling its buffer as needed, or NULL
+// once R is exhausted.
+// Private.
+static const Arc *runHead(Run *R) {
+    if (R->pos == R->len) {
+        R->len = (EdgeIndex) fread(R->buf, sizeof(Arc), (size_t) R->cap, R->file);
+        R->pos = 0;
+        if (R->len == 0)
+            return NULL;
+    }
+    return &R->buf[R->pos];
+}
+
+// siftDown()
+// Restores the min-heap of run indices heap[0..n-1] below position i.
+// Private.
+static void siftDown(int *heap, int n, int i, Run *run) {
+    for (;;) {
+        int least = i;
+        int l = 2 * i + 1;
+        int r = l + 1;
+        if (l < n && compareArc(runHead(&run[heap[l]]), runHead(&run[heap[least]])) < 0)
+            least = l;
+        if (r < n && compareArc(runHead(&run[heap[r]]), runHead(&run[heap[least]])) < 0)
+            least = r;
+        if (least == i)
+            return;
+        int t = heap[i];
+        heap[i] = heap[least];
+        heap[least] = t;
+        i = least;
+    }
+}
+
+// targetsAt()
+// Returns a pointer to target e of the file, and sets *avail to how many
+// consecutive targets from e are buffered. Reads forward through gaps shorter
+// than the buffer rather than seeking, keeping access sequential.
+// Private.
+static const Vertex *targetsAt(ExtGraph X, EdgeIndex e, EdgeIndex *avail) {
+    EdgeIndex end = X->bufBase + X->bufLen;
+
+    if (e < X->bufBase || e >= end) {
+        EdgeIndex base = e;
+        if (e >= end && e - end < X->bufCap && X->filePos == end)
+            base = end;
+        else if (X->filePos != e
+                 && fseeko(X->file, (off_t) sizeof(ExtHeader) + (off_t) e * (off_t) sizeof(Vertex), SEEK_SET) != 0) {
+            printf("ExtGraph Error: unable to seek in edge file\n");
+            exit(1);
+        }
+
+        EdgeIndex want = X->arcs - base < X->bufCap ? X->arcs - base : X->bufCap;
+        EdgeIndex got = (EdgeIndex) fread(X->buf, sizeof(Vertex), (size_t) want, X->file);
+        if (got != want) {
+            printf("ExtGraph Error: edge file is truncated\n");
+            exit(1);
+        }
+        X->bufBase = base;
+        X->bufLen = got;
+        X->filePos = base + got;
+        X->bytesRead += got * (EdgeIndex) sizeof(Vertex);
+    }
+
+    *avail = X->bufBase + X->bufLen - e;
+    return X->buf + (e - X->bufBase);
+}
+
+
+// Constructors-Destructors ---------------------------------------------------
+
+// writeExtGraph()
+// Reads the edge section of a FindPath input file and writes it as a sorted
+// edge file, through an external merge sort bounded by memoryBytes.
+void writeExtGraph(FILE *in, const char *path, size_t memoryBytes) {
+    if (in == NULL) {
+        printf("ExtGraph Error: writeExtGraph() called on NULL FILE reference\n");
+        exit(1);
+    }
+
+    // Reads in number of Vertices to expect
+    Vertex n;
+    if (!readVertex(in, &n)) {
+        printf("GraphIO Error: readGraph() unable to read number of vertices\n");
+        exit(1);
+    }
+
+    // Cuts the edge section into sorted runs
+    EdgeIndex cap = (EdgeIndex) (memoryBytes / sizeof(Arc));
+    if (cap < MIN_RUN_ARCS)
+        cap = MIN_RUN_ARCS;
+    Arc *arc = malloc(sizeof(Arc) * (size_t) cap);
+    FILE **runFile = NULL;
+    int runs = 0;
+    EdgeIndex count = 0;
+    EdgeIndex size = 0;
+    Vertex u;
+    Vertex v;
+
+    while (readPair(in, &u, &v)) {
+        if (u == 0 && v == 0)
+            break;
+        if (u < 1 || u > n) {
+            printf("Graph Error: addEdge() called on vertex u outside range of Graph\n");
+            exit(1);
+        }
+        if (v < 1 || v > n) {
+            printf("Graph Error: addEdge() called on vertex v outside range of Graph\n");
+            exit(1);
+        }
+        for (int half = 0; half < 2; half++) {
+            if (count == cap) {
+                runFile = realloc(runFile, sizeof(FILE *) * (size_t) (runs + 1));
+                runFile[runs++] = flushRun(arc, count);
+                count = 0;
+            }
+            arc[count].u = half ? v : u;
+            arc[count].v = half ? u : v;
+            count++;
+        }
+        size++;
+    }
+    if (count > 0 || runs == 0) {
+        runFile = realloc(runFile, sizeof(FILE *) * (size_t) (runs + 1));
+        runFile[runs++] = flushRun(arc, count);
+    }
+    free(arc);
+
+    FILE *out = fopen(path, "wb");
+    if (out == NULL) {
+        printf("Unable to open file %s for writing\n", path);
+        exit(1);
+    }
+    setvbuf(out, NULL, _IOFBF, 1 << 20);
+    ExtHeader H;
+    memset(&H, 0, sizeof(H));
+    writeAll(&H, sizeof(H), 1, out);
+
+    // Merges the runs, streaming targets out and counting degrees
+    Run *run = malloc(sizeof(Run) * (size_t) runs);
+    int *heap = malloc(sizeof(int) * (size_t) runs);
+    int live = 0;
+    EdgeIndex share = (EdgeIndex) (memoryBytes / sizeof(Arc)) / runs;
+    if (share < MIN_MERGE_ARCS)
+        share = MIN_MERGE_ARCS;
+    for (int r = 0; r < runs; r++) {
+        run[r].file = runFile[r];
+        run[r].buf = malloc(sizeof(Arc) * (size_t) share);
+        run[r].cap = share;
+        run[r].len = 0;
+        run[r].pos = 0;
+        if (runHead(&run[r]) != NULL)
+            heap[live++] = r;
+    }
+    for (int i = live / 2 - 1; i >= 0; i--)
+        siftDown(heap, live, i, run);
+
+    EdgeIndex *offset = calloc((size_t) n + 2, sizeof(EdgeIndex));
+    while (live > 0) {
+        Run *R = &run[heap[0]];
+        const Arc *a = runHead(R);
+        writeAll(&a->v, sizeof(Vertex), 1, out);
+        offset[a->u + 1]++;
+        R->pos++;
+        if (runHead(R) == NULL)
+            heap[0] = heap[--live];
+        siftDown(heap, live, 0, run);
+    }
+    for (Vertex w = 1; w <= n; w++)
+        offset[w + 1] += offset[w];
+
+    // Offsets follow the targets; the header is filled in last
+    memcpy(H.magic, EXT_MAGIC, sizeof(H.magic));
+    H.order = n;
+    H.size = size;
+    H.vertexBytes = (int64_t) sizeof(Vertex);
+    H.offsetsPos = (int64_t) sizeof(ExtHeader) + offset[n + 1] * (int64_t) sizeof(Vertex);
+    writeAll(offset, sizeof(EdgeIndex), (size_t) n + 2, out);
+    rewind(out);
+    writeAll(&H, sizeof(H), 1, out);
+    if (fclose(out) != 0) {
+        printf("ExtGraph Error: unable to write edge file\n");
+        exit(1);
+    }
+
+    for (int r = 0; r < runs; r++) {
+        fclose(run[r].file);
+        free(run[r].buf);
+    }
+    free(run);
+    free(runFile);
+    free(heap);
+    free(offset);
+}
+
+// openExtGraph()
+// Opens the edge file at path, loading its offsets and allocating BFS state.
+ExtGraph openExtGraph(const char *path, size_t bufferBytes) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        printf("Unable to open file %s for reading\n", path);
+        exit(1);
+    }
+
+    ExtHeader H;
+    if (fread(&H, sizeof(H), 1, f) != 1 || memcmp(H.magic, EXT_MAGIC, sizeof(H.magic)) != 0) {
+        printf("ExtGraph Error: %s is not an edge file\n", path);
+        exit(1);
+    }
+    if (H.vertexBytes != (int64_t) sizeof(Vertex)) {
+        printf("ExtGraph Error: %s has %d-bit vertices, this build uses %d-bit\n", path,
+               (int) (H.vertexBytes * 8), (int) (sizeof(Vertex) * 8));
+        exit(1);
+    }
+
+    ExtGraph X = malloc(sizeof(ExtGraphObj));
+    size_t numTerms = (size_t) H.order + 1;
+    X->file = f;
+    X->order = (Vertex) H.order;
+    X->size = H.size;
+    X->offset = malloc(sizeof(EdgeIndex) * (numTerms + 1));
+    if (fseeko(f, (off_t) H.offsetsPos, SEEK_SET) != 0
+        || fread(X->offset, sizeof(EdgeIndex), numTerms + 1, f) != numTerms + 1) {
+        printf("ExtGraph Error: %s is truncated\n", path);
+        exit(1);
+    }
+    X->arcs = X->offset[X->order + 1];
+
+    X->bufCap = (EdgeIndex) (bufferBytes / sizeof(Vertex));
+    if (X->bufCap < MIN_MERGE_ARCS)
+        X->bufCap = MIN_MERGE_ARCS;
+    X->buf = malloc(sizeof(Vertex) * (size_t) X->bufCap);
+    X->bufBase = 0;
+    X->bufLen = 0;
+    X->filePos = -1;
+    X->bytesRead = 0;
+
+    X->distance = malloc(sizeof(Vertex) * numTerms);
+    X->parent = malloc(sizeof(Vertex) * numTerms);
+    X->rank = malloc(sizeof(Vertex) * numTerms);
+    X->frontier = malloc(sizeof(Vertex) * numTerms);
+    X->next = malloc(sizeof(Vertex) * numTerms);
+    X->keys = malloc(sizeof(RankKey) * numTerms);
+    for (Vertex i = 0; i <= X->order; i++) {
+        X->distance[i] = INF;
+        X->parent[i] = NIL;
+    }
+    X->source = NIL;
+    return X;
+}
+
+// freeExtGraph()
+// Closes the edge file and frees all memory associated with *pX.
+void freeExtGraph(ExtGraph *pX) {
+    if (pX != NULL && *pX != NULL) {
+        ExtGraph X = *pX;
+        fclose(X->file);
+        free(X->offset);
+        free(X->buf);
+        free(X->distance);
+        free(X->parent);
+        free(X->rank);
+        free(X->frontier);
+        free(X->next);
+        free(X->keys);
+        free(X);
+        *pX = NULL;
+    }
+}
+
+
+// Access functions -----------------------------------------------------------
+
+// getExtOrder()
+// Returns the number of vertices of X.
+Vertex getExtOrder(ExtGraph X) {
+    if (X == NULL) {
+        printf("ExtGraph Error: getExtOrder() called on NULL ExtGraph reference\n");
+        exit(1);
+    }
+    return X->order;
+}
+
+// getExtSize()
+// Returns the number of edges of X.
+EdgeIndex getExtSize(ExtGraph X) {
+    if (X == NULL) {
+        printf("ExtGraph Error: getExtSize() called on NULL ExtGraph reference\n");
+        exit(1);
+    }
+    return X->size;
+}
+
+// getExtSource()
+// Returns the source of the most recent extBFS() on X, otherwise NIL.
+Vertex getExtSource(ExtGraph X) {
+    if (X == NULL) {
+        printf("ExtGraph Error: getExtSource() called on NULL ExtGraph reference\n");
+        exit(1);
+    }
+    return X->source;
+}
+
+// getExtParent()
+// Returns the parent of u in X's BFS tree, or NIL.
+Vertex getExtParent(ExtGraph X, Vertex u) {
+    if (X == NULL) {
+        printf("ExtGraph Error: getExtParent() called on NULL ExtGraph reference\n");
+        exit(1);
+    }
+    if (u < 1 || u > X->order) {
+        printf("ExtGraph Error: getExtParent() called on vertex outside range of ExtGraph\n");
+        exit(1);
+    }
+    return X->parent[u];
+}
+
+// getExtDist()
+// Returns the distance from X's BFS source to u, or INF.
+Vertex getExtDist(ExtGraph X, Vertex u) {
+    if (X == NULL) {
+        printf("ExtGraph Error: getExtDist() called on NULL ExtGraph reference\n");
+        exit(1);
+    }
+    if (u < 1 || u > X->order) {
+        printf("ExtGraph Error: getExtDist() called on vertex outside range of ExtGraph\n");
+        exit(1);
+    }
+    return X->distance[u];
+}
+
+// getExtPath()
+// Appends to L a shortest path from X's BFS source to u, or NIL.
+void getExtPath(List L, ExtGraph X, Vertex u) {
+    if (L == NULL) {
+        printf("ExtGraph Error: getExtPath() called on NULL List reference\n");
+        exit(1);
+    }
+    if (X == NULL) {
+        printf("ExtGraph Error: getExtPath() called on NULL ExtGraph reference\n");
+        exit(1);
+    }
+    if (u < 1 || u > X->order) {
+        printf("ExtGraph Error: getExtPath() called on vertex outside range of ExtGraph\n");
+        exit(1);
+    }
+    if (X->source == NIL) {
+        printf("ExtGraph Error: getExtPath() called on NIL Source\n");
+        exit(1);
+    }
+
+    appendTreePath(L, X->distance, X->parent, X->source, u);
+}
+
+// getExtBytesRead()
+// Returns the number of adjacency bytes read from disk since X was opened.
+EdgeIndex getExtBytesRead(ExtGraph X) {
+    if (X == NULL) {
+        printf("ExtGraph Error: getExtBytesRead() called on NULL ExtGraph reference\n");
+        exit(1);
+    }
+    return X->bytesRead;
+}
+
+
+// Manipulation procedures ----------------------------------------------------
+
+// extBFS()
+// Expands each level in ascending vertex order, so adjacency is read front to
+// back. BFS() would expand the level in queue order instead, and a vertex's
+// parent is the first in that order to reach it; ranking each level by queue
+// order and keeping the lowest-ranked parent reproduces that exactly. The
+// next level's queue order is by parent rank, then by vertex, since every
+// adjacency list is ascending.
+void extBFS(ExtGraph X, Vertex s) {
+    if (X == NULL) {
+        printf("ExtGraph Error: extBFS() called on NULL ExtGraph reference\n");
+        exit(1);
+    }
+    if (s < 1 || s > X->order) {
+        printf("ExtGraph Error: extBFS() called on vertex outside range of ExtGraph\n");
+        exit(1);
+    }
+
+    for (Vertex i = 1; i <= X->order; i++) {
+        X->distance[i] = INF;
+        X->parent[i] = NIL;
+    }
+    X->source = s;
+    X->distance[s] = 0;
+    X->rank[s] = 0;
+    X->frontier[0] = s;
+    Vertex count = 1;
+
+    for (Vertex level = 0; count > 0; level++) {
+        Vertex found = 0;
+
+        for (Vertex i = 0; i < count; i++) {
+            Vertex u = X->frontier[i];
+            EdgeIndex e = X->offset[u];
+            EdgeIndex end = X->offset[u + 1];
+
+            while (e < end) {
+                EdgeIndex avail;
+                const Vertex *t = targetsAt(X, e, &avail);
+                if (avail > end - e)
+                    avail = end - e;
+                for (EdgeIndex k = 0; k < avail; k++) {
+                    Vertex v = t[k];
+                    if (X->distance[v] == INF) {
+                        X->distance[v] = level + 1;
+                        X->parent[v] = u;
+                        X->next[found++] = v;
+                    } else if (X->distance[v] == level + 1 && X->rank[u] < X->rank[X->parent[v]]) {
+                        X->parent[v] = u;
+                    }
+                }
+                e += avail;
+            }
+        }
+
+        // Ranks the new level in BFS() queue order, then sorts it by vertex
+        for (Vertex i = 0; i < found; i++) {
+            X->keys[i].rank = X->rank[X->parent[X->next[i]]];
+            X->keys[i].v = X->next[i];
+        }
+        qsort(X->keys, (size_t) found, sizeof(RankKey), compareRankKey);
+        for (Vertex i = 0; i < found; i++)
+            X->rank[X->keys[i].v] = i;
+
+        sortVertices(X->next, found);
+        Vertex *swap = X->frontier;
+        X->frontier = X->next;
+        X->next = swap;
+        count = found;
+    }
+}
+
+
+// Other Functions ------------------------------------------------------------
+
+// printExtGraph()
+// Prints the adjacency of X in printGraph() format, in one sequential pass.
+void printExtGraph(FILE *out, ExtGraph X) {
+    if (out == NULL) {
+        printf("ExtGraph Error: printExtGraph() called on NULL FILE reference\n");
+        exit(1);
+    }
+    if (X == NULL) {
+        printf("ExtGraph Error: printExtGraph() called on NULL ExtGraph reference\n");
+        exit(1);
+    }
+
+    for (Vertex u = 1; u <= X->order; u++) {
+        fprintf(out, "%" PRIvertex ": ", u);
+        EdgeIndex e = X->offset[u];
+        while (e < X->offset[u + 1]) {
+            EdgeIndex avail;
+            const Vertex *t = targetsAt(X, e, &avail);
+            if (avail > X->offset[u + 1] - e)
+                avail = X->offset[u + 1] - e;
+            for (EdgeIndex k = 0; k < avail; k++)
+                fprintf(out, "%" PRIvertex " ", t[k]);
+            e += avail;
+        }
+        fprintf(out, "\n");
+    }
+}
@@ -0,0 +1,101 @@
+//-----------------------------------------------------------------------------
+// ExtGraph.h
+// Header file for ExtGraph ADT, a semi-external graph whose adjacency stays
+// on disk
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_EXTGRAPH_H
+#define GRAPHADT_EXTGRAPH_H
+
+#include"Graph.h"
+
+// Exported type --------------------------------------------------------------
+// Undirected graph whose adjacency lives in an edge file on disk, sorted by
+// source then target. Only per-vertex state (offsets, distance, parent and
+// frontier bookkeeping) is held in memory, so graphs with many more edges than
+// fit in RAM can be searched. BFS reads each level's adjacency in ascending
+// file order with large sequential reads.
+typedef struct ExtGraphObj *ExtGraph;
+
+/* Edge file structure (native byte order):
+ *
+ * header      magic "GADJEXT1", order, size, vertex bytes, offsets position
+ * targets     neighbors of 1, neighbors of 2, ... each list ascending
+ * offsets     order + 2 adjacency offsets, as getAdjacency() gives them
+*/
+
+
+// Constructors-Destructors ---------------------------------------------------
+
+// writeExtGraph()
+// Reads the vertex count and edge section of a FindPath input file from in
+// and writes the edge file at path, holding at most about memoryBytes of arcs
+// in memory: longer inputs are sorted in runs on temporary files and merged.
+// Leaves in positioned at the start of the query section.
+void writeExtGraph(FILE *in, const char *path, size_t memoryBytes);
+
+// openExtGraph()
+// Opens the edge file at path for searching, reading adjacency through a
+// buffer of about bufferBytes.
+ExtGraph openExtGraph(const char *path, size_t bufferBytes);
+
+// freeExtGraph()
+// Closes the edge file and frees all memory associated with *pX, then sets
+// *pX to NULL.
+void freeExtGraph(ExtGraph *pX);
+
+
+// Access functions -----------------------------------------------------------
+
+// getExtOrder()
+// Returns the number of vertices of X.
+Vertex getExtOrder(ExtGraph X);
+
+// getExtSize()
+// Returns the number of edges of X, counted as getSize() would.
+EdgeIndex getExtSize(ExtGraph X);
+
+// getExtSource()
+// Returns the source of the most recent extBFS() on X, otherwise NIL.
+Vertex getExtSource(ExtGraph X);
+
+// getExtParent()
+// Returns the parent of u in X's BFS tree, or NIL.
+// Precondition: 1 <= u <= getExtOrder(X)
+Vertex getExtParent(ExtGraph X, Vertex u);
+
+// getExtDist()
+// Returns the distance from X's BFS source to u, or INF if u is unreachable
+// or extBFS() has not been called yet.
+// Precondition: 1 <= u <= getExtOrder(X)
+Vertex getExtDist(ExtGraph X, Vertex u);
+
+// getExtPath()
+// Appends to L the vertices of a shortest path from X's BFS source to u, or
+// NIL if no such path exists.
+// Precondition: 1 <= u <= getExtOrder(X), getExtSource(X) != NIL
+void getExtPath(List L, ExtGraph X, Vertex u);
+
+// getExtBytesRead()
+// Returns the number of adjacency bytes read from disk since X was opened.
+EdgeIndex getExtBytesRead(ExtGraph X);
+
+
+// Manipulation procedures ----------------------------------------------------
+
+// extBFS()
+// Runs a level-synchronous BFS from s, expanding each level's frontier in
+// ascending vertex order so its adjacency is read front to back. Distances
+// and parents equal those BFS() computes on the same graph.
+// Precondition: 1 <= s <= getExtOrder(X)
+void extBFS(ExtGraph X, Vertex s);
+
+
+// Other Functions ------------------------------------------------------------
+
+// printExtGraph()
+// Prints the adjacency of X to out in the same format as printGraph(),
+// streaming it from disk.
+void printExtGraph(FILE *out, ExtGraph X);
+
+#endif //GRAPHADT_EXTGRAPH_H
@@ -3,19 +3,251 @@
 // Main file for Graph ADT
 //-----------------------------------------------------------------------------
 
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
 #include <string.h>
-#include"Graph.h"
+#include <unistd.h>
+#include"ExtGraph.h"
+#include"GraphIO.h"
+#include"Loader.h"
+#include"Memory.h"
+#include"Server.h"
+#include"SharedGraph.h"
+#include"Snapshot.h"
+
+// usage()
+// Prints the command line forms and exits.
+void usage(const char *prog) {
+    printf("Usage: %s [-s] [-M] [-L megabytes] <input file> <output file>\n", prog);
+    printf("       %s -p [-t threads] [-M] [-L megabytes] <input file> <output file>\n", prog);
+    printf("       %s -E megabytes <input file> <output file>\n", prog);
+    printf("       %s -S [-t threads] [-b batch] [-u socket] [-m segment]\n"
+           "          [-c snapshot] [-M] [-L megabytes] <graph file>\n", prog);
+    exit(1);
+}
+
+// Set by -M: print the Graph's memory use to stderr once loaded and at exit
+static int memoryReport = 0;
+
+// loaded()
+// Returns G, the Graph just loaded from file, reporting its memory use under
+// -M; exits with a message if it was refused for passing the memory budget.
+Graph loaded(Graph G, const char *file) {
+    if (G == NULL) {
+        fprintf(stderr, "Graph in %s does not fit in the memory budget of %zu MB\n", file,
+                getMemoryBudget() >> 20);
+        exit(1);
+    }
+    if (memoryReport)
+        printMemory(stderr, G);
+    return G;
+}
+
+// serve()
+// Server mode: loads the graph section of file once, then answers queries
+// from stdin, or from clients of the Unix socket at path, until closed. With
+// a segment name, attaches to the graph another worker published there
+// instead, or loads and publishes it if none has yet. With a snapshot path,
+// restores the graph from that snapshot if there is one, otherwise saves one
+// after loading.
+int serve(const char *file, const char *path, const char *segment, const char *snapshot,
+          int threads, int batch) {
+    Graph G = NULL;
+    if (segment != NULL)
+        G = attachGraph(segment);
+    if (G == NULL && snapshot != NULL) {
+        G = loadSnapshot(snapshot);
+        if (G != NULL && segment != NULL)
+            publishGraph(G, segment);
+    }
+
+    if (G == NULL) {
+        FILE *in = fopen(file, "r");
+        if (in == NULL) {
+            printf("Unable to open file %s for reading\n", file);
+            exit(1);
+        }
+        G = loaded(readGraph(in), file);
+        fclose(in);
+        if (snapshot != NULL)
+            saveSnapshot(G, snapshot, 0);
+        if (segment != NULL)
+            publishGraph(G, segment);
+    } else if (memoryReport) {
+        printMemory(stderr, G);
+    }
+
+    Server S = newServer(G, threads, batch);
+    if (path == NULL)
+        serveStream(S, STDIN_FILENO, STDOUT_FILENO);
+    else
+        serveSocket(S, path);
+
+    freeServer(&S);
+    if (memoryReport)
+        printMemory(stderr, G);
+    freeGraph(&G);
+    return 0;
+}
+
+// printQuery()
+// Writes the answer for the query from source to dest, whose distance is dist
+// and whose shortest path is L.
+void printQuery(FILE *out, Vertex source, Vertex dest, Vertex dist, List L) {
+    // Case Dest is unreachable
+    if (dist == INF) {
+        fprintf(out, "\nThe distance from %" PRIvertex " to %" PRIvertex " is infinity\n", source, dest);
+        fprintf(out, "No %" PRIvertex "-%" PRIvertex " path exists\n", source, dest);
+    }
+
+        // Case Dest is reachable
+    else {
+        fprintf(out, "\nThe distance from %" PRIvertex " to %" PRIvertex " is %" PRIvertex "\n", source, dest, dist);
+        fprintf(out, "A shortest %" PRIvertex "-%" PRIvertex " path is: ", source, dest);
+        printList(out, L);
+        fprintf(out, "\n");
+    }
+}
+
+// private DumpJob type: the adjacency dump handed to the writer thread
+typedef struct DumpJob {
+    FILE *out;
+    Graph G;
+} DumpJob;
+
+// dumpGraph()
+// Writer thread: prints the adjacency lists of the Graph.
+void *dumpGraph(void *arg) {
+    DumpJob *J = arg;
+    printGraph(J->out, J->G);
+    return NULL;
+}
+
+// pipelined()
+// Pipelined mode: loads the whole input with loadGraph(), then writes the
+// adjacency dump on a writer thread while the queries are answered into a
+// memory buffer, which follows the dump once it is done. The output is the
+// same as the sequential mode's.
+int pipelined(FILE *in, FILE *out, const char *inName, int threads) {
+    EdgeList queries;
+    Graph G = loaded(loadGraph(in, &queries, threads), inName);
+
+    DumpJob J = {out, G};
+    pthread_t writer;
+    if (pthread_create(&writer, NULL, dumpGraph, &J) != 0) {
+        printf("Unable to create writer thread\n");
+        exit(1);
+    }
+
+    char *text = NULL;
+    size_t size = 0;
+    FILE *buf = open_memstream(&text, &size);
+    Query Q = newQuery(G);
+    List L = newList();
+
+    for (EdgeIndex i = 0; i < edgeCount(queries); i++) {
+        Vertex source = edgeSource(queries, i);
+        Vertex dest = edgeTarget(queries, i);
+        queryBFS(Q, source);
+        getQueryPath(L, Q, dest);
+        printQuery(buf, source, dest, getQueryDist(Q, dest), L);
+        clear(L);
+    }
+    fclose(buf);
+
+    pthread_join(writer, NULL);
+    fwrite(text, 1, size, out);
+
+    free(text);
+    if (memoryReport)
+        printMemory(stderr, G);
+    freeList(&L);
+    freeQuery(&Q);
+    freeEdgeList(&queries);
+    freeGraph(&G);
+    return 0;
+}
+
+// external()
+// Semi-external mode: sorts the edge section into an edge file next to the
+// output, within memory megabytes, and answers queries with extBFS() while
+// keeping only per-vertex state in memory.
+int external(FILE *in, FILE *out, const char *outName, long memory) {
+    size_t bytes = (size_t) memory << 20;
+    char *path = malloc(strlen(outName) + 6);
+    sprintf(path, "%s.gadj", outName);
+
+    writeExtGraph(in, path, bytes);
+    ExtGraph X = openExtGraph(path, bytes);
+    printExtGraph(out, X);
+
+    Vertex source;
+    Vertex dest;
+    List L = newList();
+    while (readPair(in, &source, &dest)) {
+        if (source == 0 && dest == 0)
+            break;
+        extBFS(X, source);
+        getExtPath(L, X, dest);
+        printQuery(out, source, dest, getExtDist(X, dest), L);
+        clear(L);
+    }
+
+    freeList(&L);
+    freeExtGraph(&X);
+    remove(path);
+    free(path);
+    return 0;
+}
 
 int main(int argc, char *argv[]) {
     FILE *in;
     FILE *out;
+    int stats = 0;
+    int server = 0;
+    int pipeline = 0;
+    long memory = 0;
+    int threads = 0;
+    int batch = 1024;
+    long budget = 0;
+    const char *path = NULL;
+    const char *segment = NULL;
+    const char *snapshot = NULL;
+    int opt;
 
-    // Check command line for correct number of arguments
-    if (argc != 3) {
-        printf("Usage: %s <input file> <output file>\n", argv[0]);
-        exit(1);
+    // -s dumps BFS/graph statistics to stderr after each query; -S selects
+    // server mode, configured by -t, -b, -u, -m and -c; -p selects the pipelined
+    // loader, with -t builder threads; -E the semi-external mode. -M reports
+    // the Graph's memory use to stderr and -L caps it, in megabytes
+    while ((opt = getopt(argc, argv, "sSpME:L:t:b:u:m:c:")) != -1) {
+        switch (opt) {
+            case 's': stats = 1; break;
+            case 'S': server = 1; break;
+            case 'p': pipeline = 1; break;
+            case 'M': memoryReport = 1; break;
+            case 'E': memory = atol(optarg); if (memory < 1) usage(argv[0]); break;
+            case 'L': budget = atol(optarg); if (budget < 1) usage(argv[0]); break;
+            case 't': threads = atoi(optarg); break;
+            case 'b': batch = atoi(optarg); break;
+            case 'u': path = optarg; break;
+            case 'm': segment = optarg; break;
+            case 'c': snapshot = optarg; break;
+            default: usage(argv[0]);
+        }
+    }
+    setMemoryBudget((size_t) budget << 20);
+    if (server) {
+        if (argc - optind != 1 || batch < 1)
+            usage(argv[0]);
+        return serve(argv[optind], path, segment, snapshot, threads, batch);
     }
 
+    // Check command line for correct number of arguments
+    if (argc - optind != 2)
+        usage(argv[0]);
+    argv += optind - 1;
+
     // Opens file for reading
     in = fopen(argv[1], "r");
     if (in == NULL) {
@@ -30,41 +262,28 @@ int main(int argc, char *argv[]) {
         exit(1);
     }
 
-    /* Input file structure:
-     *
-     * numVert
-     * v1 v2
-     * v1 v3
-     * ....
-     * ....
-     * vn vk
-     * 0  0
-    */
-
-    // Reads in number of Vertices to expect
-    int numVert;
-    fscanf(in, "%d", &numVert);
-
-    // Creates Graph of size numVert
-    Graph G = newGraph(numVert);
-    int v;
-    int u;
-
-    // Reads incident edge list
-    while (fscanf(in, "%d %d", &v, &u) == 2) {
-        if (u == 0 && v == 0) break;
-        addEdge(G,v,u);
+    if (pipeline || memory > 0) {
+        if (pipeline)
+            pipelined(in, out, argv[1], threads);
+        else
+            external(in, out, argv[2], memory);
+        fclose(in);
+        fclose(out);
+        return 0;
     }
 
+    // Reads vertex count and edge section
+    Graph G = loaded(readGraph(in), argv[1]);
+
     // Prints out Adjacency List of Graph
     printGraph(out, G);
 
     // Processes each line with BFS
-    int source;
-    int dest;
+    Vertex source;
+    Vertex dest;
     List L = newList();
 
-    while (fscanf(in, "%d %d", &source, &dest)) {
+    while (readPair(in, &source, &dest)) {
         // Exit case to stop reading
         if (source == 0 && dest == 0)
             break;
@@ -76,24 +295,18 @@ int main(int argc, char *argv[]) {
         getPath(L, G, dest);
 
         // Stores distance
-        int dist = getDist(G, dest);
-
-        // Case Dest is unreachable
-        if (dist == INF) {
-            fprintf(out, "\nThe distance from %d to %d is infinity\n", source, dest);
-            fprintf(out, "No %d-%d path exists\n", source, dest);
-        }
+        Vertex dist = getDist(G, dest);
 
-            // Case Dest is reachable
-        else {
-            fprintf(out, "\nThe distance from %d to %d is %d\n", source, dest, dist);
-            fprintf(out, "A shortest %d-%d path is: ", source, dest);
-            printList(out, L);
-            fprintf(out, "\n");
-        }
+        printQuery(out, source, dest, dist, L);
         clear(L);
+
+        if (stats)
+            printStats(stderr, G);
     }
 
+    if (memoryReport)
+        printMemory(stderr, G);
+
     // Memory Freedom Express woo WOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOOO
     freeGraph(&G);
     freeList(&L);
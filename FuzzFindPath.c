@@ -0,0 +1,117 @@
+//-----------------------------------------------------------------------------
+// FuzzFindPath.c
+// libFuzzer target for the FindPath input parsers
+//-----------------------------------------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include "GraphIO.h"
+#include "Loader.h"
+#include "Memory.h"
+
+// Memory budget per input, so huge vertex counts fail instead of allocating
+#define FUZZ_BUDGET ((size_t) 16 << 20)
+
+// Queries answered per input
+#define FUZZ_QUERIES 64
+
+// sameAdjacency()
+// Returns true (1) if A and B store the same vertices and arcs.
+static int sameAdjacency(Graph A, Graph B) {
+    const EdgeIndex *aOffset;
+    const Vertex *aTarget;
+    const EdgeIndex *bOffset;
+    const Vertex *bTarget;
+    Vertex n = getOrder(A);
+
+    if (getOrder(B) != n || getSize(A) != getSize(B))
+        return 0;
+    getAdjacency(A, &aOffset, &aTarget);
+    getAdjacency(B, &bOffset, &bTarget);
+    return memcmp(aOffset, bOffset, sizeof(EdgeIndex) * ((size_t) n + 2)) == 0 &&
+           memcmp(aTarget, bTarget, sizeof(Vertex) * (size_t) aOffset[n + 1]) == 0;
+}
+
+// LLVMFuzzerTestOneInput()
+// Parses data as a FindPath input file with tryReadGraph() and answers its
+// queries through the status-returning functions, which must never exit. An
+// input tryReadGraph() accepts is also valid for loadGraph(), which must then
+// build the same Graph; abort() reports it if not.
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    Graph G;
+    Vertex s;
+    Vertex d;
+    Vertex dist;
+
+    if (size == 0)
+        return 0;
+    setMemoryBudget(FUZZ_BUDGET);
+
+    FILE *in = fmemopen((void *) data, size, "r");
+    if (in == NULL)
+        return 0;
+    if (tryReadGraph(in, &G) != GRAPH_OK) {
+        fclose(in);
+        return 0;
+    }
+
+    List L = newList();
+    for (int q = 0; q < FUZZ_QUERIES; q++) {
+        if (tryReadVertex(in, &s) != GRAPH_OK || tryReadVertex(in, &d) != GRAPH_OK)
+            break;
+        if (s == 0 && d == 0)
+            break;
+        if (tryBFS(G, s) != GRAPH_OK || tryGetDist(G, d, &dist) != GRAPH_OK)
+            continue;
+        if (tryGetPath(L, G, d) != GRAPH_OK || length(L) != (dist == INF ? 1 : dist + 1))
+            abort();
+        clear(L);
+    }
+    freeList(&L);
+    fclose(in);
+
+    in = fmemopen((void *) data, size, "r");
+    if (in == NULL) {
+        freeGraph(&G);
+        return 0;
+    }
+    Graph C = loadGraph(in, NULL, 2);
+    fclose(in);
+    if (C != NULL) {
+        if (!sameAdjacency(G, C))
+            abort();
+        freeGraph(&C);
+    }
+    freeGraph(&G);
+    return 0;
+}
+
+#ifdef FUZZ_STANDALONE
+// Replays each file named on the command line, e.g. a crash libFuzzer saved.
+int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        FILE *file = fopen(argv[i], "rb");
+        if (file == NULL) {
+            printf("Unable to open file %s for reading\n", argv[i]);
+            exit(1);
+        }
+
+        size_t size = 0;
+        size_t capacity = 4096;
+        uint8_t *data = malloc(capacity);
+        size_t got;
+        while ((got = fread(data + size, 1, capacity - size, file)) > 0) {
+            size += got;
+            if (size == capacity)
+                data = realloc(data, capacity *= 2);
+        }
+        fclose(file);
+
+        LLVMFuzzerTestOneInput(data, size);
+        free(data);
+        printf("%s: ok\n", argv[i]);
+    }
+    return 0;
+}
+#endif
@@ -3,44 +3,652 @@
 // Implementation file for Graph ADT
 //-----------------------------------------------------------------------------
 
+#ifdef GRAPHADT_STATS
+#define _POSIX_C_SOURCE 200809L
+#include <string.h>
+#include <time.h>
+#endif
+
+#include <pthread.h>
 #include "Graph.h"
+#include "Memory.h"
+#include "Parallel.h"
+#include "Sort.h"
+
+// Arcs below which the reverse adjacency is built on the calling thread
+#define REVERSE_SERIAL 65536
+
+// Neighbors whose distance entries queryBatch() prefetches per queued vertex;
+// a hub's remaining neighbors are left to the hardware prefetcher
+#define PREFETCH_ARCS 16
 
 // structs --------------------------------------------------------------------
 
 // private GraphObj type
 typedef struct GraphObj {
+    // Adjacency lists; NULL while the Graph exists only in compact form
     List *adjList;
 
-    int *distance;
-    int *parent;
+    // Compact copy of adjList, built lazily under compactLock so that
+    // concurrent Queries can share it
+    EdgeIndex *adjOffset;
+    Vertex *adjTarget;
+    int compact;
+    pthread_mutex_t compactLock;
+
+    // Set when the compact arrays belong to a newGraphView() owner, and
+    // called instead of free() once they are dropped
+    void (*release)(void *arg);
+    void *releaseArg;
+
+    // Transpose of the compact adjacency, built lazily under compactLock and
+    // dropped together with it
+    EdgeIndex *revOffset;
+    Vertex *revSource;
+    int reverse;
+
+    Vertex *distance;
+    Vertex *parent;
     int *color;
 
-    int order;
-    int size;
-    int source;
+    Vertex order;
+    EdgeIndex size;
+    Vertex source;
+
+    int policy;
+    EdgeIndex dropped;
+
+    // Nodes in adjList, and the bytes last charged to the memory budget
+    EdgeIndex arcs;
+    size_t charged;
+
+#ifdef GRAPHADT_STATS
+    GraphStats stats;
+    BFSStats bfs;
+    Vertex *levelSize;
+    double *levelTime;
+    Vertex levelCap;
+    Vertex curLevel;
+    double levelStart;
+    double bfsStart;
+#endif
 } GraphObj;
 
+// private QueryObj type
+typedef struct QueryObj {
+    Graph graph;
+
+    Vertex *distance;
+    Vertex *parent;
+    Vertex *queue;
+
+    // queue[0..reached-1] are the vertices the last traversal reached
+    Vertex reached;
+    Vertex source;
+} QueryObj;
+
+// private ReverseJob type: state shared by the threads of one reverse build
+typedef struct ReverseJob {
+    Vertex n;
+    const EdgeIndex *offset;
+    const Vertex *target;
+    EdgeIndex *cursor;
+    Vertex *source;
+    int phase;
+} ReverseJob;
+
+enum { PHASE_COUNT, PHASE_SCATTER, PHASE_SORT };
+
+// private Search type: one point-to-point search of a queryBatch()
+typedef struct Search {
+    Query query;
+    const EdgeIndex *offset;
+    const Vertex *target;
+    Vertex dest;
+    Vertex head;
+    Vertex tail;
+} Search;
+
+
+// Statistics hooks -----------------------------------------------------------
+// STATS(stmt) runs stmt only in GRAPHADT_STATS builds, so the hooks below cost
+// nothing otherwise.
+
+#ifdef GRAPHADT_STATS
+#define STATS(stmt) do { stmt; } while (0)
+
+// statsClock()
+// Returns a monotonic timestamp in seconds.
+// Private.
+static double statsClock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+// statsInsert()
+// Records an addArc() that stepped over scan list entries.
+// Private.
+static void statsInsert(Graph G, EdgeIndex scan) {
+    G->stats.arcsAdded++;
+    G->stats.insertScans += scan;
+    if (scan > G->stats.maxInsertScan)
+        G->stats.maxInsertScan = scan;
+}
+
+// statsBeginBFS()
+// Resets the per-BFS counters for a traversal from s.
+// Private.
+static void statsBeginBFS(Graph G, Vertex s) {
+    if (G->levelCap > 0) {
+        memset(G->levelSize, 0, sizeof(Vertex) * (size_t) G->levelCap);
+        memset(G->levelTime, 0, sizeof(double) * (size_t) G->levelCap);
+    }
+    memset(&G->bfs, 0, sizeof(BFSStats));
+    G->bfs.source = s;
+    G->stats.bfsRuns++;
+    G->curLevel = 0;
+    G->bfsStart = G->levelStart = statsClock();
+}
+
+// statsDiscover()
+// Counts one more vertex discovered at distance d, growing the per-level
+// arrays as needed.
+// Private.
+static void statsDiscover(Graph G, Vertex d) {
+    if (d >= G->levelCap) {
+        Vertex cap = G->levelCap > 0 ? G->levelCap : 64;
+        while (cap <= d)
+            cap *= 2;
+        G->levelSize = realloc(G->levelSize, sizeof(Vertex) * (size_t) cap);
+        G->levelTime = realloc(G->levelTime, sizeof(double) * (size_t) cap);
+        for (Vertex i = G->levelCap; i < cap; i++) {
+            G->levelSize[i] = 0;
+            G->levelTime[i] = 0;
+        }
+        G->levelCap = cap;
+    }
+    if (d >= G->bfs.levels)
+        G->bfs.levels = d + 1;
+    G->levelSize[d]++;
+    G->bfs.visited++;
+}
+
+// statsExpand()
+// Called as BFS starts expanding a vertex at distance d; closes the timer of
+// the previous level when d starts a new one.
+// Private.
+static void statsExpand(Graph G, Vertex d) {
+    if (d != G->curLevel) {
+        double t = statsClock();
+        G->levelTime[G->curLevel] += t - G->levelStart;
+        G->curLevel = d;
+        G->levelStart = t;
+    }
+}
+
+// statsEndBFS()
+// Closes the timers of the current BFS.
+// Private.
+static void statsEndBFS(Graph G) {
+    double t = statsClock();
+    G->levelTime[G->curLevel] += t - G->levelStart;
+    G->bfs.seconds = t - G->bfsStart;
+    G->bfs.frontier = G->levelSize;
+    G->bfs.levelSeconds = G->levelTime;
+}
+#else
+#define STATS(stmt) do { } while (0)
+#endif
+
+
+// Memory accounting ----------------------------------------------------------
+
+// compactBytes()
+// Returns the bytes of a compact adjacency of n vertices and m arcs.
+// Private.
+static size_t compactBytes(Vertex n, EdgeIndex m) {
+    return sizeof(EdgeIndex) * ((size_t) n + 2) + sizeof(Vertex) * (size_t) (m > 0 ? m : 1);
+}
+
+// measureGraph()
+// Fills *M from the current representation of G. Callers hold compactLock
+// or otherwise keep G from changing.
+// Private.
+static void measureGraph(Graph G, GraphMemory *M) {
+    size_t numTerms = (size_t) G->order + 1;
+    size_t compact = G->compact ? compactBytes(G->order, G->adjOffset[G->order + 1]) : 0;
+
+    M->adjacency = 0;
+    M->caches = 0;
+    M->mapped = 0;
+    if (G->adjList != NULL) {
+        // listMemoryFor() is linear in the length, so all lists together
+        // cost one list of every node plus the remaining empty headers
+        M->adjacency = sizeof(List) * numTerms + listMemoryFor(G->arcs)
+                       + (numTerms - 1) * listMemoryFor(0);
+        M->caches = compact;
+    } else if (G->release != NULL) {
+        M->mapped = compact;
+    } else {
+        M->adjacency = compact;
+    }
+
+    M->vertexState = sizeof(GraphObj) + numTerms * (2 * sizeof(Vertex) + sizeof(int));
+#ifdef GRAPHADT_STATS
+    M->vertexState += (size_t) G->levelCap * (sizeof(Vertex) + sizeof(double));
+#endif
+    M->indexes = G->reverse ? compactBytes(G->order, G->revOffset[G->order + 1]) : 0;
+    M->total = M->adjacency + M->vertexState + M->caches + M->indexes;
+}
+
+// rechargeGraph()
+// Brings the bytes G has charged to the memory budget up to its current
+// total. Callers hold compactLock or otherwise keep G from changing.
+// Private.
+static void rechargeGraph(Graph G) {
+    GraphMemory M;
+    measureGraph(G, &M);
+    if (M.total > G->charged)
+        chargeMemory(M.total - G->charged);
+    else
+        releaseMemory(G->charged - M.total);
+    G->charged = M.total;
+}
+
+
+// Compact adjacency ----------------------------------------------------------
+
+// releaseNothing()
+// release callback for views whose owner needs no notice.
+// Private.
+static void releaseNothing(void *arg) {
+    (void) arg;
+}
+
+// releaseCompact()
+// Frees the compact arrays of G, or hands them back to their owner.
+// Private.
+static void releaseCompact(Graph G) {
+    if (G->release != NULL) {
+        G->release(G->releaseArg);
+        G->release = NULL;
+    } else {
+        free(G->adjOffset);
+        free(G->adjTarget);
+    }
+}
+
+// dropReverse()
+// Frees the cached reverse adjacency of G, if any.
+// Private.
+static void dropReverse(Graph G) {
+    if (G->reverse) {
+        free(G->revOffset);
+        free(G->revSource);
+        G->revOffset = NULL;
+        G->revSource = NULL;
+        G->reverse = 0;
+    }
+}
+
+// dropCompact()
+// Frees the cached compact and reverse adjacency of G, if any. Called
+// whenever the adjacency lists change, after ensureLists().
+// Private.
+static void dropCompact(Graph G) {
+    dropReverse(G);
+    if (G->compact && G->adjList != NULL) {
+        releaseCompact(G);
+        G->adjOffset = NULL;
+        G->adjTarget = NULL;
+        G->compact = 0;
+        rechargeGraph(G);
+    }
+}
+
+// buildCompact()
+// Builds the compact adjacency of G from its adjacency lists.
+// Private.
+static void buildCompact(Graph G) {
+    EdgeIndex *offset = malloc(sizeof(EdgeIndex) * ((size_t) G->order + 2));
+
+    offset[0] = 0;
+    offset[1] = 0;
+    for (Vertex u = 1; u <= G->order; u++)
+        offset[u + 1] = offset[u] + length(G->adjList[u]);
+
+    Vertex *target = malloc(sizeof(Vertex) * (size_t) (offset[G->order + 1] > 0 ? offset[G->order + 1] : 1));
+    for (Vertex u = 1; u <= G->order; u++)
+        toArray(G->adjList[u], target + offset[u]);
+
+    G->adjOffset = offset;
+    G->adjTarget = target;
+}
+
+// ensureCompact()
+// Builds the compact adjacency of G unless it is already current. Safe to
+// call from several threads at once on an unmodified Graph.
+// Private.
+static void ensureCompact(Graph G) {
+    if (__atomic_load_n(&G->compact, __ATOMIC_ACQUIRE))
+        return;
+
+    pthread_mutex_lock(&G->compactLock);
+    if (!G->compact) {
+        buildCompact(G);
+        __atomic_store_n(&G->compact, 1, __ATOMIC_RELEASE);
+        rechargeGraph(G);
+    }
+    pthread_mutex_unlock(&G->compactLock);
+}
+
+// reverseRange()
+// Runs the current phase of J over sources (count and scatter) or targets
+// (sort) lo..hi-1. Arcs land in each in-list in whatever order threads reach
+// them, so the lists are sorted afterwards.
+// Private.
+static void reverseRange(EdgeIndex lo, EdgeIndex hi, int tid, void *arg) {
+    ReverseJob *J = arg;
+    (void) tid;
+
+    for (Vertex u = (Vertex) lo; u < hi; u++) {
+        switch (J->phase) {
+            case PHASE_COUNT:
+                for (EdgeIndex e = J->offset[u]; e < J->offset[u + 1]; e++)
+                    __atomic_fetch_add(&J->cursor[J->target[e] + 1], 1, __ATOMIC_RELAXED);
+                break;
+            case PHASE_SCATTER:
+                for (EdgeIndex e = J->offset[u]; e < J->offset[u + 1]; e++)
+                    J->source[__atomic_fetch_add(&J->cursor[J->target[e] + 1], 1, __ATOMIC_RELAXED)] = u;
+                break;
+            case PHASE_SORT:
+                sortVertices(J->source + J->cursor[u], J->cursor[u + 1] - J->cursor[u]);
+                break;
+        }
+    }
+}
+
+// buildReverse()
+// Builds the reverse adjacency of G from its compact adjacency: in-degrees
+// counted one slot up, so that after a prefix sum offset[v + 1] is v's start
+// and serves as its cursor, ending at v + 1's start as each arc is placed.
+// Large graphs are built with parallelFor() on defaultThreads() threads;
+// small ones serially, where scanning sources in order leaves every in-list
+// sorted already.
+// Private.
+static void buildReverse(Graph G) {
+    Vertex n = G->order;
+    EdgeIndex m = G->adjOffset[n + 1];
+    EdgeIndex *offset = calloc((size_t) n + 2, sizeof(EdgeIndex));
+    Vertex *source = malloc(sizeof(Vertex) * (size_t) (m > 0 ? m : 1));
+    int threads = m < REVERSE_SERIAL ? 1 : defaultThreads();
+
+    if (threads == 1) {
+        for (EdgeIndex e = 0; e < m; e++)
+            offset[G->adjTarget[e] + 1]++;
+        prefixSum(offset, (EdgeIndex) n + 2, 1);
+
+        for (Vertex u = 1; u <= n; u++)
+            for (EdgeIndex e = G->adjOffset[u]; e < G->adjOffset[u + 1]; e++)
+                source[offset[G->adjTarget[e] + 1]++] = u;
+    } else {
+        ReverseJob J;
+        J.n = n;
+        J.offset = G->adjOffset;
+        J.target = G->adjTarget;
+        J.cursor = offset;
+        J.source = source;
+        int phases[] = { PHASE_COUNT, PHASE_SCATTER, PHASE_SORT };
+        for (int i = 0; i < 3; i++) {
+            if (phases[i] == PHASE_SCATTER)
+                prefixSum(offset, (EdgeIndex) n + 2, threads);
+            // Sources weigh their out-degree, targets (once scattered, the
+            // cursors are their offsets) their in-degree
+            J.phase = phases[i];
+            parallelFor(1, (EdgeIndex) n + 1, phases[i] == PHASE_SORT ? offset : G->adjOffset, 0,
+                        reverseRange, &J, threads);
+        }
+    }
+
+    G->revOffset = offset;
+    G->revSource = source;
+}
+
+// ensureReverse()
+// Builds the compact and reverse adjacency of G unless already current. Safe
+// to call from several threads at once on an unmodified Graph.
+// Private.
+static void ensureReverse(Graph G) {
+    ensureCompact(G);
+    if (__atomic_load_n(&G->reverse, __ATOMIC_ACQUIRE))
+        return;
+
+    pthread_mutex_lock(&G->compactLock);
+    if (!G->reverse) {
+        buildReverse(G);
+        __atomic_store_n(&G->reverse, 1, __ATOMIC_RELEASE);
+        rechargeGraph(G);
+    }
+    pthread_mutex_unlock(&G->compactLock);
+}
+
+// ensureLists()
+// Gives a Graph created by newGraphCompact() adjacency lists, copied from its
+// compact adjacency (or empty if copy is false), so that it can be modified.
+// Private.
+static void ensureLists(Graph G, int copy) {
+    if (G->adjList != NULL)
+        return;
+
+    G->adjList = malloc(sizeof(List) * ((size_t) G->order + 1));
+    for (Vertex u = 0; u <= G->order; u++) {
+        G->adjList[u] = newList();
+        if (copy && u > 0)
+            for (EdgeIndex e = G->adjOffset[u]; e < G->adjOffset[u + 1]; e++)
+                append(G->adjList[u], G->adjTarget[e]);
+    }
+    G->arcs = copy ? G->adjOffset[G->order + 1] : 0;
+    rechargeGraph(G);
+}
+
+
+// Traversal kernels ----------------------------------------------------------
+
+// traverse()
+// Runs BFS from s over the compact adjacency of G, writing into the caller's
+// distance and parent arrays (and color, unless NULL), which must already be
+// reset. Vertices at distance limit are reached but not expanded. queue needs
+// room for getOrder(G) vertices and ends up holding every reached vertex in
+// BFS order; returns how many there are. Reads nothing but the immutable
+// compact adjacency, so any number of traversals with private arrays can run
+// at once. record is true only for BFS(), whose statistics live in G.
+// Private.
+static Vertex traverse(Graph G, Vertex s, Vertex *distance, Vertex *parent, int *color,
+                       Vertex *queue, Vertex limit, int record) {
+    const EdgeIndex *offset = G->adjOffset;
+    const Vertex *target = G->adjTarget;
+    Vertex head = 0;
+    Vertex tail = 0;
+
+    // Initializes Source
+    distance[s] = 0;
+    if (color != NULL)
+        color[s] = GRAY;
+    if (record)
+        STATS(statsDiscover(G, 0));
+    queue[tail++] = s;
+
+    // While there are Vertices in the Queue, keep iterating
+    while (head != tail) {
+        Vertex u = queue[head++];
+
+        // The queue is in level order, so everything left is at the limit too
+        if (distance[u] == limit)
+            break;
+        if (record) {
+            STATS(statsExpand(G, distance[u]));
+            STATS(G->bfs.edgesScanned += offset[u + 1] - offset[u]);
+        }
+
+        // Iterates through u's adjacency range
+        for (EdgeIndex e = offset[u]; e < offset[u + 1]; e++) {
+            Vertex v = target[e];
+
+            // If not yet visited
+            if (distance[v] == INF) {
+                distance[v] = distance[u] + 1;
+                parent[v] = u;
+                if (color != NULL)
+                    color[v] = GRAY;
+                queue[tail++] = v;
+                if (record)
+                    STATS(statsDiscover(G, distance[v]));
+            }
+        }
+        // Done processing value from Queue, so color Black
+        if (color != NULL)
+            color[u] = BLACK;
+    }
+    return tail;
+}
+
+// resetQuery()
+// Restores the INF distances and NIL parents of the vertices Q's previous
+// traversal reached, which are the only ones it changed, so a query costs
+// time in proportion to what it explores rather than to the whole Graph.
+// Private.
+static void resetQuery(Query Q) {
+    for (Vertex i = 0; i < Q->reached; i++) {
+        Q->distance[Q->queue[i]] = INF;
+        Q->parent[Q->queue[i]] = NIL;
+    }
+    Q->reached = 0;
+}
+
+// searchStep()
+// Expands the next queued vertex of S, stopping at S's destination. Ahead of
+// it, each queued vertex passes through three prefetch stages, one per step:
+// its offsets, then its first targets, then the distance entries of those
+// targets, so the expansion finds them in cache. Returns false (0) once S is
+// finished, with its Query's reached count set.
+// Private.
+static int searchStep(Search *S) {
+    const EdgeIndex *offset = S->offset;
+    const Vertex *target = S->target;
+    Vertex *queue = S->query->queue;
+    Vertex *distance = S->query->distance;
+    Vertex *parent = S->query->parent;
+
+    if (S->head + 3 < S->tail)
+        __builtin_prefetch(&offset[queue[S->head + 3]]);
+    if (S->head + 2 < S->tail)
+        __builtin_prefetch(&target[offset[queue[S->head + 2]]]);
+    if (S->head + 1 < S->tail) {
+        Vertex w = queue[S->head + 1];
+        EdgeIndex end = offset[w + 1] - offset[w] < PREFETCH_ARCS ? offset[w + 1] : offset[w] + PREFETCH_ARCS;
+        for (EdgeIndex e = offset[w]; e < end; e++)
+            __builtin_prefetch(&distance[target[e]], 1);
+    }
+
+    Vertex u = queue[S->head++];
+    for (EdgeIndex e = offset[u]; e < offset[u + 1]; e++) {
+        Vertex v = target[e];
+        if (distance[v] == INF) {
+            distance[v] = distance[u] + 1;
+            parent[v] = u;
+            queue[S->tail++] = v;
+            if (v == S->dest) {
+                S->head = S->tail;
+                break;
+            }
+        }
+    }
+
+    if (S->head < S->tail)
+        return 1;
+    S->query->reached = S->tail;
+    return 0;
+}
+
+// appendTreePath()
+// Appends to L the path from source to u recorded in distance/parent, or NIL
+// if u was not reached. Shared by getPath(), getQueryPath() and getExtPath().
+void appendTreePath(List L, const Vertex *distance, const Vertex *parent, Vertex source, Vertex u) {
+    // Break Case: Vertex is unreachable from source
+    if (u != source && parent[u] == NIL) {
+        append(L, NIL);
+        return;
+    }
+
+    // Climbs back up towards source, filling the path back to front. Iterative
+    // so that long paths (e.g. a chain graph) cannot overflow the stack.
+    Vertex len = distance[u] + 1;
+    Vertex *path = malloc(sizeof(Vertex) * (size_t) len);
+    Vertex x = u;
+    for (Vertex i = len - 1; i >= 0; i--) {
+        path[i] = x;
+        x = parent[x];
+    }
+
+    for (Vertex i = 0; i < len; i++)
+        append(L, path[i]);
+    free(path);
+}
+
 
 // Constructors-Destructors ---------------------------------------------------
 
-// newGraph()
-// Returns a Graph pointing to a newly created GraphObj with n vertices.
-Graph newGraph(int n) {
-    int numTerms = n + 1;
+// tryAllocGraph()
+// Returns a GraphObj with n vertices, initialized BFS state and no adjacency,
+// or NULL if it cannot be allocated.
+// Private.
+static Graph tryAllocGraph(Vertex n) {
+    size_t numTerms = (size_t) n + 1;
 
     Graph G = malloc(sizeof(GraphObj));
+    if (G == NULL)
+        return NULL;
+
+    G->adjList = NULL;
+    G->distance = malloc(sizeof(Vertex) * numTerms);
+    G->parent = malloc(sizeof(Vertex) * numTerms);
+    G->color = malloc(sizeof(int) * numTerms);
+    if (G->distance == NULL || G->parent == NULL || G->color == NULL) {
+        free(G->distance);
+        free(G->parent);
+        free(G->color);
+        free(G);
+        return NULL;
+    }
 
-    G->adjList = malloc(sizeof(List) * (numTerms));
-    G->distance = malloc(sizeof(int) * (numTerms));
-    G->parent = malloc(sizeof(int) * (numTerms));
-    G->color = malloc(sizeof(int) * (numTerms));
+    G->adjOffset = NULL;
+    G->adjTarget = NULL;
+    G->compact = 0;
+    pthread_mutex_init(&G->compactLock, NULL);
+    G->release = NULL;
+    G->releaseArg = NULL;
+    G->revOffset = NULL;
+    G->revSource = NULL;
+    G->reverse = 0;
 
     G->order = n;
     G->size = 0;
     G->source = NIL;
+    G->policy = EDGES_MULTI;
+    G->dropped = 0;
+    G->arcs = 0;
+    G->charged = 0;
 
-    for (int i = 0; i < numTerms; i++) {
-        G->adjList[i] = newList();
+#ifdef GRAPHADT_STATS
+    memset(&G->stats, 0, sizeof(GraphStats));
+    memset(&G->bfs, 0, sizeof(BFSStats));
+    G->levelSize = NULL;
+    G->levelTime = NULL;
+    G->levelCap = 0;
+#endif
+
+    for (size_t i = 0; i < numTerms; i++) {
         G->distance[i] = INF;
         G->parent[i] = NIL;
         G->color[i] = WHITE;
@@ -49,6 +657,83 @@ Graph newGraph(int n) {
     return (G);
 }
 
+// allocGraph()
+// tryAllocGraph() for the constructors that exit on failure.
+// Private.
+static Graph allocGraph(Vertex n) {
+    Graph G = tryAllocGraph(n);
+    if (G == NULL) {
+        printf("Graph Error: unable to allocate a Graph with %" PRIvertex " vertices\n", n);
+        exit(1);
+    }
+    return (G);
+}
+
+// newGraph()
+// Returns a Graph pointing to a newly created GraphObj with n vertices.
+// Precondition: 0 <= n < VERTEX_MAX
+Graph newGraph(Vertex n) {
+    if (n < 0 || n >= VERTEX_MAX) {
+        printf("Graph Error: newGraph() called with order outside supported vertex range\n");
+        exit(1);
+    }
+
+    Graph G = allocGraph(n);
+    ensureLists(G, 0);
+    return (G);
+}
+
+// newGraphCompact()
+// Returns a Graph with n vertices whose adjacency is given in compact form.
+// The Graph takes ownership of offset and target.
+// Precondition: 0 <= n < VERTEX_MAX
+Graph newGraphCompact(Vertex n, EdgeIndex *offset, Vertex *target, EdgeIndex size) {
+    if (n < 0 || n >= VERTEX_MAX) {
+        printf("Graph Error: newGraphCompact() called with order outside supported vertex range\n");
+        exit(1);
+    }
+    if (offset == NULL || target == NULL) {
+        printf("Graph Error: newGraphCompact() called on NULL adjacency arrays\n");
+        exit(1);
+    }
+
+    Graph G = allocGraph(n);
+    G->adjOffset = offset;
+    G->adjTarget = target;
+    G->compact = 1;
+    G->size = size;
+    rechargeGraph(G);
+    return (G);
+}
+
+// newGraphView()
+// Returns a Graph with n vertices over compact adjacency it does not own.
+// release(arg) is called when the Graph drops the arrays.
+// Precondition: 0 <= n < VERTEX_MAX
+Graph newGraphView(Vertex n, const EdgeIndex *offset, const Vertex *target, EdgeIndex size,
+                   void (*release)(void *arg), void *arg) {
+    if (n < 0 || n >= VERTEX_MAX) {
+        printf("Graph Error: newGraphView() called with order outside supported vertex range\n");
+        exit(1);
+    }
+    if (offset == NULL || target == NULL) {
+        printf("Graph Error: newGraphView() called on NULL adjacency arrays\n");
+        exit(1);
+    }
+
+    // The arrays are only ever read; a modification copies them into lists
+    // and drops them first
+    Graph G = allocGraph(n);
+    G->adjOffset = (EdgeIndex *) offset;
+    G->adjTarget = (Vertex *) target;
+    G->compact = 1;
+    G->size = size;
+    G->release = release != NULL ? release : releaseNothing;
+    G->releaseArg = arg;
+    rechargeGraph(G);
+    return (G);
+}
+
 // freeGraph()
 // Frees all dynamic memory associated with the Graph *pG, then sets the handle
 // *pG to NULL.
@@ -58,13 +743,22 @@ void freeGraph(Graph *pG) {
         exit(1);
     }
 
-    for (int i = 0; i < getOrder(*pG) + 1; i++)
-        freeList(&(*pG)->adjList[i]);
+    if ((*pG)->adjList != NULL)
+        for (Vertex i = 0; i <= getOrder(*pG); i++)
+            freeList(&(*pG)->adjList[i]);
 
     free((*pG)->adjList);
+    releaseMemory((*pG)->charged);
+    releaseCompact(*pG);
+    dropReverse(*pG);
+    pthread_mutex_destroy(&(*pG)->compactLock);
     free((*pG)->distance);
     free((*pG)->parent);
     free((*pG)->color);
+#ifdef GRAPHADT_STATS
+    free((*pG)->levelSize);
+    free((*pG)->levelTime);
+#endif
 
     free(*pG);
     *pG = NULL;
@@ -75,7 +769,7 @@ void freeGraph(Graph *pG) {
 
 // getOrder()
 // Returns the order of Graph G.
-int getOrder(Graph G) {
+Vertex getOrder(Graph G) {
     if (G == NULL) {
         printf("Graph Error: getOrder() called on NULL Graph reference\n");
         exit(1);
@@ -85,7 +779,7 @@ int getOrder(Graph G) {
 
 // getSize()
 // Returns the size of the graph G.
-int getSize(Graph G) {
+EdgeIndex getSize(Graph G) {
     if (G == NULL) {
         printf("Graph Error: getSize() called on NULL Graph reference\n");
         exit(1);
@@ -95,7 +789,7 @@ int getSize(Graph G) {
 
 // getSource()
 // Returns the source vertex most recently used in function BFS() otherwise NIL.
-int getSource(Graph G) {
+Vertex getSource(Graph G) {
     if (G == NULL) {
         printf("Graph Error: getSource() called on NULL Graph reference\n");
         exit(1);
@@ -106,7 +800,7 @@ int getSource(Graph G) {
 // getParent()
 // Returns the parent of vertex u in BFS Tree.
 // Precondition: 1 <= u <= getOrder(G)
-int getParent(Graph G, int u) {
+Vertex getParent(Graph G, Vertex u) {
     if (G == NULL) {
         printf("Graph Error: getParent() called on NULL Graph reference\n");
         exit(1);
@@ -118,11 +812,66 @@ int getParent(Graph G, int u) {
     return G->parent[u];
 }
 
+// getAdjacency()
+// Sets *offset and *target to the compact (CSR) copy of G's adjacency lists,
+// building it first if G changed since it was last requested.
+void getAdjacency(Graph G, const EdgeIndex **offset, const Vertex **target) {
+    if (G == NULL) {
+        printf("Graph Error: getAdjacency() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (offset == NULL || target == NULL) {
+        printf("Graph Error: getAdjacency() called on NULL output reference\n");
+        exit(1);
+    }
+
+    ensureCompact(G);
+
+    *offset = G->adjOffset;
+    *target = G->adjTarget;
+}
+
+// getReverseAdjacency()
+// Sets *offset and *source to the compact in-adjacency of G, building it
+// first if G changed since it was last requested.
+void getReverseAdjacency(Graph G, const EdgeIndex **offset, const Vertex **source) {
+    if (G == NULL) {
+        printf("Graph Error: getReverseAdjacency() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (offset == NULL || source == NULL) {
+        printf("Graph Error: getReverseAdjacency() called on NULL output reference\n");
+        exit(1);
+    }
+
+    ensureReverse(G);
+
+    *offset = G->revOffset;
+    *source = G->revSource;
+}
+
+// getInDegree()
+// Returns the number of arcs into u.
+// Precondition: 1 <= u <= getOrder(G)
+EdgeIndex getInDegree(Graph G, Vertex u) {
+    if (G == NULL) {
+        printf("Graph Error: getInDegree() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (u < 1 || u > getOrder(G)) {
+        printf("Graph Error: getInDegree() called on vertex outside range of Graph\n");
+        exit(1);
+    }
+
+    ensureReverse(G);
+    return G->revOffset[u + 1] - G->revOffset[u];
+}
+
 // getDist()
 // Returns the distance from the most recent BFS source to vertex u, or INF
 // if BFS() has not been called yet.
 // Precondition: 1 <= u <= getOrder(G)
-int getDist(Graph G, int u) {
+Vertex getDist(Graph G, Vertex u) {
     if (G == NULL) {
         printf("Graph Error: getDist() called on NULL Graph reference\n");
         exit(1);
@@ -138,12 +887,32 @@ int getDist(Graph G, int u) {
         return G->distance[u];
 }
 
+// getEdgePolicy()
+// Returns the edge policy addEdge() and addArc() apply to G.
+int getEdgePolicy(Graph G) {
+    if (G == NULL) {
+        printf("Graph Error: getEdgePolicy() called on NULL Graph reference\n");
+        exit(1);
+    }
+    return G->policy;
+}
+
+// getDroppedEdges()
+// Returns the number of edges G's edge policy has refused.
+EdgeIndex getDroppedEdges(Graph G) {
+    if (G == NULL) {
+        printf("Graph Error: getDroppedEdges() called on NULL Graph reference\n");
+        exit(1);
+    }
+    return G->dropped;
+}
+
 // getPath()
 // Appends to the List L the vertices of a shortest path in G from source to u
 // or appends to L the value NIL if no such path exists.
 // BFS() must have been called prior on G
 // Precondition: 1 <= u <= getOrder(G), getSource(G) != NIL
-void getPath(List L, Graph G, int u) {
+void getPath(List L, Graph G, Vertex u) {
     if (L == NULL) {
         printf("Graph Error: getPath() called on NULL List reference\n");
         exit(1);
@@ -161,37 +930,7 @@ void getPath(List L, Graph G, int u) {
         exit(1);
     }
 
-    // Base Case: Reaches Source
-    if (u == G->source)
-        append(L, u);
-
-        // Break Case: Vertex is unreachable from source
-    else if (G->parent[u] == NIL)
-        append(L, NIL);
-
-        // Climbs back up towards source
-    else {
-        getPath(L, G, G->parent[u]);
-        append(L, u);
-    }
-
-
-    // Iterative solution to getPath()
-    // TODO: THIS IS INCORRECT WHEN LIST IS NOT CLEARED
-    /*if (G->parent[u] == NIL)
-	prepend(L, NIL);
-
-    else {
-	int x = u;
-
-	// Prepends all but S to list
-	while (x != G->source) {
-	    prepend(L, x);
-	    x = G->parent[x];
-	}
-	// Prepends S to list
-	prepend(L, x);
-    }*/
+    appendTreePath(L, G->distance, G->parent, G->source, u);
 }
 
 
@@ -205,7 +944,10 @@ void makeNull(Graph G) {
         exit(1);
     }
 
-    for (int i = 1; i < getOrder(G) + 1; i++) {
+    ensureLists(G, 0);
+    dropCompact(G);
+
+    for (Vertex i = 1; i <= getOrder(G); i++) {
         clear(G->adjList[i]);
         G->distance[i] = INF;
         G->parent[i] = NIL;
@@ -213,14 +955,96 @@ void makeNull(Graph G) {
     }
     G->source = NIL;
     G->size = 0;
+    G->dropped = 0;
+    G->arcs = 0;
+    rechargeGraph(G);
 
     // Leaves Order intact because Graph is just broken into components now
 }
 
+// setEdgePolicy()
+// Sets the edge policy for later insertions into G.
+void setEdgePolicy(Graph G, int policy) {
+    if (G == NULL) {
+        printf("Graph Error: setEdgePolicy() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (policy & ~(EDGES_DEDUP | EDGES_NO_LOOPS)) {
+        printf("Graph Error: setEdgePolicy() called with unknown policy\n");
+        exit(1);
+    }
+    G->policy = policy;
+}
+
+// addDroppedEdges()
+// Adds count to G's dropped edge tally.
+void addDroppedEdges(Graph G, EdgeIndex count) {
+    if (G == NULL) {
+        printf("Graph Error: addDroppedEdges() called on NULL Graph reference\n");
+        exit(1);
+    }
+    G->dropped += count;
+}
+
+// insertArc()
+// Inserts v into u's sorted adjacency list, unless G deduplicates and v is
+// already there. Returns true (1) if v was inserted. Does not count size.
+// Private.
+static int insertArc(Graph G, Vertex u, Vertex v) {
+    EdgeIndex scanned;
+
+    if (!insertSorted(G->adjList[u], v, G->policy & EDGES_DEDUP, &scanned))
+        return 0;
+
+    // Entries stepped over to find the insertion point
+    STATS(statsInsert(G, scanned));
+    G->arcs++;
+    return 1;
+}
+
+// linkEdge()
+// Body of addEdge() once u and v are known to be in range.
+// Private.
+static void linkEdge(Graph G, Vertex u, Vertex v) {
+    if (u == v && (G->policy & EDGES_NO_LOOPS)) {
+        G->dropped++;
+        return;
+    }
+
+    ensureLists(G, 1);
+    dropCompact(G);
+
+    // Both directions go in, but they make a single edge
+    int inserted = insertArc(G, u, v);
+    inserted |= insertArc(G, v, u);
+    if (inserted)
+        G->size++;
+    else
+        G->dropped++;
+}
+
+// linkArc()
+// Body of addArc() once u and v are known to be in range.
+// Private.
+static void linkArc(Graph G, Vertex u, Vertex v) {
+    if (u == v && (G->policy & EDGES_NO_LOOPS)) {
+        G->dropped++;
+        return;
+    }
+
+    ensureLists(G, 1);
+    dropCompact(G);
+
+    if (insertArc(G, u, v))
+        G->size++;
+    else
+        G->dropped++;
+}
+
 // addEdge()
 // Inserts a new edge joining u to v.
 // Precondition: 1 <= u, v <= getOrder(G)
-void addEdge(Graph G, int u, int v) {
+void addEdge(Graph G, Vertex u, Vertex v) {
     if (G == NULL) {
         printf("Graph Error: addEdge() called on NULL Graph reference\n");
         exit(1);
@@ -233,18 +1057,14 @@ void addEdge(Graph G, int u, int v) {
         printf("Graph Error: addEdge() called on vertex v outside range of Graph\n");
         exit(1);
     }
-    addArc(G, u, v);
-    addArc(G, v, u);
 
-    // Decrements because addArc() increments each time but this
-    // should only be 1 edge in size
-    G->size--;
+    linkEdge(G, u, v);
 }
 
 // addArc()
 // Inserts a new directed edge from u to v.
 // Precondition: 1 <= u, v <= getOrder(G)
-void addArc(Graph G, int u, int v) {
+void addArc(Graph G, Vertex u, Vertex v) {
     if (G == NULL) {
         printf("Graph Error: addArc() called on NULL Graph reference\n");
         exit(1);
@@ -258,105 +1078,646 @@ void addArc(Graph G, int u, int v) {
         exit(1);
     }
 
-    // Moves iterator
-    moveFront(G->adjList[u]);
-    // While iterator is inbounds and has not reached/passed v yet
-    while (index1(G->adjList[u]) > -1 && v > get(G->adjList[u]))
-        moveNext(G->adjList[u]);
+    linkArc(G, u, v);
+}
 
-    // Adds to the end because falls off the back
-    if (index1(G->adjList[u]) == -1)
-        append(G->adjList[u], v);
-        // Inserts before because cursor is currently on value greater than u
-    else
-        insertBefore(G->adjList[u], v);
+// runBFS()
+// Body of BFS() once s is known to be in range.
+// Private.
+static void runBFS(Graph G, Vertex s) {
+    // Sets BFS Source
+    G->source = s;
+    STATS(statsBeginBFS(G, s));
+
+    // Initializes all values to default conditions
+    for (Vertex i = 1; i <= G->order; i++) {
+        G->distance[i] = INF;
+        G->parent[i] = NIL;
+        G->color[i] = WHITE;
+    }
+
+    // Traverses the compact adjacency with an array queue
+    ensureCompact(G);
+    Vertex *queue = malloc(sizeof(Vertex) * ((size_t) G->order + 1));
+    traverse(G, s, G->distance, G->parent, G->color, queue, INF, 1);
+    free(queue);
 
-    G->size++;
+    STATS(statsEndBFS(G));
 }
 
 // BFS()
 // Runs the BFS algorithm on the Graph G with source s, setting color,
 // distance, parent and source fields of G accordingly.
-void BFS(Graph G, int s) {
+void BFS(Graph G, Vertex s) {
     if (G == NULL) {
         printf("Graph Error: BFS() called on NULL Graph reference\n");
         exit(1);
     }
+    if (s < 1 || s > getOrder(G)) {
+        printf("Graph Error: BFS() called on vertex outside range of Graph\n");
+        exit(1);
+    }
 
-    // Reference Vertices
-    int u;
-    int v;
+    runBFS(G, s);
+}
+
+// restoreBFS()
+// Copies in the distances and parents of an earlier BFS from s.
+// Precondition: 1 <= s <= getOrder(G)
+void restoreBFS(Graph G, Vertex s, const Vertex *distance, const Vertex *parent) {
+    if (G == NULL) {
+        printf("Graph Error: restoreBFS() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (s < 1 || s > getOrder(G)) {
+        printf("Graph Error: restoreBFS() called on vertex outside range of Graph\n");
+        exit(1);
+    }
+    if (distance == NULL || parent == NULL) {
+        printf("Graph Error: restoreBFS() called on NULL result arrays\n");
+        exit(1);
+    }
 
-    // Sets BFS Source
     G->source = s;
+    for (Vertex i = 1; i <= G->order; i++) {
+        G->distance[i] = distance[i];
+        G->parent[i] = parent[i];
+        G->color[i] = distance[i] == INF ? WHITE : BLACK;
+    }
+}
 
-    // Initializes all values to default conditions
-    for (int i = 1; i < getOrder(G) + 1; i++) {
-        G->distance[i] = INF;
-        G->parent[i] = NIL;
-        G->color[i] = WHITE;
+
+// Other Functions ------------------------------------------------------------
+
+// printGraph()
+// Prints the adjacency list representation of G to the file pointed to by out.
+void printGraph(FILE *out, Graph G) {
+    if (out == NULL) {
+        printf("Graph Error: printGraph() called on NULL FILE reference\n");
+        exit(1);
+    }
+    if (G == NULL) {
+        printf("Graph Error: printGraph() called on NULL Graph reference\n");
+        exit(1);
     }
 
-    // Initializes Source
-    G->color[s] = GRAY;
-    G->distance[s] = 0;
-    G->parent[s] = NIL;
+    // Iterates through and writes Graph out from the compact adjacency,
+    // which every Graph can provide and concurrent Queries also read
+    ensureCompact(G);
+    for (Vertex i = 1; i <= getOrder(G); i++) {
+        fprintf(out, "%" PRIvertex ": ", i);
+        for (EdgeIndex e = G->adjOffset[i]; e < G->adjOffset[i + 1]; e++)
+            fprintf(out, "%" PRIvertex " ", G->adjTarget[e]);
+        fprintf(out, "\n");
+    }
+}
 
-    // Creates Queue of Vertices to iterate through starting with source
-    List Queue = newList();
-    append(Queue, s);
+// Queries --------------------------------------------------------------------
 
-    // While there are Vertices in the Queue, keep iterating
-    while (length(Queue) != 0) {
-        // Fetches and removes next value in Queue
-        u = front(Queue);
-        deleteFront(Queue);
+// newQuery()
+// Returns a traversal context for BFS queries against G.
+Query newQuery(Graph G) {
+    if (G == NULL) {
+        printf("Graph Error: newQuery() called on NULL Graph reference\n");
+        exit(1);
+    }
 
-        // Focuses cursor on u's adjacency list
-        moveFront(G->adjList[u]);
+    size_t numTerms = (size_t) G->order + 1;
+    Query Q = malloc(sizeof(QueryObj));
 
-        // Iterates through u's adj list
-        while (index1(G->adjList[u]) != -1) {
-            v = get(G->adjList[u]);
+    Q->graph = G;
+    Q->distance = malloc(sizeof(Vertex) * numTerms);
+    Q->parent = malloc(sizeof(Vertex) * numTerms);
+    Q->queue = malloc(sizeof(Vertex) * numTerms);
+    Q->reached = 0;
+    Q->source = NIL;
 
-            // If not yet visited
-            if (G->color[v] == WHITE) {
-                G->distance[v] = G->distance[u] + 1;
-                G->parent[v] = u;
-                G->color[v] = GRAY;
-                append(Queue, v);
+    for (size_t i = 0; i < numTerms; i++) {
+        Q->distance[i] = INF;
+        Q->parent[i] = NIL;
+    }
+
+    // Built here rather than in queryBFS() so first queries don't contend
+    ensureCompact(G);
+    return Q;
+}
+
+// freeQuery()
+// Frees all heap memory associated with *pQ, and sets *pQ to NULL.
+void freeQuery(Query *pQ) {
+    if (pQ == NULL || *pQ == NULL) {
+        printf("Graph Error: freeQuery() called on NULL Query reference\n");
+        exit(1);
+    }
+
+    free((*pQ)->distance);
+    free((*pQ)->parent);
+    free((*pQ)->queue);
+    free(*pQ);
+    *pQ = NULL;
+}
+
+// queryGraph()
+// Returns the Graph Q runs against.
+Graph queryGraph(Query Q) {
+    if (Q == NULL) {
+        printf("Graph Error: queryGraph() called on NULL Query reference\n");
+        exit(1);
+    }
+    return Q->graph;
+}
+
+// runQuery()
+// Body of queryBFS() once s is known to be in range.
+// Private.
+static void runQuery(Query Q, Vertex s) {
+    ensureCompact(Q->graph);
+    resetQuery(Q);
+    Q->source = s;
+    Q->reached = traverse(Q->graph, s, Q->distance, Q->parent, NULL, Q->queue, INF, 0);
+}
+
+// queryBFS()
+// Runs BFS from s on Q's Graph, storing the results in Q only.
+// Precondition: 1 <= s <= getOrder(queryGraph(Q))
+void queryBFS(Query Q, Vertex s) {
+    if (Q == NULL) {
+        printf("Graph Error: queryBFS() called on NULL Query reference\n");
+        exit(1);
+    }
+    if (s < 1 || s > Q->graph->order) {
+        printf("Graph Error: queryBFS() called on vertex outside range of Graph\n");
+        exit(1);
+    }
+
+    runQuery(Q, s);
+}
+
+// queryKHop()
+// Runs BFS from s that stops expanding at depth k, touching only the
+// vertices it reaches.
+// Precondition: 1 <= s <= getOrder(queryGraph(Q)), k >= 0
+Vertex queryKHop(Query Q, Vertex s, Vertex k, Vertex *out, Vertex capacity, Vertex *levelStart) {
+    if (Q == NULL) {
+        printf("Graph Error: queryKHop() called on NULL Query reference\n");
+        exit(1);
+    }
+    if (s < 1 || s > Q->graph->order) {
+        printf("Graph Error: queryKHop() called on vertex outside range of Graph\n");
+        exit(1);
+    }
+    if (k < 0) {
+        printf("Graph Error: queryKHop() called with negative depth\n");
+        exit(1);
+    }
+
+    // No vertex is further than getOrder() - 1 hops, and k + 1 must not overflow
+    if (k >= Q->graph->order)
+        k = Q->graph->order - 1;
+
+    ensureCompact(Q->graph);
+    resetQuery(Q);
+    Q->source = s;
+    Q->reached = traverse(Q->graph, s, Q->distance, Q->parent, NULL, Q->queue, k, 0);
+
+    Vertex count = Q->reached < capacity ? Q->reached : capacity;
+    for (Vertex i = 0; i < count; i++)
+        out[i] = Q->queue[i];
+
+    // The queue is in level order, so each level is one contiguous run, and
+    // the last vertex queued is on the deepest level reached
+    if (levelStart != NULL) {
+        Vertex depth = Q->distance[Q->queue[Q->reached - 1]];
+        Vertex i = 0;
+        for (Vertex d = 0; d <= depth; d++) {
+            levelStart[d] = i;
+            while (i < Q->reached && Q->distance[Q->queue[i]] == d)
+                i++;
+        }
+        levelStart[depth + 1] = Q->reached;
+    }
+    return Q->reached;
+}
+
+// queryBatch()
+// Runs the searches of Q[0..count-1] round-robin, a vertex expansion at a
+// time, so each one's prefetches are in flight while the others expand.
+// Precondition: 1 <= source[i] <= getOrder(queryGraph(Q[i])),
+// dest[i] == NIL or 1 <= dest[i] <= getOrder(queryGraph(Q[i]))
+void queryBatch(Query *Q, const Vertex *source, const Vertex *dest, int count) {
+    if (count > 0 && (Q == NULL || source == NULL)) {
+        printf("Graph Error: queryBatch() called on NULL arrays\n");
+        exit(1);
+    }
+
+    Search *search = malloc(sizeof(Search) * (size_t) (count > 0 ? count : 1));
+    int active = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (Q[i] == NULL) {
+            printf("Graph Error: queryBatch() called on NULL Query reference\n");
+            exit(1);
+        }
+        Graph G = Q[i]->graph;
+        Vertex d = dest != NULL ? dest[i] : NIL;
+        if (source[i] < 1 || source[i] > G->order || d < NIL || d > G->order) {
+            printf("Graph Error: queryBatch() called on vertex outside range of Graph\n");
+            exit(1);
+        }
+
+        ensureCompact(G);
+        resetQuery(Q[i]);
+        Q[i]->source = source[i];
+        Q[i]->distance[source[i]] = 0;
+        Q[i]->queue[0] = source[i];
+
+        Search *S = &search[active];
+        S->query = Q[i];
+        S->offset = G->adjOffset;
+        S->target = G->adjTarget;
+        S->dest = d;
+        S->head = 0;
+        S->tail = 1;
+        if (d == source[i])
+            Q[i]->reached = 1;
+        else
+            active++;
+    }
+
+    // Finished searches swap in the last active one
+    while (active > 0) {
+        for (int i = 0; i < active; i++) {
+            if (!searchStep(&search[i])) {
+                search[i] = search[--active];
+                i--;
             }
-            // Iterates to next adjacent vertex or -1 if none remaining
-            moveNext(G->adjList[u]);
         }
-        // Done processing value from Queue, so color Black
-        G->color[u] = BLACK;
     }
+    free(search);
+}
 
-    // Memory Leak Patrol toot tooooooot
-    freeList(&Queue);
-    Queue = NULL;
+// getQuerySource()
+// Returns the source of the most recent queryBFS() on Q, otherwise NIL.
+Vertex getQuerySource(Query Q) {
+    if (Q == NULL) {
+        printf("Graph Error: getQuerySource() called on NULL Query reference\n");
+        exit(1);
+    }
+    return Q->source;
 }
 
+// getQueryParent()
+// Returns the parent of u in Q's BFS tree, or NIL.
+// Precondition: 1 <= u <= getOrder(queryGraph(Q))
+Vertex getQueryParent(Query Q, Vertex u) {
+    if (Q == NULL) {
+        printf("Graph Error: getQueryParent() called on NULL Query reference\n");
+        exit(1);
+    }
+    if (u < 1 || u > Q->graph->order) {
+        printf("Graph Error: getQueryParent() called on vertex outside range of Graph\n");
+        exit(1);
+    }
+    return Q->parent[u];
+}
 
-// Other Functions ------------------------------------------------------------
+// getQueryDist()
+// Returns the distance from Q's source to u, or INF.
+// Precondition: 1 <= u <= getOrder(queryGraph(Q))
+Vertex getQueryDist(Query Q, Vertex u) {
+    if (Q == NULL) {
+        printf("Graph Error: getQueryDist() called on NULL Query reference\n");
+        exit(1);
+    }
+    if (u < 1 || u > Q->graph->order) {
+        printf("Graph Error: getQueryDist() called on vertex outside range of Graph\n");
+        exit(1);
+    }
+    return Q->distance[u];
+}
 
-// printGraph()
-// Prints the adjacency list representation of G to the file pointed to by out.
-void printGraph(FILE *out, Graph G) {
+// getQueryPath()
+// Appends to L a shortest path from Q's source to u, or NIL if none exists.
+// Precondition: 1 <= u <= getOrder(queryGraph(Q)), getQuerySource(Q) != NIL
+void getQueryPath(List L, Query Q, Vertex u) {
+    if (L == NULL) {
+        printf("Graph Error: getQueryPath() called on NULL List reference\n");
+        exit(1);
+    }
+    if (Q == NULL) {
+        printf("Graph Error: getQueryPath() called on NULL Query reference\n");
+        exit(1);
+    }
+    if (u < 1 || u > Q->graph->order) {
+        printf("Graph Error: getQueryPath() called on vertex outside range of Graph\n");
+        exit(1);
+    }
+    if (Q->source == NIL) {
+        printf("Graph Error: getQueryPath() called on NIL Source\n");
+        exit(1);
+    }
+
+    appendTreePath(L, Q->distance, Q->parent, Q->source, u);
+}
+
+
+// Statistics -----------------------------------------------------------------
+
+// statsEnabled()
+// Returns true (1) if this build collects statistics, otherwise false (0).
+int statsEnabled(void) {
+#ifdef GRAPHADT_STATS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+// getBFSStats()
+// Copies the counters of the most recent BFS() on G into *S.
+void getBFSStats(Graph G, BFSStats *S) {
+    if (G == NULL) {
+        printf("Graph Error: getBFSStats() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (S == NULL) {
+        printf("Graph Error: getBFSStats() called on NULL BFSStats reference\n");
+        exit(1);
+    }
+
+#ifdef GRAPHADT_STATS
+    *S = G->bfs;
+#else
+    S->source = NIL;
+    S->visited = 0;
+    S->edgesScanned = 0;
+    S->levels = 0;
+    S->frontier = NULL;
+    S->levelSeconds = NULL;
+    S->seconds = 0;
+#endif
+}
+
+// getGraphStats()
+// Copies the cumulative counters of G into *S.
+void getGraphStats(Graph G, GraphStats *S) {
+    if (G == NULL) {
+        printf("Graph Error: getGraphStats() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (S == NULL) {
+        printf("Graph Error: getGraphStats() called on NULL GraphStats reference\n");
+        exit(1);
+    }
+
+#ifdef GRAPHADT_STATS
+    *S = G->stats;
+#else
+    S->arcsAdded = 0;
+    S->insertScans = 0;
+    S->maxInsertScan = 0;
+    S->bfsRuns = 0;
+#endif
+}
+
+// printStats()
+// Prints the most recent BFS() counters and the cumulative counters of G to
+// out in a human-readable form.
+void printStats(FILE *out, Graph G) {
     if (out == NULL) {
-        printf("Graph Error: printGraph() called on NULL FILE reference\n");
+        printf("Graph Error: printStats() called on NULL FILE reference\n");
         exit(1);
     }
     if (G == NULL) {
-        printf("Graph Error: printGraph() called on NULL Graph reference\n");
+        printf("Graph Error: printStats() called on NULL Graph reference\n");
         exit(1);
     }
+    if (!statsEnabled()) {
+        fprintf(out, "stats: not collected (build with GRAPHADT_STATS)\n");
+        return;
+    }
 
-    // Iterates through and writes Graph out
-    for (int i = 1; i < getOrder(G) + 1; i++) {
-        fprintf(out, "%d: ", i);
-        printList(out, G->adjList[i]);
-        fprintf(out, "\n");
+    BFSStats B;
+    GraphStats S;
+    getBFSStats(G, &B);
+    getGraphStats(G, &S);
+
+    fprintf(out, "stats: bfs source %" PRIvertex " visited %" PRIvertex " edges %" PRIedge
+                 " levels %" PRIvertex " seconds %.6f\n",
+            B.source, B.visited, B.edgesScanned, B.levels, B.seconds);
+    for (Vertex i = 0; i < B.levels; i++)
+        fprintf(out, "stats:   level %" PRIvertex " frontier %" PRIvertex " seconds %.6f\n",
+                i, B.frontier[i], B.levelSeconds[i]);
+    fprintf(out, "stats: graph arcs %" PRIedge " insert scans %" PRIedge " (max %" PRIedge
+                 ", mean %.2f) bfs runs %" PRIedge "\n",
+            S.arcsAdded, S.insertScans, S.maxInsertScan,
+            S.arcsAdded > 0 ? (double) S.insertScans / (double) S.arcsAdded : 0.0, S.bfsRuns);
+}
+
+
+// Memory ---------------------------------------------------------------------
+
+// getGraphMemory()
+// Fills *M with the heap bytes G holds, by category, and brings the bytes G
+// charges to the memory budget up to date.
+void getGraphMemory(Graph G, GraphMemory *M) {
+    if (G == NULL) {
+        printf("Graph Error: getGraphMemory() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (M == NULL) {
+        printf("Graph Error: getGraphMemory() called on NULL GraphMemory reference\n");
+        exit(1);
+    }
+
+    pthread_mutex_lock(&G->compactLock);
+    measureGraph(G, M);
+    rechargeGraph(G);
+    pthread_mutex_unlock(&G->compactLock);
+}
+
+// printMemory()
+// Prints the getGraphMemory() categories of G to out, one line, in bytes.
+void printMemory(FILE *out, Graph G) {
+    if (out == NULL) {
+        printf("Graph Error: printMemory() called on NULL FILE reference\n");
+        exit(1);
+    }
+    if (G == NULL) {
+        printf("Graph Error: printMemory() called on NULL Graph reference\n");
+        exit(1);
+    }
+
+    GraphMemory M;
+    getGraphMemory(G, &M);
+    fprintf(out, "memory: adjacency %zu vertex state %zu caches %zu indexes %zu mapped %zu total %zu\n",
+            M.adjacency, M.vertexState, M.caches, M.indexes, M.mapped, M.total);
+}
+
+
+// Status-returning variants --------------------------------------------------
+
+// graphStatusName()
+// Returns a short description of status.
+const char *graphStatusName(GraphStatus status) {
+    switch (status) {
+        case GRAPH_OK: return "ok";
+        case GRAPH_NULL_ARGUMENT: return "NULL argument";
+        case GRAPH_OUT_OF_RANGE: return "out of range";
+        case GRAPH_BAD_STATE: return "precondition not met";
+        case GRAPH_NO_MEMORY: return "memory budget exhausted";
+    }
+    return "unknown status";
+}
+
+// tryNewGraph()
+// Sets *pG to a new Graph with n vertices. Its footprint is reserved against
+// the memory budget first and kept as the Graph's charge, and every
+// allocation is checked.
+GraphStatus tryNewGraph(Vertex n, Graph *pG) {
+    if (pG == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    *pG = NULL;
+    if (n < 0 || n >= VERTEX_MAX)
+        return GRAPH_OUT_OF_RANGE;
+
+    size_t numTerms = (size_t) n + 1;
+    size_t perVertex = 2 * sizeof(Vertex) + sizeof(int) + sizeof(List) + listMemoryFor(0);
+    if (numTerms > (SIZE_MAX - sizeof(GraphObj)) / perVertex)
+        return GRAPH_NO_MEMORY;
+    size_t bytes = sizeof(GraphObj) + numTerms * perVertex;
+    if (!reserveMemory(bytes))
+        return GRAPH_NO_MEMORY;
+
+    Graph G = tryAllocGraph(n);
+    if (G == NULL) {
+        releaseMemory(bytes);
+        return GRAPH_NO_MEMORY;
+    }
+    G->adjList = malloc(sizeof(List) * numTerms);
+    if (G->adjList == NULL) {
+        freeGraph(&G);
+        releaseMemory(bytes);
+        return GRAPH_NO_MEMORY;
+    }
+    for (size_t u = 0; u < numTerms; u++) {
+        if (tryNewList(&G->adjList[u]) != GRAPH_OK) {
+            while (u > 0)
+                freeList(&G->adjList[--u]);
+            free(G->adjList);
+            G->adjList = NULL;
+            freeGraph(&G);
+            releaseMemory(bytes);
+            return GRAPH_NO_MEMORY;
+        }
     }
-}
\ No newline at end of file
+
+    // The reservation becomes the charge, trued up to the measured footprint
+    G->charged = bytes;
+    rechargeGraph(G);
+    *pG = G;
+    return GRAPH_OK;
+}
+
+// tryAddEdge()
+// Validates once, then inserts the edge joining u to v.
+GraphStatus tryAddEdge(Graph G, Vertex u, Vertex v) {
+    if (G == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (u < 1 || u > G->order || v < 1 || v > G->order)
+        return GRAPH_OUT_OF_RANGE;
+    linkEdge(G, u, v);
+    return GRAPH_OK;
+}
+
+// tryAddArc()
+// Validates once, then inserts the arc from u to v.
+GraphStatus tryAddArc(Graph G, Vertex u, Vertex v) {
+    if (G == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (u < 1 || u > G->order || v < 1 || v > G->order)
+        return GRAPH_OUT_OF_RANGE;
+    linkArc(G, u, v);
+    return GRAPH_OK;
+}
+
+// tryBFS()
+// Validates once, then runs BFS() from s.
+GraphStatus tryBFS(Graph G, Vertex s) {
+    if (G == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (s < 1 || s > G->order)
+        return GRAPH_OUT_OF_RANGE;
+    runBFS(G, s);
+    return GRAPH_OK;
+}
+
+// tryGetDist()
+// Sets *dist to getDist(G, u).
+GraphStatus tryGetDist(Graph G, Vertex u, Vertex *dist) {
+    if (G == NULL || dist == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (u < 1 || u > G->order)
+        return GRAPH_OUT_OF_RANGE;
+    *dist = G->source == NIL ? INF : G->distance[u];
+    return GRAPH_OK;
+}
+
+// tryGetParent()
+// Sets *parent to getParent(G, u).
+GraphStatus tryGetParent(Graph G, Vertex u, Vertex *parent) {
+    if (G == NULL || parent == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (u < 1 || u > G->order)
+        return GRAPH_OUT_OF_RANGE;
+    *parent = G->parent[u];
+    return GRAPH_OK;
+}
+
+// tryGetPath()
+// Appends to L what getPath(L, G, u) would.
+GraphStatus tryGetPath(List L, Graph G, Vertex u) {
+    if (L == NULL || G == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (u < 1 || u > G->order)
+        return GRAPH_OUT_OF_RANGE;
+    if (G->source == NIL)
+        return GRAPH_BAD_STATE;
+    appendTreePath(L, G->distance, G->parent, G->source, u);
+    return GRAPH_OK;
+}
+
+// tryQueryBFS()
+// Validates once, then runs queryBFS() from s.
+GraphStatus tryQueryBFS(Query Q, Vertex s) {
+    if (Q == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (s < 1 || s > Q->graph->order)
+        return GRAPH_OUT_OF_RANGE;
+    runQuery(Q, s);
+    return GRAPH_OK;
+}
+
+// tryGetQueryDist()
+// Sets *dist to getQueryDist(Q, u).
+GraphStatus tryGetQueryDist(Query Q, Vertex u, Vertex *dist) {
+    if (Q == NULL || dist == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (u < 1 || u > Q->graph->order)
+        return GRAPH_OUT_OF_RANGE;
+    *dist = Q->distance[u];
+    return GRAPH_OK;
+}
+
+// tryGetQueryPath()
+// Appends to L what getQueryPath(L, Q, u) would.
+GraphStatus tryGetQueryPath(List L, Query Q, Vertex u) {
+    if (L == NULL || Q == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (u < 1 || u > Q->graph->order)
+        return GRAPH_OUT_OF_RANGE;
+    if (Q->source == NIL)
+        return GRAPH_BAD_STATE;
+    appendTreePath(L, Q->distance, Q->parent, Q->source, u);
+    return GRAPH_OK;
+}
@@ -15,15 +15,86 @@
 #define INF -1
 #define NIL 0
 
+// Edge policies, combined with |, for setEdgePolicy()
+#define EDGES_MULTI 0      // keep repeated edges and self-loops
+#define EDGES_DEDUP 1      // drop edges that are already present
+#define EDGES_NO_LOOPS 2   // drop self-loops
+
 // Exported type --------------------------------------------------------------
 typedef struct GraphObj *Graph;
 
+// A Query holds the state of one BFS (source, distances, parents) separately
+// from its Graph, so many threads can each traverse the same Graph at once.
+typedef struct QueryObj *Query;
+
+// BFSStats
+// Counters for the most recent BFS() on a Graph. frontier[i] is the number of
+// vertices at distance i and levelSeconds[i] the time spent expanding them;
+// both arrays have levels entries and stay valid until the next BFS() or
+// freeGraph().
+typedef struct BFSStats {
+    Vertex source;
+    Vertex visited;
+    EdgeIndex edgesScanned;
+    Vertex levels;
+    const Vertex *frontier;
+    const double *levelSeconds;
+    double seconds;
+} BFSStats;
+
+// GraphStats
+// Counters accumulated over the lifetime of a Graph. insertScans is the total
+// number of list entries addArc() stepped over to find each insertion point.
+typedef struct GraphStats {
+    EdgeIndex arcsAdded;
+    EdgeIndex insertScans;
+    EdgeIndex maxInsertScan;
+    EdgeIndex bfsRuns;
+} GraphStats;
+
+// GraphMemory
+// Heap bytes held by a Graph, by use. adjacency is its adjacency lists, or
+// its compact adjacency if it has no lists; vertexState the Graph itself and
+// its per-vertex BFS arrays; caches the compact copy of its lists that
+// traversals build; indexes its reverse adjacency. total sums those four.
+// mapped is compact adjacency the Graph reads but does not own (see
+// newGraphView()), which total leaves out.
+typedef struct GraphMemory {
+    size_t adjacency;
+    size_t vertexState;
+    size_t caches;
+    size_t indexes;
+    size_t mapped;
+    size_t total;
+} GraphMemory;
+
 
 // Constructors-Destructors ---------------------------------------------------
 
 // newGraph()
 // Returns a Graph pointing to a newly created GraphObj with n vertices.
-Graph newGraph(int n);
+// Precondition: 0 <= n < VERTEX_MAX
+Graph newGraph(Vertex n);
+
+// newGraphCompact()
+// Returns a Graph with n vertices whose adjacency is given in compact (CSR)
+// form, as getAdjacency() returns it: the neighbors of u are target[offset[u]]
+// .. target[offset[u + 1] - 1], in ascending order, and offset has n + 2
+// entries. The Graph takes ownership of both arrays, which must come from
+// malloc(), and reports size from getSize(). Adjacency lists are only
+// materialized if the Graph is later modified.
+// Precondition: 0 <= n < VERTEX_MAX
+Graph newGraphCompact(Vertex n, EdgeIndex *offset, Vertex *target, EdgeIndex size);
+
+// newGraphView()
+// Like newGraphCompact(), but over arrays the Graph does not own, such as a
+// read-only mapping shared with other processes. They are never written: if
+// the Graph is modified it first copies them into adjacency lists. When the
+// Graph is freed or stops using them it calls release(arg), if not NULL.
+// Each Graph still has its own private BFS state.
+// Precondition: 0 <= n < VERTEX_MAX
+Graph newGraphView(Vertex n, const EdgeIndex *offset, const Vertex *target, EdgeIndex size,
+                   void (*release)(void *arg), void *arg);
 
 // freeGraph()
 // Frees all dynamic memory associated with the Graph *pG, then sets the handle
@@ -35,32 +106,63 @@ void freeGraph(Graph *pG);
 
 // getOrder()
 // Returns the order of Graph G.
-int getOrder(Graph G);
+Vertex getOrder(Graph G);
 
 // getSize()
 // Returns the size of the graph G.
-int getSize(Graph G);
+EdgeIndex getSize(Graph G);
 
 // getSource()
 // Returns the source vertex most recently used in function BFS() otherwise NIL.
-int getSource(Graph G);
+Vertex getSource(Graph G);
 
 // getParent()
 // Returns the parent of vertex u in BFS Tree.
 // Precondition: 1 <= u <= getOrder(G)
-int getParent(Graph G, int u);
+Vertex getParent(Graph G, Vertex u);
 
 // getDist()
 // Returns the distance from the most recent BFS source to vertex u, or INF
 // if BFS() has not been called yet.
 // Precondition: 1 <= u <= getOrder(G)
-int getDist(Graph G, int u);
+Vertex getDist(Graph G, Vertex u);
+
+// getEdgePolicy()
+// Returns the edge policy addEdge() and addArc() apply to G.
+int getEdgePolicy(Graph G);
+
+// getDroppedEdges()
+// Returns the number of edges (or arcs) G's edge policy has refused since G
+// was created or last made null.
+EdgeIndex getDroppedEdges(Graph G);
 
 // getPath()
 // Appends to the List L the vertices of a shortest path in G from source to u
 // or appends to L the value NIL if no such path exists.
 // Precondition: 1 <= u <= getOrder(G), getSource(G) != NIL
-void getPath(List L, Graph G, int u);
+void getPath(List L, Graph G, Vertex u);
+
+
+// getAdjacency()
+// Sets *offset and *target to a compact (CSR) copy of G's adjacency lists:
+// the neighbors of u are target[offset[u]] .. target[offset[u + 1] - 1], in
+// the same ascending order printGraph() lists them. The arrays are built on
+// first use and cached; they stay valid until G is next modified or freed.
+void getAdjacency(Graph G, const EdgeIndex **offset, const Vertex **target);
+
+// getReverseAdjacency()
+// Sets *offset and *source to the compact transpose of G's adjacency: the
+// vertices with an arc into v are source[offset[v]] .. source[offset[v + 1]
+// - 1], ascending, with offset laid out as in getAdjacency(). Built on first
+// use, in parallel for large graphs, and cached until G is next modified, so
+// it always agrees with addArc(), addEdge() and makeNull().
+void getReverseAdjacency(Graph G, const EdgeIndex **offset, const Vertex **source);
+
+// getInDegree()
+// Returns the number of arcs into u, counting repeats. Builds the reverse
+// adjacency if it is not current; O(1) after that.
+// Precondition: 1 <= u <= getOrder(G)
+EdgeIndex getInDegree(Graph G, Vertex u);
 
 
 // Manipulation procedures ----------------------------------------------------
@@ -69,18 +171,39 @@ void getPath(List L, Graph G, int u);
 // Deletes all edges of G, restoring it to its original no edge state.
 void makeNull(Graph G);
 
+// setEdgePolicy()
+// Sets the edge policy for later insertions into G: EDGES_MULTI (the default)
+// or any of EDGES_DEDUP and EDGES_NO_LOOPS combined. Edges already in G are
+// left as they are.
+void setEdgePolicy(Graph G, int policy);
+
+// addDroppedEdges()
+// Adds count to G's dropped edge tally, for builders that apply an edge
+// policy themselves before creating G.
+void addDroppedEdges(Graph G, EdgeIndex count);
+
 // addEdge()
-// Inserts a new edge joining u to v.
-void addEdge(Graph G, int u, int v);
+// Inserts a new edge joining u to v, unless G's edge policy refuses it.
+void addEdge(Graph G, Vertex u, Vertex v);
 
 // addArc()
-// Inserts a new directed edge from u to v.
-void addArc(Graph G, int u, int v);
+// Inserts a new directed edge from u to v, unless G's edge policy refuses it.
+// The duplicate check costs nothing extra: the sorted insertion already stops
+// at the first neighbor not below v.
+void addArc(Graph G, Vertex u, Vertex v);
 
 // BFS()
 // Runs the BFS algorithm on the Graph G with source s, setting color,
 // distance, parent and source fields of G accordingly.
-void BFS(Graph G, int s);
+void BFS(Graph G, Vertex s);
+
+// restoreBFS()
+// Sets G's BFS results to those of an earlier BFS(G, s), such as ones saved
+// in a snapshot: distance[u] and parent[u] for 1 <= u <= getOrder(G), with
+// reached vertices colored black. Does not check that they are consistent
+// with G's edges.
+// Precondition: 1 <= s <= getOrder(G)
+void restoreBFS(Graph G, Vertex s, const Vertex *distance, const Vertex *parent);
 
 
 // Other Functions ------------------------------------------------------------
@@ -89,5 +212,178 @@ void BFS(Graph G, int s);
 // Prints the adjacency list representation of G to the file pointed to by out.
 void printGraph(FILE *out, Graph G);
 
+// appendTreePath()
+// Appends to L the path from source to u in the BFS tree recorded by distance
+// and parent, indexed by vertex with parent[source] == NIL, or NIL if u was
+// not reached. For searches that keep their own arrays, such as ExtGraph.
+// Precondition: 1 <= u, source <= the arrays' highest vertex
+void appendTreePath(List L, const Vertex *distance, const Vertex *parent, Vertex source, Vertex u);
+
+
+
+// Queries --------------------------------------------------------------------
+// Any number of Queries, on any threads, may run against one Graph as long as
+// the Graph is not modified (addArc(), addEdge(), makeNull()) or freed while
+// they are in use. BFS() on the Graph itself is not safe to run concurrently
+// with other BFS() calls, but is safe alongside Queries.
+
+// newQuery()
+// Returns a traversal context for BFS queries against G.
+Query newQuery(Graph G);
+
+// freeQuery()
+// Frees all heap memory associated with *pQ, and sets *pQ to NULL.
+void freeQuery(Query *pQ);
+
+// queryGraph()
+// Returns the Graph Q runs against.
+Graph queryGraph(Query Q);
+
+// queryBFS()
+// Runs BFS from s on Q's Graph, storing distances, parents and source in Q
+// rather than in the Graph.
+// Precondition: 1 <= s <= getOrder(queryGraph(Q))
+void queryBFS(Query Q, Vertex s);
+
+// getQuerySource()
+// Returns the source of the most recent queryBFS() on Q, otherwise NIL.
+Vertex getQuerySource(Query Q);
+
+// getQueryParent()
+// Returns the parent of u in Q's BFS tree, or NIL.
+// Precondition: 1 <= u <= getOrder(queryGraph(Q))
+Vertex getQueryParent(Query Q, Vertex u);
+
+// getQueryDist()
+// Returns the distance from Q's source to u, or INF if u is unreachable or
+// queryBFS() has not been called yet.
+// Precondition: 1 <= u <= getOrder(queryGraph(Q))
+Vertex getQueryDist(Query Q, Vertex u);
+
+// getQueryPath()
+// Appends to L the vertices of a shortest path from Q's source to u, or NIL
+// if no such path exists.
+// Precondition: 1 <= u <= getOrder(queryGraph(Q)), getQuerySource(Q) != NIL
+void getQueryPath(List L, Query Q, Vertex u);
+
+// queryKHop()
+// Runs BFS from s on Q's Graph that stops at depth k, and returns how many
+// vertices are within k hops of s. The first capacity of them are copied to
+// out in BFS order, so grouped by distance. If levelStart is not NULL,
+// levelStart[d] receives the index in that order of the first vertex at
+// distance d, for each depth d up to the deepest one reached, D <= k, and
+// levelStart[D + 1] the total; every level is non-empty, so D + 1 is the
+// first index holding the total. It needs room for min(k, getOrder() - 1) + 2
+// entries. Only reached vertices' state is touched, so the cost is
+// independent of getOrder() and of k beyond D. The getQuery*() functions
+// report the bounded search afterwards, with INF beyond depth k.
+// Precondition: 1 <= s <= getOrder(queryGraph(Q)), k >= 0
+Vertex queryKHop(Query Q, Vertex s, Vertex k, Vertex *out, Vertex capacity, Vertex *levelStart);
+
+
+// queryBatch()
+// Runs count independent searches at once, Q[i] searching from source[i]
+// until it reaches dest[i], or the whole component when dest is NULL or
+// dest[i] is NIL. The searches take turns expanding one vertex each and
+// prefetch the vertex state they are about to read, so one thread keeps
+// several cache misses in flight; on graphs much larger than the cache this
+// answers many short queries faster than queryBFS() one at a time. Each Q[i]
+// then reports its search through the getQuery*() functions: dest[i]'s
+// distance and path are exact, vertices the search stopped before reaching
+// read INF. The Queries must be distinct; their Graphs need not be.
+// Precondition: 1 <= source[i] <= getOrder(queryGraph(Q[i])),
+// dest[i] == NIL or 1 <= dest[i] <= getOrder(queryGraph(Q[i]))
+void queryBatch(Query *Q, const Vertex *source, const Vertex *dest, int count);
+
+// Statistics -----------------------------------------------------------------
+// Counters are only collected when the library is built with GRAPHADT_STATS
+// defined (cmake -DGRAPHADT_STATS=ON). Otherwise the hooks compile away and
+// these functions report zeros.
+
+// statsEnabled()
+// Returns true (1) if this build collects statistics, otherwise false (0).
+int statsEnabled(void);
+
+// getBFSStats()
+// Copies the counters of the most recent BFS() on G into *S.
+void getBFSStats(Graph G, BFSStats *S);
+
+// getGraphStats()
+// Copies the cumulative counters of G into *S.
+void getGraphStats(Graph G, GraphStats *S);
+
+// printStats()
+// Prints the most recent BFS() counters and the cumulative counters of G to
+// out in a human-readable form.
+void printStats(FILE *out, Graph G);
+
+
+// Memory ---------------------------------------------------------------------
+// Every Graph charges its total to the budget of Memory.h as its
+// representation changes. Growth of its adjacency lists is charged when next
+// measured, by getGraphMemory() or a rebuild of its caches.
+
+// getGraphMemory()
+// Fills *M with the heap bytes G holds, by category, and brings the bytes G
+// charges to the memory budget up to date.
+void getGraphMemory(Graph G, GraphMemory *M);
+
+// printMemory()
+// Prints the getGraphMemory() categories of G to out, one line, in bytes.
+void printMemory(FILE *out, Graph G);
+
+
+// Status-returning variants --------------------------------------------------
+// For callers, such as long-running services, that must survive bad input:
+// each validates its arguments once, returning GRAPH_NULL_ARGUMENT,
+// GRAPH_OUT_OF_RANGE or GRAPH_BAD_STATE (no BFS source yet) where the plain
+// function would print an error and exit, and otherwise does the same work
+// and returns GRAPH_OK. Outputs are only written on GRAPH_OK.
+
+// graphStatusName()
+// Returns a short description of status.
+const char *graphStatusName(GraphStatus status);
+
+// tryNewGraph()
+// Sets *pG to a new Graph with n vertices, or to NULL on failure. Returns
+// GRAPH_NO_MEMORY if the Graph would not fit in the memory budget.
+GraphStatus tryNewGraph(Vertex n, Graph *pG);
+
+// tryAddEdge()
+// addEdge(G, u, v) with status.
+GraphStatus tryAddEdge(Graph G, Vertex u, Vertex v);
+
+// tryAddArc()
+// addArc(G, u, v) with status.
+GraphStatus tryAddArc(Graph G, Vertex u, Vertex v);
+
+// tryBFS()
+// BFS(G, s) with status.
+GraphStatus tryBFS(Graph G, Vertex s);
+
+// tryGetDist()
+// Sets *dist to getDist(G, u).
+GraphStatus tryGetDist(Graph G, Vertex u, Vertex *dist);
+
+// tryGetParent()
+// Sets *parent to getParent(G, u).
+GraphStatus tryGetParent(Graph G, Vertex u, Vertex *parent);
+
+// tryGetPath()
+// getPath(L, G, u) with status.
+GraphStatus tryGetPath(List L, Graph G, Vertex u);
+
+// tryQueryBFS()
+// queryBFS(Q, s) with status.
+GraphStatus tryQueryBFS(Query Q, Vertex s);
+
+// tryGetQueryDist()
+// Sets *dist to getQueryDist(Q, u).
+GraphStatus tryGetQueryDist(Query Q, Vertex u, Vertex *dist);
+
+// tryGetQueryPath()
+// getQueryPath(L, Q, u) with status.
+GraphStatus tryGetQueryPath(List L, Query Q, Vertex u);
+
 
 #endif //GRAPHADT_GRAPH_H
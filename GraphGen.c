@@ -0,0 +1,170 @@
+//-----------------------------------------------------------------------------
+// GraphGen.c
+// Implementation file for synthetic graph generators
+//-----------------------------------------------------------------------------
+
+#include "GraphGen.h"
+
+// Random numbers -------------------------------------------------------------
+
+// genRandom()
+// Advances *state and returns the next 64-bit pseudo-random value (splitmix64).
+uint64_t genRandom(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// genRandomVertex()
+// Returns a pseudo-random vertex in 1..n.
+Vertex genRandomVertex(uint64_t *state, Vertex n) {
+    return (Vertex) (genRandom(state) % (uint64_t) n) + 1;
+}
+
+// genUniform()
+// Returns a pseudo-random double in [0, 1).
+// Private.
+static double genUniform(uint64_t *state) {
+    return (double) (genRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+// Generators -----------------------------------------------------------------
+
+// genErdosRenyi()
+// Returns m edges with both endpoints drawn uniformly from 1..n.
+EdgeList genErdosRenyi(Vertex n, EdgeIndex m, uint64_t seed) {
+    if (n < 2 || m < 0) {
+        printf("GraphGen Error: genErdosRenyi() called with n < 2 or m < 0\n");
+        exit(1);
+    }
+
+    EdgeList E = newEdgeList(n, m);
+    uint64_t state = seed;
+
+    while (edgeCount(E) < m) {
+        Vertex u = genRandomVertex(&state, n);
+        Vertex v = genRandomVertex(&state, n);
+        if (u != v)
+            appendEdge(E, u, v);
+    }
+    return E;
+}
+
+// genRMAT()
+// Returns m edges of an R-MAT graph on 2^scale vertices.
+EdgeList genRMAT(int scale, EdgeIndex m, double a, double b, double c, uint64_t seed) {
+    if (scale < 1 || scale >= (int) (sizeof(Vertex) * 8) - 1 || m < 0) {
+        printf("GraphGen Error: genRMAT() called with scale outside range of Vertex\n");
+        exit(1);
+    }
+    if (a < 0 || b < 0 || c < 0 || a + b + c > 1.0) {
+        printf("GraphGen Error: genRMAT() called with invalid quadrant probabilities\n");
+        exit(1);
+    }
+
+    Vertex n = (Vertex) 1 << scale;
+    EdgeList E = newEdgeList(n, m);
+    uint64_t state = seed;
+
+    // Random relabelling so vertex IDs carry no degree information
+    Vertex *label = malloc(sizeof(Vertex) * (size_t) n);
+    for (Vertex i = 0; i < n; i++)
+        label[i] = i + 1;
+    for (Vertex i = n - 1; i > 0; i--) {
+        Vertex j = (Vertex) (genRandom(&state) % (uint64_t) (i + 1));
+        Vertex t = label[i];
+        label[i] = label[j];
+        label[j] = t;
+    }
+
+    while (edgeCount(E) < m) {
+        Vertex u = 0;
+        Vertex v = 0;
+
+        // Descends one bit of each endpoint per level of the recursion
+        for (int bit = scale - 1; bit >= 0; bit--) {
+            double r = genUniform(&state);
+            if (r < a) {
+            } else if (r < a + b) {
+                v |= (Vertex) 1 << bit;
+            } else if (r < a + b + c) {
+                u |= (Vertex) 1 << bit;
+            } else {
+                u |= (Vertex) 1 << bit;
+                v |= (Vertex) 1 << bit;
+            }
+        }
+        if (u != v)
+            appendEdge(E, label[u], label[v]);
+    }
+
+    free(label);
+    return E;
+}
+
+// genGrid2D()
+// Returns the 4-neighbour grid with rows * cols vertices, numbered row-major.
+EdgeList genGrid2D(Vertex rows, Vertex cols) {
+    if (rows < 1 || cols < 1 || rows > VERTEX_MAX / cols) {
+        printf("GraphGen Error: genGrid2D() called with dimensions outside range of Vertex\n");
+        exit(1);
+    }
+
+    EdgeList E = newEdgeList(rows * cols, (EdgeIndex) 2 * rows * cols);
+
+    for (Vertex r = 0; r < rows; r++) {
+        for (Vertex c = 0; c < cols; c++) {
+            Vertex u = r * cols + c + 1;
+            if (c + 1 < cols)
+                appendEdge(E, u, u + 1);
+            if (r + 1 < rows)
+                appendEdge(E, u, u + cols);
+        }
+    }
+    return E;
+}
+
+// genPath()
+// Returns the path 1 - 2 - ... - n.
+EdgeList genPath(Vertex n) {
+    if (n < 1) {
+        printf("GraphGen Error: genPath() called with n < 1\n");
+        exit(1);
+    }
+
+    EdgeList E = newEdgeList(n, n);
+    for (Vertex u = 1; u < n; u++)
+        appendEdge(E, u, u + 1);
+    return E;
+}
+
+// genStar()
+// Returns the star with hub 1 joined to each of 2..n.
+EdgeList genStar(Vertex n) {
+    if (n < 1) {
+        printf("GraphGen Error: genStar() called with n < 1\n");
+        exit(1);
+    }
+
+    EdgeList E = newEdgeList(n, n);
+    for (Vertex v = 2; v <= n; v++)
+        appendEdge(E, 1, v);
+    return E;
+}
+
+// genWeights()
+// Draws each weight from the top 24 bits of a random value, all of which a
+// float holds exactly.
+void genWeights(EdgeList E, uint64_t seed) {
+    if (E == NULL) {
+        printf("GraphGen Error: genWeights() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+
+    uint64_t state = seed;
+    EdgeIndex m = edgeCount(E);
+    for (EdgeIndex i = 0; i < m; i++)
+        setEdgeWeight(E, i, (Weight) (genRandom(&state) >> 40) / (Weight) (1 << 24));
+}
@@ -0,0 +1,59 @@
+//-----------------------------------------------------------------------------
+// GraphGen.h
+// Header file for synthetic graph generators
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_GRAPHGEN_H
+#define GRAPHADT_GRAPHGEN_H
+
+#include"EdgeList.h"
+
+// Generators return an EdgeList over vertices 1..n listing each undirected
+// edge once. All randomness comes from the seed, so equal arguments always
+// produce identical edge lists.
+
+
+// Random numbers -------------------------------------------------------------
+
+// genRandom()
+// Advances *state and returns the next 64-bit pseudo-random value (splitmix64).
+uint64_t genRandom(uint64_t *state);
+
+// genRandomVertex()
+// Returns a pseudo-random vertex in 1..n.
+Vertex genRandomVertex(uint64_t *state, Vertex n);
+
+
+// Generators -----------------------------------------------------------------
+
+// genErdosRenyi()
+// Returns m edges with both endpoints drawn uniformly from 1..n (G(n, m)
+// model). Self-loops are skipped; duplicate edges may occur.
+// Pre: n >= 2
+EdgeList genErdosRenyi(Vertex n, EdgeIndex m, uint64_t seed);
+
+// genRMAT()
+// Returns m edges of an R-MAT/Kronecker graph on 2^scale vertices, recursing
+// into quadrants with probabilities a, b, c and 1 - a - b - c. Vertex labels
+// are randomly permuted so that hubs are not clustered at low IDs. Self-loops
+// are skipped; duplicate edges may occur.
+// Pre: 1 <= scale < bit width of Vertex - 1, a + b + c <= 1
+EdgeList genRMAT(int scale, EdgeIndex m, double a, double b, double c, uint64_t seed);
+
+// genGrid2D()
+// Returns the 4-neighbour grid with rows * cols vertices, numbered row-major.
+EdgeList genGrid2D(Vertex rows, Vertex cols);
+
+// genPath()
+// Returns the path 1 - 2 - ... - n.
+EdgeList genPath(Vertex n);
+
+// genStar()
+// Returns the star with hub 1 joined to each of 2..n.
+EdgeList genStar(Vertex n);
+
+// genWeights()
+// Gives every edge of E a weight drawn uniformly from [0, 1).
+void genWeights(EdgeList E, uint64_t seed);
+
+#endif //GRAPHADT_GRAPHGEN_H
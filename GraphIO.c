@@ -0,0 +1,173 @@
+//-----------------------------------------------------------------------------
+// GraphIO.c
+// Implementation file for reading and writing FindPath input files
+//-----------------------------------------------------------------------------
+
+#include "GraphIO.h"
+#include "Memory.h"
+
+// Edges readGraph() adds between checks of the memory budget
+#define BUDGET_CHECK 4096
+
+// toVertex()
+// Returns value as a Vertex, exiting if it does not fit.
+Vertex toVertex(long long value) {
+    if (value < 0 || value > VERTEX_MAX) {
+        printf("Vertex %lld is outside the supported range 0..%" PRIvertex "\n", value, (Vertex) VERTEX_MAX);
+#ifndef GRAPHADT_VERTEX64
+        printf("Rebuild with GRAPHADT_VERTEX64 for 64-bit vertex IDs\n");
+#endif
+        exit(1);
+    }
+    return (Vertex) value;
+}
+
+// readVertex()
+// Reads one vertex ID from in into *x. Returns 1 on success, 0 on end of input
+// or malformed input. Exits if the value does not fit in a Vertex.
+int readVertex(FILE *in, Vertex *x) {
+    long long value;
+
+    if (fscanf(in, "%lld", &value) != 1)
+        return 0;
+
+    *x = toVertex(value);
+    return 1;
+}
+
+// readPair()
+// Reads a pair of vertex IDs from in. Returns 1 on success, 0 otherwise.
+int readPair(FILE *in, Vertex *x, Vertex *y) {
+    return readVertex(in, x) && readVertex(in, y);
+}
+
+// readGraph()
+// Reads the vertex count and edge section of an input file from in, adding
+// each edge with addEdge(), and returns the resulting Graph, or NULL once it
+// has outgrown the memory budget.
+Graph readGraph(FILE *in) {
+    if (in == NULL) {
+        printf("GraphIO Error: readGraph() called on NULL FILE reference\n");
+        exit(1);
+    }
+
+    // Reads in number of Vertices to expect
+    Vertex numVert;
+    if (!readVertex(in, &numVert)) {
+        printf("GraphIO Error: readGraph() unable to read number of vertices\n");
+        exit(1);
+    }
+
+    // Creates Graph of size numVert
+    Graph G = newGraph(numVert);
+    Vertex v;
+    Vertex u;
+    EdgeIndex read = 0;
+    GraphMemory M;
+
+    // Reads incident edge list
+    while (readPair(in, &v, &u)) {
+        if (u == 0 && v == 0) break;
+        addEdge(G, v, u);
+
+        // Lists grow uncharged until measured
+        if (++read % BUDGET_CHECK == 0) {
+            getGraphMemory(G, &M);
+            if (memoryExceeded())
+                break;
+        }
+    }
+
+    getGraphMemory(G, &M);
+    if (memoryExceeded())
+        freeGraph(&G);
+    return G;
+}
+
+// writeGraphInput()
+// Writes the vertex count and edge section for the edges of E to out.
+void writeGraphInput(FILE *out, EdgeList E) {
+    if (out == NULL) {
+        printf("GraphIO Error: writeGraphInput() called on NULL FILE reference\n");
+        exit(1);
+    }
+
+    Vertex *source = edgeSources(E);
+    Vertex *target = edgeTargets(E);
+
+    fprintf(out, "%" PRIvertex "\n", edgeOrder(E));
+    for (EdgeIndex i = 0; i < edgeCount(E); i++)
+        fprintf(out, "%" PRIvertex " %" PRIvertex "\n", source[i], target[i]);
+    fprintf(out, "0 0\n");
+}
+
+
+// Status-returning variants --------------------------------------------------
+
+// tryReadVertex()
+// Reads one vertex ID from in into *x, or returns why it could not.
+GraphStatus tryReadVertex(FILE *in, Vertex *x) {
+    long long value;
+
+    if (in == NULL || x == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (fscanf(in, "%lld", &value) != 1)
+        return GRAPH_BAD_STATE;
+    if (value < 0 || value > VERTEX_MAX)
+        return GRAPH_OUT_OF_RANGE;
+
+    *x = (Vertex) value;
+    return GRAPH_OK;
+}
+
+// tryReadGraph()
+// Reads the vertex count and edge section of an input file from in as
+// readGraph() does, returning a status instead of exiting.
+GraphStatus tryReadGraph(FILE *in, Graph *pG) {
+    if (pG == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    *pG = NULL;
+
+    Vertex numVert;
+    GraphStatus status = tryReadVertex(in, &numVert);
+    if (status != GRAPH_OK)
+        return status;
+
+    Graph G;
+    if ((status = tryNewGraph(numVert, &G)) != GRAPH_OK)
+        return status;
+
+    Vertex v;
+    Vertex u;
+    EdgeIndex read = 0;
+    GraphMemory M;
+
+    // Ends at 0 0 or the first pair that does not parse, as readPair() does
+    while ((status = tryReadVertex(in, &v)) == GRAPH_OK && (status = tryReadVertex(in, &u)) == GRAPH_OK) {
+        if (u == 0 && v == 0) break;
+        if ((status = tryAddEdge(G, v, u)) != GRAPH_OK)
+            break;
+
+        if (++read % BUDGET_CHECK == 0) {
+            getGraphMemory(G, &M);
+            if (memoryExceeded()) {
+                status = GRAPH_NO_MEMORY;
+                break;
+            }
+        }
+    }
+    if (status == GRAPH_BAD_STATE)
+        status = GRAPH_OK;
+
+    if (status == GRAPH_OK) {
+        getGraphMemory(G, &M);
+        if (memoryExceeded())
+            status = GRAPH_NO_MEMORY;
+    }
+    if (status != GRAPH_OK) {
+        freeGraph(&G);
+        return status;
+    }
+    *pG = G;
+    return GRAPH_OK;
+}
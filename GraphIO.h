@@ -0,0 +1,67 @@
+//-----------------------------------------------------------------------------
+// GraphIO.h
+// Header file for reading and writing FindPath input files
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_GRAPHIO_H
+#define GRAPHADT_GRAPHIO_H
+
+#include"Graph.h"
+#include"EdgeList.h"
+
+/* Input file structure:
+ *
+ * numVert
+ * v1 v2       <- undirected edges, terminated by 0 0
+ * ....
+ * 0  0
+ * s1 d1       <- source/destination queries, terminated by 0 0
+ * ....
+ * 0  0
+*/
+
+// toVertex()
+// Returns value as a Vertex. Exits if it does not fit, since a narrower build
+// would otherwise silently truncate it.
+Vertex toVertex(long long value);
+
+// readVertex()
+// Reads one vertex ID from in into *x. Returns 1 on success, 0 on end of input
+// or malformed input. Exits if the value does not fit in a Vertex.
+int readVertex(FILE *in, Vertex *x);
+
+// readPair()
+// Reads a pair of vertex IDs from in. Returns 1 on success, 0 otherwise.
+int readPair(FILE *in, Vertex *x, Vertex *y);
+
+// readGraph()
+// Reads the vertex count and edge section of an input file from in, adding
+// each edge with addEdge(), and returns the resulting Graph. Leaves in
+// positioned at the start of the query section. Returns NULL, with in left
+// somewhere in the edge section, if the Graph grows past the memory budget
+// (see Memory.h); the budget is checked every few thousand edges.
+Graph readGraph(FILE *in);
+
+// writeGraphInput()
+// Writes the vertex count and edge section for the edges of E to out,
+// including the terminating 0 0 line.
+void writeGraphInput(FILE *out, EdgeList E);
+
+
+// Status-returning variants --------------------------------------------------
+// These never print or exit, so they can take untrusted input.
+
+// tryReadVertex()
+// Reads one vertex ID from in into *x. Returns GRAPH_BAD_STATE on end of input
+// or malformed input, and GRAPH_OUT_OF_RANGE if the value does not fit in a
+// Vertex.
+GraphStatus tryReadVertex(FILE *in, Vertex *x);
+
+// tryReadGraph()
+// readGraph(in) with status: sets *pG to the Graph, or to NULL on failure.
+// Returns GRAPH_BAD_STATE if the vertex count is missing, GRAPH_OUT_OF_RANGE
+// if it or an edge endpoint is outside the Graph, and GRAPH_NO_MEMORY if the
+// Graph would not fit in the memory budget.
+GraphStatus tryReadGraph(FILE *in, Graph *pG);
+
+#endif //GRAPHADT_GRAPHIO_H
@@ -5,7 +5,30 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "Graph.h"
+#include "Triangle.h"
+#include "Builder.h"
+#include "Centrality.h"
+#include "Coloring.h"
+#include "PageRank.h"
+#include "ExtGraph.h"
+#include "HybridBFS.h"
+#include "Partition.h"
+#include "SharedGraph.h"
+#include "Snapshot.h"
+#include "SpanningForest.h"
+#include "Parallel.h"
+#include "Memory.h"
+
+// countItems()
+// parallelFor() body counting each item of its range in arg.
+static void countItems(EdgeIndex lo, EdgeIndex hi, int tid, void *arg) {
+    int *hits = arg;
+    (void) tid;
+    for (EdgeIndex i = lo; i < hi; i++)
+        __atomic_fetch_add(&hits[i], 1, __ATOMIC_RELAXED);
+}
 
 int main(int argc, char* argv[]) {
     // Creates Graph G and populates it
@@ -28,18 +51,18 @@ int main(int argc, char* argv[]) {
 
     // Tests misc. Functions
     printf("Testing basic properties of Graph\n");
-    printf("Source should be 1 -> %d\n", getSource(G));
-    printf("Order of Graph should be 6 -> %d\n", getOrder(G));
-    printf("Size of Graph should be 5 -> %d\n", getSize(G));
+    printf("Source should be 1 -> %" PRIvertex "\n", getSource(G));
+    printf("Order of Graph should be 6 -> %" PRIvertex "\n", getOrder(G));
+    printf("Size of Graph should be 5 -> %" PRIedge "\n", getSize(G));
     printf("\n");
 
     // Testing Parenting
     printf("Testing Parenting\n");
-    printf("Parent of S should be 0 -> %d\n", getParent(G, getSource(G)));
-    printf("Parent of 6 should be 0 -> %d\n", getParent(G, 6));
-    printf("Parent of 5 should be 1 -> %d\n", getParent(G, 5));
-    printf("Parent of 4 should be 3 -> %d\n", getParent(G, 4));
-    printf("Parent of 3 should be 1 -> %d\n", getParent(G, 3));
+    printf("Parent of S should be 0 -> %" PRIvertex "\n", getParent(G, getSource(G)));
+    printf("Parent of 6 should be 0 -> %" PRIvertex "\n", getParent(G, 6));
+    printf("Parent of 5 should be 1 -> %" PRIvertex "\n", getParent(G, 5));
+    printf("Parent of 4 should be 3 -> %" PRIvertex "\n", getParent(G, 4));
+    printf("Parent of 3 should be 1 -> %" PRIvertex "\n", getParent(G, 3));
     printf("\n");
 
     // Tests getPath
@@ -64,6 +87,43 @@ int main(int argc, char* argv[]) {
     printList(stdout, L);
     printf("\n\n");
 
+    // Tests Queries running alongside the Graph's own BFS
+    printf("Testing Query from source = 2\n");
+    Query Q = newQuery(G);
+    queryBFS(Q, 2);
+    printf("Query source should be 2 -> %" PRIvertex "\n", getQuerySource(Q));
+    printf("Query distance to 3 should be 2 -> %" PRIvertex "\n", getQueryDist(Q, 3));
+    printf("Query parent of 1 should be 5 -> %" PRIvertex "\n", getQueryParent(Q, 1));
+    printf("Graph source should still be 1 -> %" PRIvertex "\n", getSource(G));
+    List P = newList();
+    getQueryPath(P, Q, 3);
+    printf("Query path to 3 should be 2 4 3 -> ");
+    printList(stdout, P);
+    printf("\n\n");
+    freeList(&P);
+    freeQuery(&Q);
+
+    // Tests compact adjacency
+    printf("Testing getAdjacency\n");
+    const EdgeIndex *offset;
+    const Vertex *target;
+    getAdjacency(G, &offset, &target);
+    printf("Neighbors of 3 should be 1 4 -> ");
+    for (EdgeIndex e = offset[3]; e < offset[4]; e++)
+        printf("%" PRIvertex " ", target[e]);
+    printf("\n\n");
+
+    // Tests triangle counting
+    printf("Testing countTriangles\n");
+    printf("Triangles should be 0 -> %" PRIedge "\n", countTriangles(G, NULL, 2));
+    addEdge(G, 1, 4);
+    printf("Triangles after adding 1-4 should be 1 -> %" PRIedge "\n", countTriangles(G, NULL, 2));
+    double coef[7];
+    clusteringCoefficients(G, coef, 2);
+    printf("Clustering of 3 should be 1.00 -> %.2f\n", coef[3]);
+    printf("Clustering of 1 should be 0.33 -> %.2f\n", coef[1]);
+    printf("\n");
+
     // Nullifying Graph
     printf("Nullifying Graph\n");
     makeNull(G);
@@ -72,9 +132,372 @@ int main(int argc, char* argv[]) {
 
     // Testing Null Graph Properties
     printf("Testing basic properties again\n");
-    printf("Source should be 0 -> %d\n", getSource(G));
-    printf("Order of Graph should be 6 -> %d\n", getOrder(G));
-    printf("Size of Graph should be 0 -> %d\n", getSize(G));
+    printf("Source should be 0 -> %" PRIvertex "\n", getSource(G));
+    printf("Order of Graph should be 6 -> %" PRIvertex "\n", getOrder(G));
+    printf("Size of Graph should be 0 -> %" PRIedge "\n", getSize(G));
+    printf("\n");
+
+    // Tests a Graph built from compact adjacency: path 1-2-3
+    printf("Testing newGraphCompact\n");
+    EdgeIndex *cOffset = malloc(sizeof(EdgeIndex) * 5);
+    Vertex *cTarget = malloc(sizeof(Vertex) * 4);
+    EdgeIndex cOff[] = {0, 0, 1, 3, 4};
+    Vertex cTgt[] = {2, 1, 3, 2};
+    memcpy(cOffset, cOff, sizeof(cOff));
+    memcpy(cTarget, cTgt, sizeof(cTgt));
+    Graph C = newGraphCompact(3, cOffset, cTarget, 2);
+    printf("Size of Graph should be 2 -> %" PRIedge "\n", getSize(C));
+    BFS(C, 1);
+    printf("Distance from 1 to 3 should be 2 -> %" PRIvertex "\n", getDist(C, 3));
+    addEdge(C, 1, 3);
+    BFS(C, 1);
+    printf("Distance after adding 1-3 should be 1 -> %" PRIvertex "\n", getDist(C, 3));
+    freeGraph(&C);
+    printf("\n");
+
+    // Tests the parallel builder with a repeated edge 1-2
+    printf("Testing newGraphFromEdges\n");
+    EdgeList E = newEdgeList(3, 4);
+    appendEdge(E, 1, 2);
+    appendEdge(E, 2, 3);
+    appendEdge(E, 2, 1);
+    C = newGraphFromEdges(E, 1, 0, 2);
+    printf("Size of Graph should be 3 -> %" PRIedge "\n", getSize(C));
+    printGraph(stdout, C);
+    freeGraph(&C);
+    C = newGraphFromEdges(E, 1, EDGES_DEDUP, 2);
+    printf("Size after dedup should be 2 -> %" PRIedge "\n", getSize(C));
+    printGraph(stdout, C);
+    freeGraph(&C);
+    appendEdge(E, 3, 3);
+    C = newGraphFromEdges(E, 0, EDGES_DEDUP | EDGES_NO_LOOPS, 2);
+    printf("Arcs kept without loops should be 3 -> %" PRIedge "\n", getSize(C));
+    printf("Dropped edges should be 1 -> %" PRIedge "\n", getDroppedEdges(C));
+    freeGraph(&C);
+    freeEdgeList(&E);
+    printf("\n");
+
+    // Tests spanning forests of a weighted square with a diagonal, plus a
+    // separate edge 5-6
+    printf("Testing kruskalForest and boruvkaForest\n");
+    E = newEdgeList(6, 0);
+    appendWeightedEdge(E, 1, 2, 1);
+    appendWeightedEdge(E, 2, 3, 2);
+    appendWeightedEdge(E, 3, 4, 1);
+    appendWeightedEdge(E, 4, 1, 3);
+    appendWeightedEdge(E, 1, 3, 2.5f);
+    appendWeightedEdge(E, 5, 6, 4);
+    for (int alg = 0; alg < 2; alg++) {
+        double weight;
+        EdgeList F = alg == 0 ? kruskalForest(E, &weight, 2) : boruvkaForest(E, &weight, 2);
+        printf("%s forest should be 1-2 2-3 3-4 5-6 ->", alg == 0 ? "Kruskal" : "Boruvka");
+        for (EdgeIndex i = 0; i < edgeCount(F); i++)
+            printf(" %" PRIvertex "-%" PRIvertex, edgeSource(F, i), edgeTarget(F, i));
+        printf("\nTotal weight should be 8 -> %g\n", weight);
+        freeEdgeList(&F);
+    }
+    freeEdgeList(&E);
+    printf("\n");
+
+    // Tests coloring and independent sets on a 5-cycle with a pendant 6-1,
+    // which needs 3 colors
+    printf("Testing coloring and lubyMIS\n");
+    C = newGraph(6);
+    for (Vertex u = 1; u <= 5; u++)
+        addEdge(C, u, u % 5 + 1);
+    addEdge(C, 6, 1);
+    Vertex hue[7];
+    const char *orders[] = { "Natural", "Largest-first", "Smallest-last" };
+    for (int o = COLOR_NATURAL; o <= COLOR_SMALLEST_LAST; o++)
+        printf("%s colors should be 3 -> %" PRIvertex "\n", orders[o], greedyColoring(C, o, hue));
+    Vertex colors = parallelColoring(C, hue, 1, 2);
+    int in[7];
+    int in1[7];
+    Vertex chosen = lubyMIS(C, in, 5, 3);
+    lubyMIS(C, in1, 5, 1);
+    int proper = 1;
+    int maximal = 1;
+    getAdjacency(C, &offset, &target);
+    for (Vertex u = 1; u <= 6; u++) {
+        int covered = in[u];
+        for (EdgeIndex e = offset[u]; e < offset[u + 1]; e++) {
+            proper &= hue[target[e]] != hue[u];
+            maximal &= !(in[u] && in[target[e]]);
+            covered |= in[target[e]];
+        }
+        maximal &= covered;
+    }
+    printf("Jones-Plassmann should be proper with at least 3 colors -> %s, %s\n",
+           proper ? "proper" : "conflict", colors >= 3 ? "at least 3" : "fewer");
+    printf("MIS should be independent and maximal -> %s\n", maximal ? "yes" : "no");
+    printf("MIS size should be 2 or 3 -> %s\n", chosen == 2 || chosen == 3 ? "2 or 3" : "other");
+    printf("MIS should not depend on threads -> %s\n",
+           memcmp(in + 1, in1 + 1, sizeof(int) * 6) == 0 ? "same" : "differs");
+    freeGraph(&C);
+    printf("\n");
+
+    // Tests edge policies at insertion time
+    printf("Testing setEdgePolicy\n");
+    C = newGraph(3);
+    setEdgePolicy(C, EDGES_DEDUP | EDGES_NO_LOOPS);
+    addEdge(C, 1, 2);
+    addEdge(C, 2, 1);
+    addEdge(C, 3, 3);
+    addArc(C, 2, 3);
+    addArc(C, 2, 3);
+    printf("Size should be 2 -> %" PRIedge "\n", getSize(C));
+    printf("Dropped edges should be 3 -> %" PRIedge "\n", getDroppedEdges(C));
+    printGraph(stdout, C);
+    freeGraph(&C);
+    printf("\n");
+
+    // Tests the semi-external graph on the cycle 1-2-3-4
+    printf("Testing ExtGraph\n");
+    FILE *text = tmpfile();
+    fprintf(text, "4\n1 2\n2 3\n3 4\n4 1\n0 0\n");
+    rewind(text);
+    writeExtGraph(text, "GraphTest.gadj", 1 << 20);
+    fclose(text);
+    ExtGraph X = openExtGraph("GraphTest.gadj", 1 << 20);
+    printExtGraph(stdout, X);
+    extBFS(X, 1);
+    printf("Distance from 1 to 3 should be 2 -> %" PRIvertex "\n", getExtDist(X, 3));
+    printf("Path from 1 to 3 should be 1 2 3 -> ");
+    getExtPath(L, X, 3);
+    printList(stdout, L);
+    clear(L);
+    printf("\n");
+    freeExtGraph(&X);
+    remove("GraphTest.gadj");
+    printf("\n");
+
+    // Tests partitioned BFS over two processes on the path 1-2-3-6 plus 4-5
+    printf("Testing partitionedBFS\n");
+    addEdge(G, 1, 2);
+    addEdge(G, 2, 3);
+    addEdge(G, 3, 6);
+    addEdge(G, 4, 5);
+    Partition part = newPartition(G, 2, PARTITION_EDGES);
+    printf("Owner of 6 should be 1 -> %d\n", partitionOwner(part, 6));
+    Vertex pDist[7];
+    partitionedBFS(G, part, 1, pDist);
+    BFS(G, 1);
+    printf("Distances should be");
+    for (Vertex v = 1; v <= 6; v++)
+        printf(" %" PRIvertex, getDist(G, v));
+    printf(" ->");
+    for (Vertex v = 1; v <= 6; v++)
+        printf(" %" PRIvertex, pDist[v]);
+    printf("\n");
+    freePartition(&part);
+    printf("\n");
+
+    // Tests direction-optimizing BFS against BFS() on the same Graph
+    printf("Testing hybridBFS\n");
+    Vertex hDist[7];
+    Vertex hParent[7];
+    hybridBFS(G, 1, hDist, hParent);
+    printf("Distances should be");
+    for (Vertex v = 1; v <= 6; v++)
+        printf(" %" PRIvertex, getDist(G, v));
+    printf(" ->");
+    for (Vertex v = 1; v <= 6; v++)
+        printf(" %" PRIvertex, hDist[v]);
+    printf("\nParent of 6 should be 3 -> %" PRIvertex "\n", hParent[6]);
+    printf("\n");
+
+    // Tests a two-hop neighborhood on the same path
+    printf("Testing queryKHop\n");
+    Query K = newQuery(G);
+    Vertex hop[6];
+    Vertex level[4];
+    queryBFS(K, 6);
+    printf("Reached within 2 of 1 should be 3 -> %" PRIvertex "\n", queryKHop(K, 1, 2, hop, 6, level));
+    printf("Vertices should be 1 2 3 ->");
+    for (Vertex i = 0; i < level[3]; i++)
+        printf(" %" PRIvertex, hop[i]);
+    printf("\nLevel starts should be 0 1 2 3 -> %" PRIvertex " %" PRIvertex " %" PRIvertex " %" PRIvertex "\n",
+           level[0], level[1], level[2], level[3]);
+    printf("Distance to 6 should be -1 -> %" PRIvertex "\n", getQueryDist(K, 6));
+    queryBFS(K, 1);
+    printf("Full distance to 6 should be 3 -> %" PRIvertex "\n", getQueryDist(K, 6));
+    freeQuery(&K);
+    printf("\n");
+
+    // Tests interleaved point-to-point searches on the same path
+    printf("Testing queryBatch\n");
+    Query Pair[3] = { newQuery(G), newQuery(G), newQuery(G) };
+    Vertex bSource[3] = { 1, 6, 2 };
+    Vertex bDest[3] = { 6, 6, NIL };
+    queryBatch(Pair, bSource, bDest, 3);
+    printf("Distance from 1 to 6 should be 3 -> %" PRIvertex "\n", getQueryDist(Pair[0], 6));
+    printf("Path from 1 to 6 should be 1 2 3 6 -> ");
+    getQueryPath(L, Pair[0], 6);
+    printList(stdout, L);
+    clear(L);
+    printf("\nDistance from 6 to itself should be 0 -> %" PRIvertex "\n", getQueryDist(Pair[1], 6));
+    printf("Full search from 2 reaching 6 should be 2 -> %" PRIvertex "\n", getQueryDist(Pair[2], 6));
+    for (int i = 0; i < 3; i++)
+        freeQuery(&Pair[i]);
+    printf("\n");
+
+    // Tests betweenness on the path 1-2-3-4
+    printf("Testing betweenness\n");
+    Graph B = newGraph(4);
+    addEdge(B, 1, 2);
+    addEdge(B, 2, 3);
+    addEdge(B, 3, 4);
+    double score[5];
+    betweenness(B, score, 0, 1, 2);
+    printf("Scores should be 0 4 4 0 -> %g %g %g %g\n", score[1], score[2], score[3], score[4]);
+    betweenness(B, score, 2, 1, 1);
+    printf("Sampled score of 1 should be 0 -> %g\n", score[1]);
+    freeGraph(&B);
+    printf("\n");
+
+    // Tests PageRank on the directed cycle 1->2->3->1
+    printf("Testing pageRank\n");
+    Graph R = newGraph(3);
+    addArc(R, 1, 2);
+    addArc(R, 2, 3);
+    addArc(R, 3, 1);
+    float rank[4];
+    pageRank(R, rank, 0.85, 1e-6, 100, NULL, 2);
+    printf("Ranks should be 0.333 0.333 0.333 -> %.3f %.3f %.3f\n", rank[1], rank[2], rank[3]);
+    float personal[4] = {0, 1, 0, 0};
+    pageRank(R, rank, 0.5, 1e-7, 100, personal, 1);
+    printf("Personalized ranks should be 0.571 0.286 0.143 -> %.3f %.3f %.3f\n", rank[1], rank[2], rank[3]);
+    printf("Iterations with limit 1 should be 1 -> %d\n", pageRank(R, rank, 0.5, 0, 1, personal, 1));
+    addArc(R, 1, 3);
+    const EdgeIndex *inOffset;
+    const Vertex *inSource;
+    getReverseAdjacency(R, &inOffset, &inSource);
+    printf("In-neighbors of 3 should be 1 2 ->");
+    for (EdgeIndex e = inOffset[3]; e < inOffset[4]; e++)
+        printf(" %" PRIvertex, inSource[e]);
+    printf("\nIn-degree of 1 should be 1 -> %" PRIedge "\n", getInDegree(R, 1));
+    makeNull(R);
+    printf("In-degree of 3 after makeNull should be 0 -> %" PRIedge "\n", getInDegree(R, 3));
+    freeGraph(&R);
+    printf("\n");
+
+    // Tests publishing to and attaching from shared memory
+    printf("Testing SharedGraph\n");
+    unpublishGraph("/GraphTest");
+    printf("Publish should be 1 -> %d\n", publishGraph(G, "/GraphTest"));
+    printf("Second publish should be 0 -> %d\n", publishGraph(G, "/GraphTest"));
+    Graph S = attachGraph("/GraphTest");
+    unpublishGraph("/GraphTest");
+    BFS(S, 1);
+    printf("Distance from 1 to 6 should be 3 -> %" PRIvertex "\n", getDist(S, 6));
+    addEdge(S, 1, 6);
+    BFS(S, 1);
+    printf("Distance after adding 1-6 should be 1 -> %" PRIvertex "\n", getDist(S, 6));
+    printf("Size of Graph should be 5 -> %" PRIedge "\n", getSize(S));
+    freeGraph(&S);
+    printf("\n");
+
+    // Tests saving and restoring a snapshot with its BFS results
+    printf("Testing Snapshot\n");
+    BFS(G, 1);
+    for (int compress = 0; compress <= SNAPSHOT_COMPRESS; compress++) {
+        saveSnapshot(G, "GraphTest.snap", compress);
+        Graph N = loadSnapshot("GraphTest.snap");
+        printf("Restored source should be 1 -> %" PRIvertex "\n", getSource(N));
+        printf("Restored distance to 6 should be 3 -> %" PRIvertex "\n", getDist(N, 6));
+        printf("Restored size should be %" PRIedge " -> %" PRIedge "\n", getSize(G), getSize(N));
+        const EdgeIndex *nOffset;
+        const Vertex *nTarget;
+        getAdjacency(N, &nOffset, &nTarget);
+        getAdjacency(G, &offset, &target);
+        int same = memcmp(nOffset, offset, sizeof(EdgeIndex) * 8) == 0 &&
+                   memcmp(nTarget, target, sizeof(Vertex) * (size_t) offset[7]) == 0;
+        printf("Restored adjacency should match -> %s\n", same ? "match" : "differs");
+        freeGraph(&N);
+    }
+    remove("GraphTest.snap");
+    printf("Missing snapshot should be NULL -> %s\n", loadSnapshot("GraphTest.snap") == NULL ? "NULL" : "Graph");
+    printf("\n");
+
+    // Tests parallelFor() over G's vertices weighted by degree
+    printf("Testing parallelFor\n");
+    getAdjacency(G, &offset, &target);
+    int hits[8] = { 0 };
+    parallelFor(1, 7, offset, 1, countItems, hits, 4);
+    int once = 0;
+    for (int i = 0; i < 8; i++)
+        once += hits[i] == 1;
+    printf("Vertices run exactly once should be 6 -> %d\n", once);
+    parallelFor(1, 7, NULL, 0, countItems, hits, 0);
+    printf("Vertex 6 after a second pass should be 2 -> %d\n", hits[6]);
+    printf("\n");
+
+    // Tests memory accounting by category and the memory budget
+    printf("Testing getGraphMemory\n");
+    GraphMemory gm;
+    GraphMemory cm;
+    size_t compact = sizeof(EdgeIndex) * 5 + sizeof(Vertex) * 4;
+    cOffset = malloc(sizeof(EdgeIndex) * 5);
+    cTarget = malloc(sizeof(Vertex) * 4);
+    memcpy(cOffset, cOff, sizeof(cOff));
+    memcpy(cTarget, cTgt, sizeof(cTgt));
+    C = newGraphCompact(3, cOffset, cTarget, 2);
+    getGraphMemory(C, &cm);
+    printf("Compact adjacency should be %zu -> %zu\n", compact, cm.adjacency);
+    getReverseAdjacency(C, &offset, &target);
+    getGraphMemory(C, &cm);
+    printf("Reverse index should be %zu -> %zu\n", compact, cm.indexes);
+    addEdge(C, 1, 3);
+    BFS(C, 1);
+    getGraphMemory(C, &cm);
+    printf("Lists should be %zu -> %zu\n", 4 * sizeof(List) + 3 * listMemoryFor(2) + listMemoryFor(0),
+           cm.adjacency);
+    printf("Compact cache should be %zu -> %zu\n", compact + 2 * sizeof(Vertex), cm.caches);
+    printf("Reverse index after addEdge should be 0 -> %zu\n", cm.indexes);
+    getGraphMemory(G, &gm);
+    printf("Charged should be %zu -> %zu\n", gm.total + cm.total, getMemoryCharged());
+    setMemoryBudget(getMemoryCharged() + 64);
+    E = newEdgeList(3, 4);
+    appendEdge(E, 1, 2);
+    appendEdge(E, 2, 3);
+    printf("Build past the budget should be NULL -> %s\n",
+           newGraphFromEdges(E, 1, 0, 2) == NULL ? "NULL" : "Graph");
+    setMemoryBudget(0);
+    freeEdgeList(&E);
+    freeGraph(&C);
+    printf("Charged after freeGraph should be %zu -> %zu\n", gm.total, getMemoryCharged());
+    printf("\n");
+
+    // Tests the status-returning variants on bad input, which must not exit
+    printf("Testing status-returning variants\n");
+    Vertex value;
+    printf("tryNewGraph(-1) should be %s -> %s\n", graphStatusName(GRAPH_OUT_OF_RANGE),
+           graphStatusName(tryNewGraph(-1, &C)));
+    printf("tryNewGraph(3) should be ok -> %s\n", graphStatusName(tryNewGraph(3, &C)));
+    printf("tryGetPath before BFS should be %s -> %s\n", graphStatusName(GRAPH_BAD_STATE),
+           graphStatusName(tryGetPath(L, C, 2)));
+    printf("tryAddEdge(1, 4) should be %s -> %s\n", graphStatusName(GRAPH_OUT_OF_RANGE),
+           graphStatusName(tryAddEdge(C, 1, 4)));
+    tryAddEdge(C, 1, 2);
+    tryAddEdge(C, 3, 2);
+    printf("tryBFS(NULL) should be %s -> %s\n", graphStatusName(GRAPH_NULL_ARGUMENT),
+           graphStatusName(tryBFS(NULL, 1)));
+    tryBFS(C, 1);
+    tryGetDist(C, 3, &value);
+    printf("Distance from 1 to 3 should be 2 -> %" PRIvertex "\n", value);
+    clear(L);
+    tryGetPath(L, C, 3);
+    printf("Path from 1 to 3 should be 1 2 3 -> ");
+    printList(stdout, L);
+    printf("\ntryGet with no cursor should be %s -> %s\n", graphStatusName(GRAPH_BAD_STATE),
+           graphStatusName(tryGet(L, &value)));
+    tryDeleteFront(L);
+    tryFront(L, &value);
+    printf("Front after tryDeleteFront should be 2 -> %" PRIvertex "\n", value);
+    clear(L);
+    printf("tryDeleteBack on empty List should be %s -> %s\n", graphStatusName(GRAPH_BAD_STATE),
+           graphStatusName(tryDeleteBack(L)));
+    freeGraph(&C);
     printf("\n");
 
     // Frees Memory
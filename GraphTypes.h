@@ -0,0 +1,54 @@
+//-----------------------------------------------------------------------------
+// GraphTypes.h
+// Index types shared by the List and Graph ADTs
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_GRAPHTYPES_H
+#define GRAPHADT_GRAPHTYPES_H
+
+#include <stdint.h>
+#include <inttypes.h>
+
+// Vertex ---------------------------------------------------------------------
+// Vertex IDs, and the List data that stores them, are 32-bit by default to
+// keep adjacency and per-vertex arrays cache friendly. Building with
+// GRAPHADT_VERTEX64 defined (cmake -DGRAPHADT_VERTEX64=ON) widens them to
+// 64-bit for graphs with more than 2^31 - 1 vertices.
+#ifdef GRAPHADT_VERTEX64
+typedef int64_t Vertex;
+#define VERTEX_MAX INT64_MAX
+#define PRIvertex PRId64
+#define SCNvertex SCNd64
+#else
+typedef int32_t Vertex;
+#define VERTEX_MAX INT32_MAX
+#define PRIvertex PRId32
+#define SCNvertex SCNd32
+#endif
+
+// EdgeIndex ------------------------------------------------------------------
+// Edge counts, List lengths and adjacency offsets. Always 64-bit, since even a
+// graph with 32-bit vertex IDs can hold more than 2^31 edges.
+typedef int64_t EdgeIndex;
+#define EDGEINDEX_MAX INT64_MAX
+#define PRIedge PRId64
+#define SCNedge SCNd64
+
+// Weight ---------------------------------------------------------------------
+// Edge weights. Single precision keeps a weighted edge at 12 bytes with
+// 32-bit vertices; totals over many edges are accumulated in double.
+typedef float Weight;
+
+// GraphStatus ----------------------------------------------------------------
+// Result of the try...() variants of List and Graph operations, which return
+// a failed precondition to the caller where the plain operations print an
+// error and exit. graphStatusName() (Graph.h) names each value.
+typedef enum GraphStatus {
+    GRAPH_OK = 0,
+    GRAPH_NULL_ARGUMENT,   // a required reference was NULL
+    GRAPH_OUT_OF_RANGE,    // a vertex or order outside the Graph's range
+    GRAPH_BAD_STATE,       // empty List, undefined cursor, or no BFS source
+    GRAPH_NO_MEMORY        // the memory budget (Memory.h) was exhausted
+} GraphStatus;
+
+#endif //GRAPHADT_GRAPHTYPES_H
@@ -0,0 +1,189 @@
+//-----------------------------------------------------------------------------
+// HybridBFS.c
+// Implementation file for direction-optimizing BFS over bitmap frontiers
+//-----------------------------------------------------------------------------
+
+#include <string.h>
+#include "HybridBFS.h"
+#include "Bitmap.h"
+
+// Go bottom-up once the frontier's out-arcs exceed 1 / HYBRID_ALPHA of the
+// arcs still unexplored, and back top-down once the frontier shrinks below
+// 1 / HYBRID_BETA of the vertices (Beamer, Asanovic and Patterson)
+#define HYBRID_ALPHA 14
+#define HYBRID_BETA 24
+
+// structs --------------------------------------------------------------------
+
+// private HybridState type: one traversal in progress
+typedef struct HybridState {
+    Vertex n;
+    const EdgeIndex *offset;
+    const Vertex *target;
+    const EdgeIndex *inOffset;
+    const Vertex *inSource;
+    Vertex *distance;
+    Vertex *parent;
+
+    // Frontier as a queue (top-down) or a bitmap (bottom-up)
+    Vertex *queue;
+    Vertex queued;
+    uint64_t *front;
+    uint64_t *next;
+    uint64_t *visited;
+    EdgeIndex words;
+} HybridState;
+
+
+// outDegree()
+// Returns the number of arcs out of u.
+// Private.
+static EdgeIndex outDegree(const HybridState *H, Vertex u) {
+    return H->offset[u + 1] - H->offset[u];
+}
+
+// topDown()
+// Expands the queued frontier at distance level into next, queued in turn.
+// Returns the out-arcs of the new frontier.
+// Private.
+static EdgeIndex topDown(HybridState *H, Vertex level, Vertex *next) {
+    EdgeIndex arcs = 0;
+    Vertex count = 0;
+
+    for (Vertex i = 0; i < H->queued; i++) {
+        Vertex u = H->queue[i];
+        for (EdgeIndex e = H->offset[u]; e < H->offset[u + 1]; e++) {
+            Vertex v = H->target[e];
+            if (!BITMAP_TEST(H->visited, v)) {
+                BITMAP_SET(H->visited, v);
+                H->distance[v] = level + 1;
+                H->parent[v] = u;
+                next[count++] = v;
+                arcs += outDegree(H, v);
+            }
+        }
+    }
+    H->queued = count;
+    return arcs;
+}
+
+// bottomUp()
+// Gives every unvisited vertex with an in-neighbor in the front bitmap, at
+// distance level, that neighbor as parent, collecting them in the next
+// bitmap, which is then folded into visited and becomes the front. Sets
+// *arcs to the out-arcs of the new frontier and returns its size.
+// Private.
+static Vertex bottomUp(HybridState *H, Vertex level, EdgeIndex *arcs) {
+    EdgeIndex total = 0;
+
+    memset(H->next, 0, sizeof(uint64_t) * (size_t) H->words);
+    for (EdgeIndex w = 0; w < H->words; w++) {
+        uint64_t open = ~H->visited[w];
+        while (open != 0) {
+            Vertex v = (Vertex) (w * 64 + __builtin_ctzll(open));
+            const Vertex *in = H->inSource + H->inOffset[v];
+            EdgeIndex len = H->inOffset[v + 1] - H->inOffset[v];
+            EdgeIndex k = bitmapFindAny(H->front, in, len);
+
+            open &= open - 1;
+            if (k < len) {
+                BITMAP_SET(H->next, v);
+                H->distance[v] = level + 1;
+                H->parent[v] = in[k];
+                total += outDegree(H, v);
+            }
+        }
+    }
+    *arcs = total;
+
+    Vertex count = (Vertex) bitmapMerge(H->visited, H->next, H->words);
+    uint64_t *t = H->front;
+    H->front = H->next;
+    H->next = t;
+    return count;
+}
+
+// hybridBFS()
+// Alternates top-down and bottom-up levels by the frontier's arc count.
+void hybridBFS(Graph G, Vertex s, Vertex *distance, Vertex *parent) {
+    if (G == NULL) {
+        printf("HybridBFS Error: hybridBFS() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (s < 1 || s > getOrder(G)) {
+        printf("HybridBFS Error: hybridBFS() called on vertex outside range of Graph\n");
+        exit(1);
+    }
+    if (distance == NULL || parent == NULL) {
+        printf("HybridBFS Error: hybridBFS() called on NULL result arrays\n");
+        exit(1);
+    }
+
+    HybridState H;
+    H.n = getOrder(G);
+    getAdjacency(G, &H.offset, &H.target);
+    getReverseAdjacency(G, &H.inOffset, &H.inSource);
+    H.distance = distance;
+    H.parent = parent;
+    H.words = BITMAP_WORDS(H.n);
+    H.queue = malloc(sizeof(Vertex) * ((size_t) H.n + 1));
+    Vertex *nextQueue = malloc(sizeof(Vertex) * ((size_t) H.n + 1));
+    H.front = calloc((size_t) H.words, sizeof(uint64_t));
+    H.next = calloc((size_t) H.words, sizeof(uint64_t));
+    H.visited = calloc((size_t) H.words, sizeof(uint64_t));
+
+    for (Vertex u = 1; u <= H.n; u++) {
+        distance[u] = INF;
+        parent[u] = NIL;
+    }
+
+    // Vertex 0 and the padding past n count as visited, so bottom-up steps
+    // never look at them
+    BITMAP_SET(H.visited, 0);
+    for (EdgeIndex v = (EdgeIndex) H.n + 1; v < H.words * 64; v++)
+        BITMAP_SET(H.visited, v);
+
+    distance[s] = 0;
+    BITMAP_SET(H.visited, s);
+    H.queue[0] = s;
+    H.queued = 1;
+
+    Vertex frontier = 1;
+    EdgeIndex frontierArcs = outDegree(&H, s);
+    EdgeIndex unexplored = H.offset[H.n + 1] - frontierArcs;
+    int bottom = 0;
+
+    for (Vertex level = 0; frontier > 0; level++) {
+        if (!bottom && frontierArcs > unexplored / HYBRID_ALPHA) {
+            // Queue to bitmap
+            memset(H.front, 0, sizeof(uint64_t) * (size_t) H.words);
+            for (Vertex i = 0; i < H.queued; i++)
+                BITMAP_SET(H.front, H.queue[i]);
+            bottom = 1;
+        } else if (bottom && frontier < H.n / HYBRID_BETA) {
+            // Bitmap to queue, in vertex order
+            H.queued = 0;
+            for (EdgeIndex w = 0; w < H.words; w++)
+                for (uint64_t bits = H.front[w]; bits != 0; bits &= bits - 1)
+                    H.queue[H.queued++] = (Vertex) (w * 64 + __builtin_ctzll(bits));
+            bottom = 0;
+        }
+
+        if (bottom) {
+            frontier = bottomUp(&H, level, &frontierArcs);
+        } else {
+            frontierArcs = topDown(&H, level, nextQueue);
+            frontier = H.queued;
+            Vertex *t = H.queue;
+            H.queue = nextQueue;
+            nextQueue = t;
+        }
+        unexplored -= frontierArcs;
+    }
+
+    free(H.queue);
+    free(nextQueue);
+    free(H.front);
+    free(H.next);
+    free(H.visited);
+}
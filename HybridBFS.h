@@ -0,0 +1,25 @@
+//-----------------------------------------------------------------------------
+// HybridBFS.h
+// Header file for direction-optimizing BFS over bitmap frontiers
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_HYBRIDBFS_H
+#define GRAPHADT_HYBRIDBFS_H
+
+#include"Graph.h"
+
+// hybridBFS()
+// Runs BFS from s, switching each level between top-down steps, which
+// expand the frontier's out-arcs as BFS() does, and bottom-up steps, which
+// let every unvisited vertex look for an in-neighbor in the frontier and stop
+// at the first. Bottom-up pays off in the dense middle levels, where most
+// arcs out of the frontier lead to vertices already visited. It reads the
+// reverse adjacency, building it if needed, and keeps the frontier and
+// visited set as bitmaps, scanned with the kernels of Bitmap.h.
+// Sets distance[u] and parent[u], for 1 <= u <= getOrder(G), to a BFS tree
+// from s: distances equal BFS()'s, but a vertex with several parents one
+// level up may be given a different one.
+// Precondition: 1 <= s <= getOrder(G)
+void hybridBFS(Graph G, Vertex s, Vertex *distance, Vertex *parent);
+
+#endif //GRAPHADT_HYBRIDBFS_H
@@ -0,0 +1,264 @@
+//-----------------------------------------------------------------------------
+// Intersect.c
+// Implementation file for sorted-array set intersection kernels
+//-----------------------------------------------------------------------------
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Intersect.h"
+
+// The SIMD kernels compare 32-bit lanes, so they are only built for x86 with
+// the default vertex width. Each is compiled for its own target and chosen
+// at run time, so the library itself needs no -m flags.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) \
+    && !defined(GRAPHADT_VERTEX64)
+#define INTERSECT_X86
+#include <immintrin.h>
+#endif
+
+// Galloping pays off once one side is this many times longer than the other
+#define GALLOP_RATIO 32
+
+typedef EdgeIndex (*MergeKernel)(const Vertex *, EdgeIndex, const Vertex *, EdgeIndex, Vertex *);
+
+static MergeKernel mergeKernel = intersectMerge;
+static const char *mergeKernelName = "scalar";
+static pthread_once_t kernelOnce = PTHREAD_ONCE_INIT;
+
+
+// Scalar kernels -------------------------------------------------------------
+
+// intersectMerge()
+// Scalar linear merge.
+EdgeIndex intersectMerge(const Vertex *a, EdgeIndex na, const Vertex *b, EdgeIndex nb, Vertex *out) {
+    EdgeIndex i = 0;
+    EdgeIndex j = 0;
+    EdgeIndex k = 0;
+
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (a[i] > b[j]) {
+            j++;
+        } else {
+            if (out != NULL)
+                out[k] = a[i];
+            k++;
+            i++;
+            j++;
+        }
+    }
+    return k;
+}
+
+// intersectGallop()
+// Looks up each element of a in b by exponential then binary search, never
+// moving backwards in b.
+EdgeIndex intersectGallop(const Vertex *a, EdgeIndex na, const Vertex *b, EdgeIndex nb, Vertex *out) {
+    EdgeIndex j = 0;
+    EdgeIndex k = 0;
+
+    for (EdgeIndex i = 0; i < na && j < nb; i++) {
+        Vertex x = a[i];
+
+        // Gallops to a window b[lo..hi] whose last element is >= x
+        EdgeIndex lo = j;
+        EdgeIndex step = 1;
+        while (j < nb && b[j] < x) {
+            lo = j + 1;
+            j += step;
+            step *= 2;
+        }
+        EdgeIndex hi = j < nb ? j : nb - 1;
+
+        // Binary search for the first element >= x
+        while (lo < hi) {
+            EdgeIndex mid = lo + (hi - lo) / 2;
+            if (b[mid] < x)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        j = lo;
+
+        if (j < nb && b[j] == x) {
+            if (out != NULL)
+                out[k] = x;
+            k++;
+            j++;
+        }
+    }
+    return k;
+}
+
+
+// SIMD kernels ---------------------------------------------------------------
+
+#ifdef INTERSECT_X86
+
+// Byte shuffles packing the 32-bit lanes selected by a 4-bit mask to the front
+static uint8_t shuffle4[16][16];
+
+// Lane permutations packing the lanes selected by an 8-bit mask to the front
+static int32_t permute8[256][8];
+
+// buildTables()
+// Fills shuffle4 and permute8.
+// Private.
+static void buildTables(void) {
+    for (int mask = 0; mask < 16; mask++) {
+        int k = 0;
+        for (int lane = 0; lane < 4; lane++) {
+            if (mask & (1 << lane)) {
+                for (int byte = 0; byte < 4; byte++)
+                    shuffle4[mask][k * 4 + byte] = (uint8_t) (lane * 4 + byte);
+                k++;
+            }
+        }
+        for (; k < 4; k++)
+            for (int byte = 0; byte < 4; byte++)
+                shuffle4[mask][k * 4 + byte] = 0x80;
+    }
+    for (int mask = 0; mask < 256; mask++) {
+        int k = 0;
+        for (int lane = 0; lane < 8; lane++)
+            if (mask & (1 << lane))
+                permute8[mask][k++] = lane;
+        for (; k < 8; k++)
+            permute8[mask][k] = 0;
+    }
+}
+
+// intersectSSE()
+// Compares 4x4 blocks with all four rotations of b's block; lanes of a that
+// matched are packed with a byte shuffle.
+// Private.
+__attribute__((target("ssse3")))
+static EdgeIndex intersectSSE(const Vertex *a, EdgeIndex na, const Vertex *b, EdgeIndex nb, Vertex *out) {
+    EdgeIndex i = 0;
+    EdgeIndex j = 0;
+    EdgeIndex k = 0;
+    EdgeIndex na4 = na & ~(EdgeIndex) 3;
+    EdgeIndex nb4 = nb & ~(EdgeIndex) 3;
+
+    while (i < na4 && j < nb4) {
+        __m128i va = _mm_loadu_si128((const __m128i *) (a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *) (b + j));
+
+        __m128i m0 = _mm_cmpeq_epi32(va, vb);
+        __m128i m1 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)));
+        __m128i m2 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+        __m128i m3 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3))));
+
+        if (mask != 0) {
+            if (out != NULL) {
+                __m128i pack = _mm_loadu_si128((const __m128i *) shuffle4[mask]);
+                _mm_storeu_si128((__m128i *) (out + k), _mm_shuffle_epi8(va, pack));
+            }
+            k += __builtin_popcount((unsigned) mask);
+        }
+
+        Vertex amax = a[i + 3];
+        Vertex bmax = b[j + 3];
+        if (amax <= bmax)
+            i += 4;
+        if (bmax <= amax)
+            j += 4;
+    }
+
+    return k + intersectMerge(a + i, na - i, b + j, nb - j, out != NULL ? out + k : NULL);
+}
+
+// intersectAVX2()
+// Compares 8x8 blocks with all eight rotations of b's block; lanes of a that
+// matched are packed with a lane permutation.
+// Private.
+__attribute__((target("avx2")))
+static EdgeIndex intersectAVX2(const Vertex *a, EdgeIndex na, const Vertex *b, EdgeIndex nb, Vertex *out) {
+    EdgeIndex i = 0;
+    EdgeIndex j = 0;
+    EdgeIndex k = 0;
+    EdgeIndex na8 = na & ~(EdgeIndex) 7;
+    EdgeIndex nb8 = nb & ~(EdgeIndex) 7;
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+
+    while (i < na8 && j < nb8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *) (a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *) (b + j));
+
+        __m256i match = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; r++) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+        }
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(match));
+
+        if (mask != 0) {
+            if (out != NULL) {
+                __m256i pack = _mm256_loadu_si256((const __m256i *) permute8[mask]);
+                _mm256_storeu_si256((__m256i *) (out + k), _mm256_permutevar8x32_epi32(va, pack));
+            }
+            k += __builtin_popcount((unsigned) mask);
+        }
+
+        Vertex amax = a[i + 7];
+        Vertex bmax = b[j + 7];
+        if (amax <= bmax)
+            i += 8;
+        if (bmax <= amax)
+            j += 8;
+    }
+
+    return k + intersectSSE(a + i, na - i, b + j, nb - j, out != NULL ? out + k : NULL);
+}
+
+#endif
+
+
+// Dispatch -------------------------------------------------------------------
+
+// selectKernel()
+// Picks the widest merge kernel this CPU supports, capped by GRAPHADT_SIMD as
+// Bitmap.c's kernels are. Runs once.
+// Private.
+static void selectKernel(void) {
+#ifdef INTERSECT_X86
+    const char *cap = getenv("GRAPHADT_SIMD");
+    int any = cap == NULL || strcmp(cap, "scalar") != 0;
+    int wide = any && (cap == NULL || strcmp(cap, "ssse3") != 0);
+
+    buildTables();
+    __builtin_cpu_init();
+    if (wide && __builtin_cpu_supports("avx2")) {
+        mergeKernel = intersectAVX2;
+        mergeKernelName = "avx2";
+    } else if (any && __builtin_cpu_supports("ssse3")) {
+        mergeKernel = intersectSSE;
+        mergeKernelName = "ssse3";
+    }
+#endif
+}
+
+// intersectSorted()
+// Gallops when one array is much longer than the other, otherwise merges with
+// the widest SIMD kernel available.
+EdgeIndex intersectSorted(const Vertex *a, EdgeIndex na, const Vertex *b, EdgeIndex nb, Vertex *out) {
+    pthread_once(&kernelOnce, selectKernel);
+
+    if (na == 0 || nb == 0)
+        return 0;
+    if (na * GALLOP_RATIO < nb)
+        return intersectGallop(a, na, b, nb, out);
+    if (nb * GALLOP_RATIO < na)
+        return intersectGallop(b, nb, a, na, out);
+    return mergeKernel(a, na, b, nb, out);
+}
+
+// intersectKernel()
+// Returns the name of the merge kernel intersectSorted() dispatches to.
+const char *intersectKernel(void) {
+    pthread_once(&kernelOnce, selectKernel);
+    return mergeKernelName;
+}
@@ -0,0 +1,42 @@
+//-----------------------------------------------------------------------------
+// Intersect.h
+// Header file for sorted-array set intersection kernels
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_INTERSECT_H
+#define GRAPHADT_INTERSECT_H
+
+#include"GraphTypes.h"
+
+// Extra entries an output buffer needs beyond min(na, nb): the SIMD kernels
+// store whole vector blocks and may write past the last match.
+#define INTERSECT_PAD 8
+
+// All kernels take two strictly increasing arrays a[0..na-1] and b[0..nb-1],
+// such as adjacency ranges from getAdjacency() with duplicates removed. They
+// return the number of common elements and, when out is not NULL, write them
+// to out in increasing order; out must have room for min(na, nb) +
+// INTERSECT_PAD entries.
+
+// intersectSorted()
+// Dispatching entry point: gallops when one array is much longer than the
+// other, otherwise uses the widest SIMD merge the CPU supports. Setting the
+// GRAPHADT_SIMD environment variable to "ssse3" or "scalar" caps the merge,
+// as it does the kernels of Bitmap.h.
+EdgeIndex intersectSorted(const Vertex *a, EdgeIndex na, const Vertex *b, EdgeIndex nb, Vertex *out);
+
+// intersectMerge()
+// Scalar linear merge. O(na + nb).
+EdgeIndex intersectMerge(const Vertex *a, EdgeIndex na, const Vertex *b, EdgeIndex nb, Vertex *out);
+
+// intersectGallop()
+// Looks up each element of a in b by exponential search.
+// O(na log(nb / na)), best when na << nb.
+EdgeIndex intersectGallop(const Vertex *a, EdgeIndex na, const Vertex *b, EdgeIndex nb, Vertex *out);
+
+// intersectKernel()
+// Returns the name of the merge kernel intersectSorted() dispatches to on this
+// CPU: "avx2", "ssse3" or "scalar".
+const char *intersectKernel(void);
+
+#endif //GRAPHADT_INTERSECT_H
@@ -9,7 +9,7 @@
 
 // private NodeObj type
 typedef struct NodeObj {
-    int data;
+    Vertex data;
     struct NodeObj *next;
     struct NodeObj *prev;
 } NodeObj;
@@ -22,17 +22,21 @@ typedef struct ListObj {
     Node front;
     Node back;
     Node cursor;
-    int length;
-    int cIndex;
+    EdgeIndex length;
+    EdgeIndex cIndex;
 } ListObj;
 
+// Heap bytes malloc() hands out for a request of n bytes: n plus an 8-byte
+// header, rounded up to 16 and at least 32, as glibc does on 64-bit targets
+#define CHUNK_BYTES(n) ((n) + 8 < 32 ? (size_t) 32 : ((size_t) (n) + 8 + 15) & ~(size_t) 15)
+
 
 // Constructors-Destructors ---------------------------------------------------
 
 // newNode()
 // Returns reference to new Node object. Initializes next and data fields.
 // Private.
-Node newNode(int data) {
+Node newNode(Vertex data) {
     Node N = malloc(sizeof(NodeObj));
     N->data = data;
     N->next = NULL;
@@ -50,6 +54,132 @@ void freeNode(Node *pN) {
     }
 }
 
+
+// Unchecked primitives -------------------------------------------------------
+// Shared by the checked operations and their try...() variants, which have
+// already validated L and its cursor.
+
+// linkBefore()
+// Inserts data before the cursor.
+// Private.
+static void linkBefore(List L, Vertex data) {
+    Node N = newNode(data);
+    Node n1 = L->cursor->prev;
+
+    if (n1 == NULL) {
+        N->prev = NULL;
+        L->front = N;
+    } else {
+        N->prev = n1;
+        n1->next = N;
+    }
+
+    N->next = L->cursor;
+    L->cursor->prev = N;
+
+    L->length++;
+    L->cIndex++;
+}
+
+// linkAfter()
+// Inserts data after the cursor.
+// Private.
+static void linkAfter(List L, Vertex data) {
+    Node N = newNode(data);
+    Node n1 = L->cursor->next;
+
+    if (n1 == NULL) {
+        N->next = NULL;
+        L->back = N;
+    } else {
+        N->next = n1;
+        n1->prev = N;
+    }
+
+    N->prev = L->cursor;
+    L->cursor->next = N;
+
+    L->length++;
+}
+
+// unlinkFront()
+// Deletes the front element of non-empty L.
+// Private.
+static void unlinkFront(List L) {
+    Node n0 = L->front;
+    Node n1 = n0->next;
+
+    if (n1 != NULL) {
+        L->front = n1;
+        L->front->prev = NULL;
+    } else {
+        L->front = NULL;
+        L->back = NULL;
+    }
+
+    if (L->cIndex > -1) {
+        L->cIndex--;
+        if (L->cIndex < 0) {
+            L->cursor = NULL;
+        }
+    }
+
+    freeNode(&n0);
+    L->length--;
+}
+
+// unlinkBack()
+// Deletes the back element of non-empty L.
+// Private.
+static void unlinkBack(List L) {
+    Node n0 = L->back;
+    Node n1 = n0->prev;
+
+
+    if (n1 != NULL) {
+        L->back = n1;
+        L->back->next = NULL;
+    } else {
+        L->front = NULL;
+        L->back = NULL;
+    }
+
+    if (L->cIndex == (L->length - 1)) {
+        L->cIndex = -1;
+        L->cursor = NULL;
+    }
+
+    freeNode(&n0);
+    L->length--;
+}
+
+// unlinkCursor()
+// Deletes the cursor element, leaving the cursor undefined.
+// Private.
+static void unlinkCursor(List L) {
+    Node n0 = L->cursor;
+    Node n1 = n0->prev;
+    Node n2 = n0->next;
+
+    // If front, back, single element, else
+    if (n1 == NULL && n2 != NULL) {
+        unlinkFront(L);
+    } else if (n2 == NULL && n1 != NULL) {
+        unlinkBack(L);
+    } else if (n1 == NULL) {
+        unlinkFront(L);
+    } else {
+        n1->next = n2;
+        n2->prev = n1;
+        freeNode(&n0);
+        L->length--;
+    }
+
+    L->cIndex = -1;
+    L->cursor = NULL;
+}
+
+
 // newList()
 // Returns reference to new empty List object.
 List newList(void) {
@@ -79,7 +209,7 @@ void freeList(struct ListObj **pL) {
 
 // length()
 // Returns the length of L.
-int length(List L) {
+EdgeIndex length(List L) {
     if (L == NULL) {
         printf("List Error: length() called on NULL List reference\n");
         exit(1);
@@ -89,7 +219,7 @@ int length(List L) {
 
 // index1()
 // Returns the index1 of cursor or -1 if undefined
-int index1(List L) {
+EdgeIndex index1(List L) {
     if (L == NULL) {
         printf("List Error: index1() called on NULL List reference\n");
         exit(1);
@@ -103,7 +233,7 @@ int index1(List L) {
 // front()
 // Returns the value at the front of L.
 // Pre: !isEmpty(L)
-int front(List L) {
+Vertex front(List L) {
     if (L == NULL) {
         printf("List Error: front() called on NULL List reference\n");
         exit(1);
@@ -118,7 +248,7 @@ int front(List L) {
 // back()
 // Returns the value at the back of L.
 // Pre: !isEmpty(L)
-int back(List L) {
+Vertex back(List L) {
     if (L == NULL) {
         printf("List Error: back() called on NULL List reference\n");
         exit(1);
@@ -133,7 +263,7 @@ int back(List L) {
 // get()
 // returns the cursor element
 // Pre: !isEmpty(L) & index1(L)>=0
-int get(List L) {
+Vertex get(List L) {
     if (L == NULL) {
         printf("List Error: get() called on NULL List reference\n");
         exit(1);
@@ -186,8 +316,20 @@ int isEmpty(List L) {
 // clear()
 // Resets the list to original empty state.
 void clear(List L) {
-    while (!isEmpty(L))
-        deleteFront(L);
+    if (L == NULL) {
+        printf("List Error: clear() called on NULL List reference\n");
+        exit(1);
+    }
+
+    Node N = L->front;
+    while (N != NULL) {
+        Node next = N->next;
+        free(N);
+        N = next;
+    }
+    L->front = L->back = L->cursor = NULL;
+    L->length = 0;
+    L->cIndex = -1;
 }
 
 // moveFront()
@@ -258,7 +400,7 @@ void moveNext(List L) {
 
 // prepend()
 // Insert the element at the front of List
-void prepend(List L, int data) {
+void prepend(List L, Vertex data) {
     if (L == NULL) {
         printf("List Error: prepend() called on NULL List reference\n");
         exit(1);
@@ -283,7 +425,7 @@ void prepend(List L, int data) {
 
 // append()
 // Insert the element at the back of List
-void append(List L, int data) {
+void append(List L, Vertex data) {
     if (L == NULL) {
         printf("List Error: append() called on NULL List reference\n");
         exit(1);
@@ -305,7 +447,7 @@ void append(List L, int data) {
 // insertBefore()
 // Insert the element before the cursor
 // Pre: !isEmpty(L) & index1(L)>=0
-void insertBefore(List L, int data) {
+void insertBefore(List L, Vertex data) {
     if (L == NULL) {
         printf("List Error: insertBefore() called on NULL List reference\n");
         exit(1);
@@ -317,28 +459,13 @@ void insertBefore(List L, int data) {
         exit(1);
     }
 
-    Node N = newNode(data);
-    Node n1 = L->cursor->prev;
-
-    if (n1 == NULL) {
-        N->prev = NULL;
-        L->front = N;
-    } else {
-        N->prev = n1;
-        n1->next = N;
-    }
-
-    N->next = L->cursor;
-    L->cursor->prev = N;
-
-    L->length++;
-    L->cIndex++;
+    linkBefore(L, data);
 }
 
 // insertAfter()
 // Insert the element after the cursor
 // Pre: !isEmpty(L) & index1(L)>=0
-void insertAfter(List L, int data) {
+void insertAfter(List L, Vertex data) {
     if (L == NULL) {
         printf("List Error: insertAfter() called on NULL List reference\n");
         exit(1);
@@ -350,21 +477,7 @@ void insertAfter(List L, int data) {
         exit(1);
     }
 
-    Node N = newNode(data);
-    Node n1 = L->cursor->next;
-
-    if (n1 == NULL) {
-        N->next = NULL;
-        L->back = N;
-    } else {
-        N->next = n1;
-        n1->prev = N;
-    }
-
-    N->prev = L->cursor;
-    L->cursor->next = N;
-
-    L->length++;
+    linkAfter(L, data);
 }
 
 // deleteFront()
@@ -379,26 +492,7 @@ void deleteFront(List L) {
         exit(1);
     }
 
-    Node n0 = L->front;
-    Node n1 = n0->next;
-
-    if (n1 != NULL) {
-        L->front = n1;
-        L->front->prev = NULL;
-    } else {
-        L->front = NULL;
-        L->back = NULL;
-    }
-
-    if (L->cIndex > -1) {
-        L->cIndex--;
-        if (L->cIndex < 0) {
-            L->cursor = NULL;
-        }
-    }
-
-    freeNode(&n0);
-    L->length--;
+    unlinkFront(L);
 }
 
 // deleteBack()
@@ -413,25 +507,7 @@ void deleteBack(List L) {
         exit(1);
     }
 
-    Node n0 = L->back;
-    Node n1 = n0->prev;
-
-
-    if (n1 != NULL) {
-        L->back = n1;
-        L->back->next = NULL;
-    } else {
-        L->front = NULL;
-        L->back = NULL;
-    }
-
-    if (L->cIndex == (L->length - 1)) {
-        L->cIndex = -1;
-        L->cursor = NULL;
-    }
-
-    freeNode(&n0);
-    L->length--;
+    unlinkBack(L);
 }
 
 // delete()
@@ -449,26 +525,40 @@ void delete(List L) {
         exit(1);
     }
 
-    Node n0 = L->cursor;
-    Node n1 = n0->prev;
-    Node n2 = n0->next;
+    unlinkCursor(L);
+}
 
-    // If front, back, single element, else
-    if (n1 == NULL && n2 != NULL) {
-        deleteFront(L);
-    } else if (n2 == NULL && n1 != NULL) {
-        deleteBack(L);
-    } else if (n1 == NULL) {
-        deleteFront(L);
-    } else {
-        n1->next = n2;
-        n2->prev = n1;
-        freeNode(&n0);
-        L->length--;
-    }
+// insertSorted()
+// Walks the nodes of L directly, without the per-step checks of moveNext()
+// and get(), to the first element not below data.
+int insertSorted(List L, Vertex data, int unique, EdgeIndex *position) {
+    Node N = L->front;
+    EdgeIndex i = 0;
 
-    L->cIndex = -1;
-    L->cursor = NULL;
+    while (N != NULL && N->data < data) {
+        N = N->next;
+        i++;
+    }
+    *position = i;
+    if (unique && N != NULL && N->data == data)
+        return 0;
+
+    Node M = newNode(data);
+    M->next = N;
+    M->prev = N != NULL ? N->prev : L->back;
+    if (M->prev != NULL)
+        M->prev->next = M;
+    else
+        L->front = M;
+    if (N != NULL)
+        N->prev = M;
+    else
+        L->back = M;
+
+    if (L->cIndex >= i)
+        L->cIndex++;
+    L->length++;
+    return 1;
 }
 
 
@@ -489,7 +579,7 @@ void printList(FILE *out, struct ListObj *L) {
     Node N = NULL;
 
     for (N = L->front; N != NULL; N = N->next) {
-        fprintf(out, "%d ", N->data);
+        fprintf(out, "%" PRIvertex " ", N->data);
     }
 }
 
@@ -513,3 +603,137 @@ List copyList(List L) {
     return nL;
 }
 
+// toArray()
+// Copies the elements of L, front to back, into out. Leaves the cursor
+// untouched.
+void toArray(List L, Vertex *out) {
+    if (L == NULL) {
+        printf("List Error: toArray() called on NULL List reference\n");
+        exit(1);
+    }
+
+    EdgeIndex i = 0;
+    for (Node N = L->front; N != NULL; N = N->next)
+        out[i++] = N->data;
+}
+
+// listMemory()
+// Returns the heap bytes held by L, counting each malloc() chunk whole.
+size_t listMemory(List L) {
+    if (L == NULL) {
+        printf("List Error: listMemory() called on NULL List reference\n");
+        exit(1);
+    }
+    return listMemoryFor(L->length);
+}
+
+// listMemoryFor()
+// Returns the bytes listMemory() reports for a List of length elements.
+size_t listMemoryFor(EdgeIndex length) {
+    return CHUNK_BYTES(sizeof(ListObj)) + (size_t) length * CHUNK_BYTES(sizeof(NodeObj));
+}
+
+
+// Status-returning variants --------------------------------------------------
+
+// tryNewList()
+// Sets *pL to a new empty List, checking the allocation.
+GraphStatus tryNewList(List *pL) {
+    if (pL == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    *pL = malloc(sizeof(struct ListObj));
+    if (*pL == NULL)
+        return GRAPH_NO_MEMORY;
+    (*pL)->front = (*pL)->back = (*pL)->cursor = NULL;
+    (*pL)->length = 0;
+    (*pL)->cIndex = -1;
+    return GRAPH_OK;
+}
+
+// tryFront()
+// Sets *x to the front element of L.
+GraphStatus tryFront(List L, Vertex *x) {
+    if (L == NULL || x == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (L->length == 0)
+        return GRAPH_BAD_STATE;
+    *x = L->front->data;
+    return GRAPH_OK;
+}
+
+// tryBack()
+// Sets *x to the back element of L.
+GraphStatus tryBack(List L, Vertex *x) {
+    if (L == NULL || x == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (L->length == 0)
+        return GRAPH_BAD_STATE;
+    *x = L->back->data;
+    return GRAPH_OK;
+}
+
+// tryGet()
+// Sets *x to the cursor element of L.
+GraphStatus tryGet(List L, Vertex *x) {
+    if (L == NULL || x == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (L->cursor == NULL)
+        return GRAPH_BAD_STATE;
+    *x = L->cursor->data;
+    return GRAPH_OK;
+}
+
+// tryInsertBefore()
+// Inserts data before the cursor of L.
+GraphStatus tryInsertBefore(List L, Vertex data) {
+    if (L == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (L->cursor == NULL)
+        return GRAPH_BAD_STATE;
+    linkBefore(L, data);
+    return GRAPH_OK;
+}
+
+// tryInsertAfter()
+// Inserts data after the cursor of L.
+GraphStatus tryInsertAfter(List L, Vertex data) {
+    if (L == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (L->cursor == NULL)
+        return GRAPH_BAD_STATE;
+    linkAfter(L, data);
+    return GRAPH_OK;
+}
+
+// tryDeleteFront()
+// Deletes the front element of L.
+GraphStatus tryDeleteFront(List L) {
+    if (L == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (L->length == 0)
+        return GRAPH_BAD_STATE;
+    unlinkFront(L);
+    return GRAPH_OK;
+}
+
+// tryDeleteBack()
+// Deletes the back element of L.
+GraphStatus tryDeleteBack(List L) {
+    if (L == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (L->length == 0)
+        return GRAPH_BAD_STATE;
+    unlinkBack(L);
+    return GRAPH_OK;
+}
+
+// tryDelete()
+// Deletes the cursor element of L.
+GraphStatus tryDelete(List L) {
+    if (L == NULL)
+        return GRAPH_NULL_ARGUMENT;
+    if (L->cursor == NULL)
+        return GRAPH_BAD_STATE;
+    unlinkCursor(L);
+    return GRAPH_OK;
+}
@@ -8,6 +8,7 @@
 
 #include<stdio.h>
 #include<stdlib.h>
+#include"GraphTypes.h"
 
 // Exported type --------------------------------------------------------------
 typedef struct ListObj *List;
@@ -28,25 +29,25 @@ void freeList(List *pL);
 
 // length()
 // Returns the length of L.
-int length(List L);
+EdgeIndex length(List L);
 
 // index1()
 // Returns the index1 of Cursor.
-int index1(List L);
+EdgeIndex index1(List L);
 
 // front()
 // Returns the value at the front of L.
 // Pre: !isEmpty(L)
-int front(List L);
+Vertex front(List L);
 
 // back()
 // Returns the value at the back of L.
 // Pre: !isEmpty(L)
-int back(List L);
+Vertex back(List L);
 
 // get()
 // Returns the value the cursor is pointing to
-int get(List L);
+Vertex get(List L);
 
 // equals()
 // returns true (1) if A is identical to B, false (0) otherwise
@@ -77,19 +78,19 @@ void moveNext(List L);
 
 // prepend()
 // Inserts data at the back of list
-void prepend(List L, int data);
+void prepend(List L, Vertex data);
 
 // append()
 // Inserts data at the front of list
-void append(List L, int data);
+void append(List L, Vertex data);
 
 // insertBefore()
 // Inserts data before cursor
-void insertBefore(List L, int data);
+void insertBefore(List L, Vertex data);
 
 // insertAfter()
 // Inserts data after cursor
-void insertAfter(List L, int data);
+void insertAfter(List L, Vertex data);
 
 // deleteFront()
 // Deletes the front element
@@ -103,6 +104,14 @@ void deleteBack(List L);
 // Deletes the element cursor is pointing to
 void delete(List L);
 
+// insertSorted()
+// Inserts data into L, kept in ascending order, before the first element not
+// below it, and sets *position to that element's index (or length(L) if
+// none). If unique is true and data is already there, inserts nothing and
+// returns false (0); otherwise returns true (1). Keeps the cursor on its
+// element. Unchecked: L and position must not be NULL.
+int insertSorted(List L, Vertex data, int unique, EdgeIndex *position);
+
 
 // Other Functions ------------------------------------------------------------
 
@@ -114,8 +123,65 @@ void printList(FILE *out, List L);
 // Returns a copy of this list
 List copyList(List L);
 
+// toArray()
+// Copies the elements of L, front to back, into out, which must have room
+// for length(L) elements. Leaves the cursor untouched.
+void toArray(List L, Vertex *out);
+
 // isEmpty()
 // Returns true (1) if L is empty, otherwise returns false (0)
 int isEmpty(List L);
 
+// listMemory()
+// Returns the heap bytes held by L: its header and one node per element, each
+// counted as the whole chunk malloc() hands out for it.
+size_t listMemory(List L);
+
+// listMemoryFor()
+// Returns the bytes listMemory() reports for a List of length elements.
+size_t listMemoryFor(EdgeIndex length);
+
+
+// Status-returning variants --------------------------------------------------
+// Each returns GRAPH_NULL_ARGUMENT for a NULL reference and GRAPH_BAD_STATE
+// where the plain operation's precondition (non-empty L, defined cursor) does
+// not hold, leaving L unchanged, instead of printing an error and exiting.
+
+// tryNewList()
+// Sets *pL to a new empty List, or to NULL and returns GRAPH_NO_MEMORY if it
+// cannot be allocated.
+GraphStatus tryNewList(List *pL);
+
+// tryFront()
+// Sets *x to the front element of L.
+GraphStatus tryFront(List L, Vertex *x);
+
+// tryBack()
+// Sets *x to the back element of L.
+GraphStatus tryBack(List L, Vertex *x);
+
+// tryGet()
+// Sets *x to the cursor element of L.
+GraphStatus tryGet(List L, Vertex *x);
+
+// tryInsertBefore()
+// Inserts data before the cursor of L.
+GraphStatus tryInsertBefore(List L, Vertex data);
+
+// tryInsertAfter()
+// Inserts data after the cursor of L.
+GraphStatus tryInsertAfter(List L, Vertex data);
+
+// tryDeleteFront()
+// Deletes the front element of L.
+GraphStatus tryDeleteFront(List L);
+
+// tryDeleteBack()
+// Deletes the back element of L.
+GraphStatus tryDeleteBack(List L);
+
+// tryDelete()
+// Deletes the cursor element of L.
+GraphStatus tryDelete(List L);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,455 @@
+//-----------------------------------------------------------------------------
+// Loader.c
+// Implementation file for the pipelined parallel FindPath input loader
+//-----------------------------------------------------------------------------
+
+#include <limits.h>
+#include <pthread.h>
+#include <string.h>
+#include "Loader.h"
+#include "GraphIO.h"
+#include "Memory.h"
+#include "Parallel.h"
+#include "Sort.h"
+
+// Bytes the reader pulls from the input per fread()
+#define READ_BUFFER (1 << 20)
+
+// Edges per chunk handed from the reader to the builders
+#define CHUNK_EDGES (1 << 16)
+
+// Chunks the reader may run ahead of the builders before it blocks
+#define QUEUE_SLOTS 16
+
+// Parsed values saturate here: just past VERTEX_MAX, or at LLONG_MAX as
+// fscanf() does, so toVertex() still sees them without overflow
+#ifdef GRAPHADT_VERTEX64
+#define SCAN_LIMIT LLONG_MAX
+#else
+#define SCAN_LIMIT ((long long) VERTEX_MAX + 1)
+#endif
+
+// structs --------------------------------------------------------------------
+
+// private Scanner type: buffered number parser over the input file
+typedef struct Scanner {
+    FILE *in;
+    char *buf;
+    size_t pos;
+    size_t len;
+} Scanner;
+
+// private Chunk type: a batch of parsed edges in input order
+typedef struct Chunk {
+    Vertex u[CHUNK_EDGES];
+    Vertex v[CHUNK_EDGES];
+    int count;
+} Chunk;
+
+// private Bucket type: the arcs one builder has routed to one vertex block
+typedef struct Bucket {
+    Vertex *source;
+    Vertex *target;
+    EdgeIndex count;
+    EdgeIndex capacity;
+} Bucket;
+
+// private Pipeline type: state shared by the reader, builders and finalizers
+typedef struct Pipeline {
+    Scanner scanner;
+    Vertex n;
+    int threads;
+
+    // Vertices per block; block p owns p * block + 1 .. (p + 1) * block
+    Vertex block;
+
+    // Bounded chunk queue between the reader and the builders
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    Chunk *slot[QUEUE_SLOTS];
+    int head;
+    int count;
+    int closed;
+
+    // bucket[t * threads + p] holds builder t's arcs with sources in block p
+    Bucket *bucket;
+    EdgeIndex *edges;
+
+    EdgeIndex *offset;
+    Vertex *target;
+    EdgeIndex *blockBase;
+    int phase;
+
+    // Bytes of bucket space reserved against the memory budget, and set once
+    // a reservation is refused, which stops the reader and the builders
+    size_t reserved;
+    int failed;
+
+    EdgeList queries;
+} Pipeline;
+
+enum { PHASE_COUNT, PHASE_SCATTER };
+
+
+// Scanner --------------------------------------------------------------------
+
+// peekByte()
+// Returns the next input byte without consuming it, or EOF.
+// Private.
+static int peekByte(Scanner *S) {
+    if (S->pos == S->len) {
+        S->len = fread(S->buf, 1, READ_BUFFER, S->in);
+        S->pos = 0;
+        if (S->len == 0)
+            return EOF;
+    }
+    return (unsigned char) S->buf[S->pos];
+}
+
+// scanVertex()
+// Parses the next whitespace-separated integer into *x the way readVertex()
+// does. Returns 1 on success, 0 on end of input or malformed input.
+// Private.
+static int scanVertex(Scanner *S, Vertex *x) {
+    int c;
+    while ((c = peekByte(S)) == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f')
+        S->pos++;
+
+    int negative = 0;
+    if (c == '-' || c == '+') {
+        negative = c == '-';
+        S->pos++;
+        c = peekByte(S);
+    }
+    if (c < '0' || c > '9')
+        return 0;
+
+    long long value = 0;
+    while ((c = peekByte(S)) >= '0' && c <= '9') {
+        int d = c - '0';
+        value = value > (SCAN_LIMIT - d) / 10 ? SCAN_LIMIT : value * 10 + d;
+        S->pos++;
+    }
+
+    *x = toVertex(negative ? -value : value);
+    return 1;
+}
+
+// scanPair()
+// Parses a pair of vertex IDs. Returns 1 on success, 0 otherwise.
+// Private.
+static int scanPair(Scanner *S, Vertex *x, Vertex *y) {
+    return scanVertex(S, x) && scanVertex(S, y);
+}
+
+
+// Chunk queue ----------------------------------------------------------------
+
+// pushChunk()
+// Hands C to the builders, blocking while the queue is full.
+// Private.
+static void pushChunk(Pipeline *P, Chunk *C) {
+    pthread_mutex_lock(&P->lock);
+    while (P->count == QUEUE_SLOTS)
+        pthread_cond_wait(&P->notFull, &P->lock);
+    P->slot[(P->head + P->count) % QUEUE_SLOTS] = C;
+    P->count++;
+    pthread_cond_signal(&P->notEmpty);
+    pthread_mutex_unlock(&P->lock);
+}
+
+// closeQueue()
+// Tells the builders no more chunks are coming.
+// Private.
+static void closeQueue(Pipeline *P) {
+    pthread_mutex_lock(&P->lock);
+    P->closed = 1;
+    pthread_cond_broadcast(&P->notEmpty);
+    pthread_mutex_unlock(&P->lock);
+}
+
+// popChunk()
+// Returns the next chunk, blocking while the queue is empty, or NULL once it
+// is empty and closed.
+// Private.
+static Chunk *popChunk(Pipeline *P) {
+    pthread_mutex_lock(&P->lock);
+    while (P->count == 0 && !P->closed)
+        pthread_cond_wait(&P->notEmpty, &P->lock);
+
+    Chunk *C = NULL;
+    if (P->count > 0) {
+        C = P->slot[P->head];
+        P->head = (P->head + 1) % QUEUE_SLOTS;
+        P->count--;
+        pthread_cond_signal(&P->notFull);
+    }
+    pthread_mutex_unlock(&P->lock);
+    return C;
+}
+
+
+// Pipeline stages ------------------------------------------------------------
+
+// readInput()
+// Reader thread: parses the edge section into chunks, then the query section.
+// Private.
+static void *readInput(void *arg) {
+    Pipeline *P = arg;
+    Chunk *C = malloc(sizeof(Chunk));
+    Vertex u;
+    Vertex v;
+
+    C->count = 0;
+    while (scanPair(&P->scanner, &u, &v)) {
+        if (u == 0 && v == 0)
+            break;
+        C->u[C->count] = u;
+        C->v[C->count] = v;
+        if (++C->count == CHUNK_EDGES) {
+            pushChunk(P, C);
+            C = malloc(sizeof(Chunk));
+            C->count = 0;
+            if (__atomic_load_n(&P->failed, __ATOMIC_RELAXED))
+                break;
+        }
+    }
+    if (C->count > 0)
+        pushChunk(P, C);
+    else
+        free(C);
+    closeQueue(P);
+
+    // Query pairs overlap with the builders still draining the queue
+    if (P->queries != NULL && !__atomic_load_n(&P->failed, __ATOMIC_RELAXED)) {
+        while (scanPair(&P->scanner, &u, &v)) {
+            if (u == 0 && v == 0)
+                break;
+            appendEdge(P->queries, u, v);
+        }
+    }
+    return NULL;
+}
+
+// bucketArc()
+// Routes the arc (u, v) into builder t's bucket for u's block. Returns false
+// (0), with the arc dropped and P failed, if the bucket has to grow past the
+// memory budget.
+// Private.
+static int bucketArc(Pipeline *P, int t, Vertex u, Vertex v) {
+    Bucket *B = &P->bucket[(size_t) t * (size_t) P->threads + (size_t) ((u - 1) / P->block)];
+
+    if (B->count == B->capacity) {
+        EdgeIndex grow = B->capacity > 0 ? B->capacity : 1024;
+        size_t bytes = 2 * sizeof(Vertex) * (size_t) grow;
+        if (!reserveMemory(bytes)) {
+            __atomic_store_n(&P->failed, 1, __ATOMIC_RELAXED);
+            return 0;
+        }
+        __atomic_fetch_add(&P->reserved, bytes, __ATOMIC_RELAXED);
+        B->capacity += grow;
+        B->source = realloc(B->source, sizeof(Vertex) * (size_t) B->capacity);
+        B->target = realloc(B->target, sizeof(Vertex) * (size_t) B->capacity);
+        if (B->source == NULL || B->target == NULL) {
+            printf("Loader Error: loadGraph() unable to grow bucket to %" PRIedge " arcs\n", B->capacity);
+            exit(1);
+        }
+    }
+    B->source[B->count] = u;
+    B->target[B->count] = v;
+    B->count++;
+    return 1;
+}
+
+// buildChunks()
+// Builder thread body: buckets both arcs of every edge in each chunk it takes,
+// checking ranges the way addEdge() does. Once P has failed it only drains
+// the queue.
+// Private.
+static void buildChunks(int tid, int threads, void *arg) {
+    Pipeline *P = arg;
+    Chunk *C;
+    (void) threads;
+
+    while ((C = popChunk(P)) != NULL) {
+        if (__atomic_load_n(&P->failed, __ATOMIC_RELAXED))
+            C->count = 0;
+        for (int i = 0; i < C->count; i++) {
+            Vertex u = C->u[i];
+            Vertex v = C->v[i];
+            if (u < 1 || u > P->n) {
+                printf("Graph Error: addEdge() called on vertex u outside range of Graph\n");
+                exit(1);
+            }
+            if (v < 1 || v > P->n) {
+                printf("Graph Error: addEdge() called on vertex v outside range of Graph\n");
+                exit(1);
+            }
+            if (!bucketArc(P, tid, u, v) || !bucketArc(P, tid, v, u))
+                break;
+        }
+        P->edges[tid] += C->count;
+        free(C);
+    }
+}
+
+// finalizeBlock()
+// Finalizer body for block tid. PHASE_COUNT stores each source's degree in
+// offset[u + 1] and the block's arc total in blockBase[tid]; PHASE_SCATTER,
+// once blockBase holds the exclusive prefix, turns the degrees into offsets,
+// scatters the block's arcs and sorts each adjacency range.
+// Private.
+static void finalizeBlock(int tid, int threads, void *arg) {
+    Pipeline *P = arg;
+    EdgeIndex first = (EdgeIndex) tid * P->block;
+    Vertex lo = (Vertex) (first < P->n ? first + 1 : P->n + 1);
+    Vertex hi = (Vertex) (first + P->block < P->n ? first + P->block : P->n);
+
+    if (P->phase == PHASE_COUNT) {
+        EdgeIndex total = 0;
+        for (int t = 0; t < threads; t++) {
+            Bucket *B = &P->bucket[(size_t) t * (size_t) threads + (size_t) tid];
+            for (EdgeIndex i = 0; i < B->count; i++)
+                P->offset[B->source[i] + 1]++;
+            total += B->count;
+        }
+        P->blockBase[tid] = total;
+        return;
+    }
+
+    if (lo > hi)
+        return;
+
+    // cursor[u - lo] is the next free slot in u's range
+    EdgeIndex *cursor = malloc(sizeof(EdgeIndex) * (size_t) (hi - lo + 1));
+    EdgeIndex running = P->blockBase[tid];
+    for (Vertex u = lo; u <= hi; u++) {
+        cursor[u - lo] = running;
+        running += P->offset[u + 1];
+        P->offset[u + 1] = running;
+    }
+
+    for (int t = 0; t < threads; t++) {
+        Bucket *B = &P->bucket[(size_t) t * (size_t) threads + (size_t) tid];
+        for (EdgeIndex i = 0; i < B->count; i++)
+            P->target[cursor[B->source[i] - lo]++] = B->target[i];
+        free(B->source);
+        free(B->target);
+    }
+    free(cursor);
+
+    // offset[lo] belongs to the previous block, so ranges start from the base
+    EdgeIndex begin = P->blockBase[tid];
+    for (Vertex u = lo; u <= hi; u++) {
+        sortVertices(P->target + begin, P->offset[u + 1] - begin);
+        begin = P->offset[u + 1];
+    }
+}
+
+
+// loadGraph() ----------------------------------------------------------------
+
+// loadGraph()
+// Reads a FindPath input file with a reader thread feeding builder threads,
+// then finalizes the compact adjacency in parallel.
+Graph loadGraph(FILE *in, EdgeList *queries, int threads) {
+    if (in == NULL) {
+        printf("Loader Error: loadGraph() called on NULL FILE reference\n");
+        exit(1);
+    }
+    if (threads <= 0)
+        threads = defaultThreads();
+
+    Pipeline P;
+    memset(&P, 0, sizeof(P));
+    P.scanner.in = in;
+    P.scanner.buf = malloc(READ_BUFFER);
+
+    // Reads in number of Vertices to expect, which sizes the blocks
+    if (!scanVertex(&P.scanner, &P.n)) {
+        printf("GraphIO Error: readGraph() unable to read number of vertices\n");
+        exit(1);
+    }
+    if (P.n >= VERTEX_MAX) {
+        printf("Graph Error: newGraphCompact() called with order outside supported vertex range\n");
+        exit(1);
+    }
+    P.threads = threads;
+    P.block = P.n / threads + (P.n % threads != 0);
+    if (P.block == 0)
+        P.block = 1;
+    P.bucket = calloc((size_t) threads * (size_t) threads, sizeof(Bucket));
+    P.edges = calloc((size_t) threads, sizeof(EdgeIndex));
+    if (queries != NULL)
+        P.queries = newEdgeList(P.n, 1024);
+    pthread_mutex_init(&P.lock, NULL);
+    pthread_cond_init(&P.notEmpty, NULL);
+    pthread_cond_init(&P.notFull, NULL);
+
+    // Parsing and bucketing run concurrently
+    pthread_t reader;
+    if (pthread_create(&reader, NULL, readInput, &P) != 0) {
+        printf("Loader Error: loadGraph() unable to create reader thread\n");
+        exit(1);
+    }
+    parallelRun(threads, buildChunks, &P);
+    pthread_join(reader, NULL);
+
+    // Finalizes the compact adjacency, one vertex block per thread
+    EdgeIndex edges = 0;
+    for (int t = 0; t < threads; t++)
+        edges += P.edges[t];
+    size_t adjacency = sizeof(EdgeIndex) * ((size_t) P.n + 2)
+                       + sizeof(Vertex) * (size_t) (2 * edges > 0 ? 2 * edges : 1);
+    if (P.failed || !reserveMemory(adjacency)) {
+        for (int b = 0; b < threads * threads; b++) {
+            free(P.bucket[b].source);
+            free(P.bucket[b].target);
+        }
+        releaseMemory(P.reserved);
+        if (P.queries != NULL)
+            freeEdgeList(&P.queries);
+        pthread_mutex_destroy(&P.lock);
+        pthread_cond_destroy(&P.notEmpty);
+        pthread_cond_destroy(&P.notFull);
+        free(P.scanner.buf);
+        free(P.bucket);
+        free(P.edges);
+        return NULL;
+    }
+    P.offset = calloc((size_t) P.n + 2, sizeof(EdgeIndex));
+    P.target = malloc(sizeof(Vertex) * (size_t) (2 * edges > 0 ? 2 * edges : 1));
+    P.blockBase = malloc(sizeof(EdgeIndex) * (size_t) threads);
+    if (P.offset == NULL || P.target == NULL) {
+        printf("Loader Error: loadGraph() unable to allocate adjacency for %" PRIedge " edges\n", edges);
+        exit(1);
+    }
+
+    P.phase = PHASE_COUNT;
+    parallelRun(threads, finalizeBlock, &P);
+
+    EdgeIndex running = 0;
+    for (int p = 0; p < threads; p++) {
+        EdgeIndex total = P.blockBase[p];
+        P.blockBase[p] = running;
+        running += total;
+    }
+
+    P.phase = PHASE_SCATTER;
+    parallelRun(threads, finalizeBlock, &P);
+
+    if (queries != NULL)
+        *queries = P.queries;
+
+    pthread_mutex_destroy(&P.lock);
+    pthread_cond_destroy(&P.notEmpty);
+    pthread_cond_destroy(&P.notFull);
+    free(P.scanner.buf);
+    free(P.bucket);
+    free(P.edges);
+    free(P.blockBase);
+
+    releaseMemory(P.reserved + adjacency);
+    return newGraphCompact(P.n, P.offset, P.target, edges);
+}
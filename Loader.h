@@ -0,0 +1,26 @@
+//-----------------------------------------------------------------------------
+// Loader.h
+// Header file for the pipelined parallel FindPath input loader
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_LOADER_H
+#define GRAPHADT_LOADER_H
+
+#include"Graph.h"
+#include"EdgeList.h"
+
+// loadGraph()
+// Reads a FindPath input file from in and returns the same Graph readGraph()
+// builds, in compact form. A reader thread parses the text into edge chunks
+// while threads builder threads bucket their arcs by source vertex block, and
+// the adjacency is then finalized in parallel, one block per thread. If
+// queries is not NULL, the query section is also read and *queries is set to a
+// new EdgeList of its (source, destination) pairs; otherwise it is left
+// unread, at an unspecified position in in.
+// threads <= 0 means defaultThreads(). Exits on the same malformed input
+// readGraph() does. Returns NULL, leaving *queries unset and in unspecified,
+// if the buckets or the adjacency would grow past the memory budget (see
+// Memory.h).
+Graph loadGraph(FILE *in, EdgeList *queries, int threads);
+
+#endif //GRAPHADT_LOADER_H
@@ -0,0 +1,63 @@
+//-----------------------------------------------------------------------------
+// Memory.c
+// Implementation file for the process-wide memory budget charged by Graph
+// builders
+//-----------------------------------------------------------------------------
+
+#include "Memory.h"
+
+static size_t budget = 0;
+static size_t charged = 0;
+
+
+// setMemoryBudget()
+// Sets the budget in bytes; 0 (the default) means unlimited.
+void setMemoryBudget(size_t bytes) {
+    __atomic_store_n(&budget, bytes, __ATOMIC_RELAXED);
+}
+
+// getMemoryBudget()
+// Returns the budget in bytes, or 0 if unlimited.
+size_t getMemoryBudget(void) {
+    return __atomic_load_n(&budget, __ATOMIC_RELAXED);
+}
+
+// getMemoryCharged()
+// Returns the bytes currently charged by live Graphs and builders.
+size_t getMemoryCharged(void) {
+    return __atomic_load_n(&charged, __ATOMIC_RELAXED);
+}
+
+// memoryExceeded()
+// Returns true (1) if a budget is set and the charged bytes are past it.
+int memoryExceeded(void) {
+    size_t limit = getMemoryBudget();
+    return limit != 0 && getMemoryCharged() > limit;
+}
+
+// reserveMemory()
+// Adds bytes to the tally unless that would pass the budget, retrying if
+// another thread changed the tally in between.
+int reserveMemory(size_t bytes) {
+    size_t limit = getMemoryBudget();
+    size_t now = __atomic_load_n(&charged, __ATOMIC_RELAXED);
+
+    do {
+        if (limit != 0 && (bytes > limit || now > limit - bytes))
+            return 0;
+    } while (!__atomic_compare_exchange_n(&charged, &now, now + bytes, 1,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    return 1;
+}
+
+// chargeMemory()
+// Charges bytes whether or not they fit in the budget.
+void chargeMemory(size_t bytes) {
+    __atomic_fetch_add(&charged, bytes, __ATOMIC_RELAXED);
+}
+
+// releaseMemory()
+// Returns bytes charged earlier.
+void releaseMemory(size_t bytes) {
+    __atomic_fetch_sub(&charged, bytes, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,47 @@
+//-----------------------------------------------------------------------------
+// Memory.h
+// Header file for the process-wide memory budget charged by Graph builders
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_MEMORY_H
+#define GRAPHADT_MEMORY_H
+
+#include<stddef.h>
+
+// Every live Graph charges the bytes getGraphMemory() counts in its total to
+// a process-wide tally, and builders reserve what they are about to allocate
+// before allocating it. With a budget set, a builder whose reservation does
+// not fit frees what it has and returns NULL instead of growing past it.
+// Caches built lazily by queries (compact and reverse adjacency) are charged
+// when built but never refused, so the tally can exceed the budget by them.
+
+// setMemoryBudget()
+// Sets the budget in bytes; 0 (the default) means unlimited.
+void setMemoryBudget(size_t bytes);
+
+// getMemoryBudget()
+// Returns the budget in bytes, or 0 if unlimited.
+size_t getMemoryBudget(void);
+
+// getMemoryCharged()
+// Returns the bytes currently charged by live Graphs and builders.
+size_t getMemoryCharged(void);
+
+// memoryExceeded()
+// Returns true (1) if a budget is set and the charged bytes are past it.
+int memoryExceeded(void);
+
+// reserveMemory()
+// Charges bytes and returns true (1) if they fit in the budget, otherwise
+// charges nothing and returns false (0).
+int reserveMemory(size_t bytes);
+
+// chargeMemory()
+// Charges bytes whether or not they fit in the budget.
+void chargeMemory(size_t bytes);
+
+// releaseMemory()
+// Returns bytes charged earlier.
+void releaseMemory(size_t bytes);
+
+#endif //GRAPHADT_MEMORY_H
@@ -0,0 +1,219 @@
+//-----------------------------------------------------------------------------
+// PageRank.c
+// Implementation file for PageRank and personalized PageRank
+//-----------------------------------------------------------------------------
+
+#include "PageRank.h"
+#include "Parallel.h"
+
+// structs --------------------------------------------------------------------
+
+// private RankJob type: state shared by the threads of one ranking
+typedef struct RankJob {
+    Vertex n;
+    const EdgeIndex *offset;
+
+    // Reverse adjacency from getReverseAdjacency()
+    const EdgeIndex *inOffset;
+    const Vertex *source;
+
+    // Thread t owns vertices first[t] .. first[t + 1] - 1
+    Vertex *first;
+
+    float damping;
+    float base;
+    const float *teleport;
+    float *rank;
+    float *next;
+    float *contrib;
+
+    // Per-thread dangling rank, then L1 change
+    double *partial;
+    int phase;
+} RankJob;
+
+enum { PHASE_CONTRIB, PHASE_PULL };
+
+
+// splitRanges()
+// Divides vertices 1..n into threads contiguous ranges of about equal in-arcs
+// plus vertices, the work of one pull.
+// Private.
+static void splitRanges(RankJob *J, int threads) {
+    Vertex n = J->n;
+    double total = (double) J->inOffset[n + 1] + (double) n;
+
+    J->first = malloc(sizeof(Vertex) * ((size_t) threads + 1));
+    J->first[0] = 1;
+    for (int t = 1; t < threads; t++) {
+        double goal = total * t / threads;
+        Vertex lo = J->first[t - 1];
+        Vertex hi = n + 1;
+
+        // First vertex whose preceding work reaches goal
+        while (lo < hi) {
+            Vertex mid = lo + (hi - lo) / 2;
+            if ((double) J->inOffset[mid] + (double) (mid - 1) < goal)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        J->first[t] = lo;
+    }
+    J->first[threads] = n + 1;
+}
+
+// pullSum()
+// Returns the sum of the contributions of v's in-neighbors, in four
+// independent accumulators so the adds can overlap.
+// Private.
+static float pullSum(const RankJob *J, Vertex v) {
+    const Vertex *s = J->source;
+    const float *c = J->contrib;
+    EdgeIndex e = J->inOffset[v];
+    EdgeIndex end = J->inOffset[v + 1];
+    float a0 = 0;
+    float a1 = 0;
+    float a2 = 0;
+    float a3 = 0;
+
+    for (; e + 4 <= end; e += 4) {
+        a0 += c[s[e]];
+        a1 += c[s[e + 1]];
+        a2 += c[s[e + 2]];
+        a3 += c[s[e + 3]];
+    }
+    for (; e < end; e++)
+        a0 += c[s[e]];
+    return (a0 + a1) + (a2 + a3);
+}
+
+// rankWorker()
+// Runs the current phase of J over thread tid's vertex range.
+// Private.
+static void rankWorker(int tid, int threads, void *arg) {
+    RankJob *J = arg;
+    Vertex lo = J->first[tid];
+    Vertex hi = J->first[tid + 1];
+    double sum = 0;
+    (void) threads;
+
+    switch (J->phase) {
+        case PHASE_CONTRIB:
+            for (Vertex u = lo; u < hi; u++) {
+                EdgeIndex out = J->offset[u + 1] - J->offset[u];
+                if (out > 0) {
+                    J->contrib[u] = J->rank[u] / (float) out;
+                } else {
+                    J->contrib[u] = 0;
+                    sum += J->rank[u];
+                }
+            }
+            break;
+
+        case PHASE_PULL:
+            for (Vertex v = lo; v < hi; v++) {
+                float x = J->base * J->teleport[v] + J->damping * pullSum(J, v);
+                float d = x - J->rank[v];
+                J->next[v] = x;
+                sum += d < 0 ? -d : d;
+            }
+            break;
+    }
+    J->partial[tid] = sum;
+}
+
+// runPhase()
+// Runs one phase of J on threads threads and returns the sum of their partial
+// results.
+// Private.
+static double runPhase(RankJob *J, int phase, int threads) {
+    double sum = 0;
+    J->phase = phase;
+    parallelRun(threads, rankWorker, J);
+    for (int t = 0; t < threads; t++)
+        sum += J->partial[t];
+    return sum;
+}
+
+// pageRank()
+// Sets rank[u] to the (personalized) PageRank of u, returning the iterations.
+int pageRank(Graph G, float *rank, double damping, double tolerance, int maxIterations,
+             const float *personal, int threads) {
+    if (G == NULL) {
+        printf("PageRank Error: pageRank() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (rank == NULL) {
+        printf("PageRank Error: pageRank() called on NULL output array\n");
+        exit(1);
+    }
+    if (damping < 0 || damping >= 1 || maxIterations < 1) {
+        printf("PageRank Error: pageRank() called with invalid damping or iteration limit\n");
+        exit(1);
+    }
+    if (threads <= 0)
+        threads = defaultThreads();
+
+    RankJob J;
+    const Vertex *target;
+    J.n = getOrder(G);
+    getAdjacency(G, &J.offset, &target);
+    getReverseAdjacency(G, &J.inOffset, &J.source);
+    if (J.n == 0)
+        return 0;
+    if (threads > J.n)
+        threads = (int) J.n;
+
+    // Teleport distribution, which is also the starting rank
+    float *teleport = malloc(sizeof(float) * ((size_t) J.n + 1));
+    double weight = 0;
+    for (Vertex u = 1; u <= J.n; u++)
+        weight += personal != NULL ? (personal[u] > 0 ? personal[u] : 0) : 1;
+    if (weight <= 0) {
+        printf("PageRank Error: pageRank() called with no positive personalization weight\n");
+        exit(1);
+    }
+    teleport[0] = 0;
+    for (Vertex u = 1; u <= J.n; u++)
+        teleport[u] = (float) ((personal != NULL ? (personal[u] > 0 ? personal[u] : 0) : 1) / weight);
+
+    splitRanges(&J, threads);
+    J.damping = (float) damping;
+    J.teleport = teleport;
+    J.rank = rank;
+    J.next = malloc(sizeof(float) * ((size_t) J.n + 1));
+    J.contrib = malloc(sizeof(float) * ((size_t) J.n + 1));
+    J.partial = malloc(sizeof(double) * (size_t) threads);
+    for (Vertex u = 0; u <= J.n; u++)
+        rank[u] = teleport[u];
+
+    int iterations = 0;
+    while (iterations < maxIterations) {
+        double dangling = runPhase(&J, PHASE_CONTRIB, threads);
+        J.base = (float) (1.0 - damping + damping * dangling);
+        double change = runPhase(&J, PHASE_PULL, threads);
+        iterations++;
+
+        float *t = J.rank;
+        J.rank = J.next;
+        J.next = t;
+        if (change <= tolerance)
+            break;
+    }
+
+    // The latest ranks may be in the scratch buffer
+    if (J.rank != rank) {
+        for (Vertex u = 1; u <= J.n; u++)
+            rank[u] = J.rank[u];
+        J.next = J.rank;
+    }
+    rank[0] = 0;
+
+    free(teleport);
+    free(J.first);
+    free(J.next);
+    free(J.contrib);
+    free(J.partial);
+    return iterations;
+}
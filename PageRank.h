@@ -0,0 +1,33 @@
+//-----------------------------------------------------------------------------
+// PageRank.h
+// Header file for PageRank and personalized PageRank
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_PAGERANK_H
+#define GRAPHADT_PAGERANK_H
+
+#include"Graph.h"
+
+// Ranks are computed by power iteration in pull form: each vertex sums the
+// contributions of its in-neighbors, read from the Graph's cached
+// getReverseAdjacency(), so every thread writes only its own vertex range and
+// no atomics are needed.
+// Ranges are balanced by in-arcs. Arcs are followed as stored, so graphs built
+// with addArc() are ranked as directed; repeated arcs carry proportionally
+// more weight. Rank held by vertices without out-arcs is redistributed by the
+// teleport vector each iteration, so the ranks always sum to 1.
+// threads <= 0 means defaultThreads().
+
+// pageRank()
+// Sets rank[u], for 1 <= u <= getOrder(G), to the PageRank of u with the given
+// damping factor, and returns the number of iterations run. Iteration stops
+// once the L1 change between iterations drops to tolerance or below, or after
+// maxIterations. If personal is not NULL, personal[1..getOrder(G)] weights the
+// teleport target (personalized PageRank) and is normalized to sum to 1;
+// otherwise teleports are uniform.
+// Precondition: 0 <= damping < 1, maxIterations >= 1, personal has a positive
+// entry if not NULL
+int pageRank(Graph G, float *rank, double damping, double tolerance, int maxIterations,
+             const float *personal, int threads);
+
+#endif //GRAPHADT_PAGERANK_H
@@ -0,0 +1,494 @@
+//-----------------------------------------------------------------------------
+// Parallel.c
+// Implementation file for thread helpers shared by the parallel graph kernels
+//-----------------------------------------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <unistd.h>
+#include "Parallel.h"
+
+// structs --------------------------------------------------------------------
+
+// private Worker type: one thread's share of a parallelRun()
+typedef struct Worker {
+    void (*body)(int tid, int threads, void *arg);
+    void *arg;
+    int tid;
+    int threads;
+} Worker;
+
+// private PrefixJob type: a blocked prefix sum in progress
+typedef struct PrefixJob {
+    EdgeIndex *a;
+    EdgeIndex n;
+    EdgeIndex *blockSum;
+    int phase;
+} PrefixJob;
+
+// private Pool type: threads parked between parallelRun() calls. Pool thread
+// t runs tid t of each run with more than t threads; the caller runs tid 0.
+typedef struct Pool {
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    int size;
+    int busy;
+    unsigned long generation;
+    void (*body)(int tid, int threads, void *arg);
+    void *arg;
+    int threads;
+    int pending;
+} Pool;
+
+// private Seat type: a pool thread's tid and the last run it has seen
+typedef struct Seat {
+    int tid;
+    unsigned long seen;
+} Seat;
+
+// private Range type: a half-open range of parallelFor() items
+typedef struct Range {
+    EdgeIndex lo;
+    EdgeIndex hi;
+} Range;
+
+// private Deque type: one thread's pending ranges. The owner pushes and pops
+// at the tail, thieves take from the head, where the largest ranges are.
+typedef struct Deque {
+    pthread_mutex_t lock;
+    Range *task;
+    int head;
+    int tail;
+    int capacity;
+} __attribute__((aligned(64))) Deque;
+
+// private ForJob type: a parallelFor() in progress
+typedef struct ForJob {
+    const EdgeIndex *weight;
+    EdgeIndex grain;
+    void (*body)(EdgeIndex lo, EdgeIndex hi, int tid, void *arg);
+    void *arg;
+    Deque *deque;
+
+    // Items not yet run; the job is over when it reaches 0
+    EdgeIndex remaining;
+} ForJob;
+
+// Arrays shorter than this are summed on the calling thread
+#define PREFIX_SERIAL (1 << 16)
+
+// Adaptive grain: about this many ranges per thread, each of at least
+// PARALLEL_MIN_GRAIN cost, so stealing has slack without paying per item
+#define PARALLEL_SPLITS 16
+#define PARALLEL_MIN_GRAIN 256
+
+static Pool pool = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER,
+                     0, 0, 0, NULL, NULL, 0, 0 };
+static pthread_once_t poolOnce = PTHREAD_ONCE_INIT;
+
+// runWorker()
+// pthread entry point for a Worker.
+// Private.
+static void *runWorker(void *p) {
+    Worker *W = p;
+    W->body(W->tid, W->threads, W->arg);
+    return NULL;
+}
+
+
+// defaultThreads()
+// Returns GRAPHADT_THREADS if set and positive, otherwise the number of
+// online processors.
+int defaultThreads(void) {
+    const char *env = getenv("GRAPHADT_THREADS");
+    if (env != NULL && atoi(env) > 0)
+        return atoi(env);
+
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int) n : 1;
+}
+
+// spawnRun()
+// Runs body on threads - 1 new threads and the calling one, for runs that
+// find the pool busy.
+// Private.
+static void spawnRun(int threads, void (*body)(int tid, int threads, void *arg), void *arg) {
+    Worker *W = malloc(sizeof(Worker) * (size_t) threads);
+    pthread_t *T = malloc(sizeof(pthread_t) * (size_t) threads);
+
+    for (int t = 0; t < threads; t++) {
+        W[t].body = body;
+        W[t].arg = arg;
+        W[t].tid = t;
+        W[t].threads = threads;
+    }
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&T[t], NULL, runWorker, &W[t]) != 0) {
+            printf("Parallel Error: parallelRun() unable to create thread\n");
+            exit(1);
+        }
+    }
+    runWorker(&W[0]);
+    for (int t = 1; t < threads; t++)
+        pthread_join(T[t], NULL);
+
+    free(W);
+    free(T);
+}
+
+// poolThread()
+// pthread entry point for a pool thread: waits for each new run and takes
+// part if it has a tid in it.
+// Private.
+static void *poolThread(void *p) {
+    Seat *S = p;
+
+    for (;;) {
+        pthread_mutex_lock(&pool.lock);
+        while (pool.generation == S->seen)
+            pthread_cond_wait(&pool.wake, &pool.lock);
+        S->seen = pool.generation;
+        int threads = pool.threads;
+        void (*body)(int tid, int threads, void *arg) = pool.body;
+        void *arg = pool.arg;
+        pthread_mutex_unlock(&pool.lock);
+
+        if (S->tid < threads) {
+            body(S->tid, threads, arg);
+            pthread_mutex_lock(&pool.lock);
+            if (--pool.pending == 0)
+                pthread_cond_signal(&pool.done);
+            pthread_mutex_unlock(&pool.lock);
+        }
+    }
+    return NULL;
+}
+
+// resetPool()
+// pthread_atfork() child handler: the pool threads do not survive a fork, so
+// the child starts with an empty pool.
+// Private.
+static void resetPool(void) {
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.wake, NULL);
+    pthread_cond_init(&pool.done, NULL);
+    pool.size = 0;
+    pool.busy = 0;
+}
+
+// registerPool()
+// Registers resetPool() with pthread_atfork(). Runs once.
+// Private.
+static void registerPool(void) {
+    pthread_atfork(NULL, NULL, resetPool);
+}
+
+// growPool()
+// Starts pool threads until there are at least size. Called with the pool
+// locked, before the run they are to join is published.
+// Private.
+static void growPool(int size) {
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    while (pool.size < size) {
+        pthread_t thread;
+        Seat *S = malloc(sizeof(Seat));
+        S->tid = pool.size + 1;
+        S->seen = pool.generation;
+        if (pthread_create(&thread, &attr, poolThread, S) != 0) {
+            printf("Parallel Error: parallelRun() unable to create thread\n");
+            exit(1);
+        }
+        pool.size++;
+    }
+    pthread_attr_destroy(&attr);
+}
+
+// parallelRun()
+// Hands tids 1..threads-1 to the pool, runs tid 0 itself, and waits for the
+// pool to finish. Nested or concurrent runs, which find the pool busy, start
+// threads of their own instead.
+void parallelRun(int threads, void (*body)(int tid, int threads, void *arg), void *arg) {
+    if (body == NULL) {
+        printf("Parallel Error: parallelRun() called on NULL body\n");
+        exit(1);
+    }
+    if (threads <= 0)
+        threads = defaultThreads();
+    if (threads == 1) {
+        body(0, 1, arg);
+        return;
+    }
+
+    pthread_once(&poolOnce, registerPool);
+    pthread_mutex_lock(&pool.lock);
+    if (pool.busy) {
+        pthread_mutex_unlock(&pool.lock);
+        spawnRun(threads, body, arg);
+        return;
+    }
+    pool.busy = 1;
+    growPool(threads - 1);
+    pool.body = body;
+    pool.arg = arg;
+    pool.threads = threads;
+    pool.pending = threads - 1;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    body(0, threads, arg);
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.pending > 0)
+        pthread_cond_wait(&pool.done, &pool.lock);
+    pool.busy = 0;
+    pthread_mutex_unlock(&pool.lock);
+}
+
+// threadSlice()
+// Sets [*lo, *hi) to thread tid's share of 0..total-1.
+void threadSlice(EdgeIndex total, int tid, int threads, EdgeIndex *lo, EdgeIndex *hi) {
+    EdgeIndex size = (total + threads - 1) / threads;
+    *lo = (EdgeIndex) tid * size < total ? (EdgeIndex) tid * size : total;
+    *hi = *lo + size < total ? *lo + size : total;
+}
+
+// nextChunk()
+// Atomically claims the next chunk of at most chunk items from *next.
+int nextChunk(EdgeIndex *next, EdgeIndex end, EdgeIndex chunk, EdgeIndex *lo, EdgeIndex *hi) {
+    EdgeIndex start = __atomic_fetch_add(next, chunk, __ATOMIC_RELAXED);
+    if (start >= end)
+        return 0;
+    *lo = start;
+    *hi = start + chunk < end ? start + chunk : end;
+    return 1;
+}
+
+// cost()
+// Returns the cost of items lo..hi-1: one each, plus their weights.
+// Private.
+static EdgeIndex cost(const ForJob *F, EdgeIndex lo, EdgeIndex hi) {
+    EdgeIndex c = hi - lo;
+    if (F->weight != NULL)
+        c += F->weight[hi] - F->weight[lo];
+    return c;
+}
+
+// costPoint()
+// Returns the first m in lo..hi with cost(base, m) >= goal, or hi.
+// Private.
+static EdgeIndex costPoint(const ForJob *F, EdgeIndex base, EdgeIndex lo, EdgeIndex hi, EdgeIndex goal) {
+    while (lo < hi) {
+        EdgeIndex mid = lo + (hi - lo) / 2;
+        if (cost(F, base, mid) < goal)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// pushTask()
+// Pushes [lo, hi) at the tail of D.
+// Private.
+static void pushTask(Deque *D, EdgeIndex lo, EdgeIndex hi) {
+    pthread_mutex_lock(&D->lock);
+    if (D->tail == D->capacity) {
+        if (D->head > 0) {
+            memmove(D->task, D->task + D->head, sizeof(Range) * (size_t) (D->tail - D->head));
+            D->tail -= D->head;
+            D->head = 0;
+        } else {
+            D->capacity *= 2;
+            D->task = realloc(D->task, sizeof(Range) * (size_t) D->capacity);
+        }
+    }
+    D->task[D->tail].lo = lo;
+    D->task[D->tail].hi = hi;
+    D->tail++;
+    pthread_mutex_unlock(&D->lock);
+}
+
+// takeTask()
+// Removes the range at the tail (owner) or head (thief) of D into *r.
+// Returns true (1), or false (0) if D is empty.
+// Private.
+static int takeTask(Deque *D, int fromTail, Range *r) {
+    int found = 0;
+    pthread_mutex_lock(&D->lock);
+    if (D->head < D->tail) {
+        *r = fromTail ? D->task[--D->tail] : D->task[D->head++];
+        if (D->head == D->tail)
+            D->head = D->tail = 0;
+        found = 1;
+    }
+    pthread_mutex_unlock(&D->lock);
+    return found;
+}
+
+// forWorker()
+// Runs ranges from the thread's own deque, stealing when it is empty, until
+// every item has run. A range costing more than the grain is halved by cost
+// first, its upper half left in the deque for this thread or a thief.
+// Private.
+static void forWorker(int tid, int threads, void *arg) {
+    ForJob *F = arg;
+    Range r;
+
+    while (__atomic_load_n(&F->remaining, __ATOMIC_ACQUIRE) > 0) {
+        int found = takeTask(&F->deque[tid], 1, &r);
+        for (int k = 1; !found && k < threads; k++)
+            found = takeTask(&F->deque[(tid + k) % threads], 0, &r);
+        if (!found) {
+            sched_yield();
+            continue;
+        }
+
+        while (r.hi - r.lo > 1 && cost(F, r.lo, r.hi) > F->grain) {
+            EdgeIndex mid = costPoint(F, r.lo, r.lo + 1, r.hi - 1, (cost(F, r.lo, r.hi) + 1) / 2);
+            pushTask(&F->deque[tid], mid, r.hi);
+            r.hi = mid;
+        }
+        F->body(r.lo, r.hi, tid, F->arg);
+        __atomic_fetch_sub(&F->remaining, r.hi - r.lo, __ATOMIC_RELEASE);
+    }
+}
+
+// parallelFor()
+// Deals lo..hi-1 out as one range of equal cost per thread, then runs them
+// with work stealing.
+void parallelFor(EdgeIndex lo, EdgeIndex hi, const EdgeIndex *weight, EdgeIndex grain,
+                 void (*body)(EdgeIndex lo, EdgeIndex hi, int tid, void *arg), void *arg, int threads) {
+    if (body == NULL) {
+        printf("Parallel Error: parallelFor() called on NULL body\n");
+        exit(1);
+    }
+    if (threads <= 0)
+        threads = defaultThreads();
+    if (lo >= hi)
+        return;
+    if (threads > hi - lo)
+        threads = (int) (hi - lo);
+    if (threads == 1) {
+        body(lo, hi, 0, arg);
+        return;
+    }
+
+    ForJob F;
+    F.weight = weight;
+    F.body = body;
+    F.arg = arg;
+    F.remaining = hi - lo;
+
+    EdgeIndex total = cost(&F, lo, hi);
+    F.grain = grain > 0 ? grain : total / ((EdgeIndex) threads * PARALLEL_SPLITS);
+    if (grain <= 0 && F.grain < PARALLEL_MIN_GRAIN)
+        F.grain = PARALLEL_MIN_GRAIN;
+
+    void *mem = NULL;
+    if (posix_memalign(&mem, 64, sizeof(Deque) * (size_t) threads) != 0) {
+        printf("Parallel Error: parallelFor() unable to allocate deques\n");
+        exit(1);
+    }
+    F.deque = mem;
+
+    EdgeIndex start = lo;
+    for (int t = 0; t < threads; t++) {
+        Deque *D = &F.deque[t];
+        pthread_mutex_init(&D->lock, NULL);
+        D->capacity = 64;
+        D->task = malloc(sizeof(Range) * (size_t) D->capacity);
+        D->head = D->tail = 0;
+
+        EdgeIndex end = t == threads - 1 ? hi
+                      : costPoint(&F, lo, start, hi, total / threads * (t + 1) + total % threads * (t + 1) / threads);
+        if (end > start)
+            pushTask(D, start, end);
+        start = end;
+    }
+
+    parallelRun(threads, forWorker, &F);
+
+    for (int t = 0; t < threads; t++) {
+        pthread_mutex_destroy(&F.deque[t].lock);
+        free(F.deque[t].task);
+    }
+    free(F.deque);
+}
+
+// prefixBlock()
+// Phase 0 sums block tid of J->a into blockSum[tid]; phase 1 rewrites the
+// block as an exclusive prefix sum starting from blockSum[tid].
+// Private.
+static void prefixBlock(int tid, int threads, void *arg) {
+    PrefixJob *J = arg;
+    EdgeIndex lo;
+    EdgeIndex hi;
+
+    threadSlice(J->n, tid, threads, &lo, &hi);
+
+    if (J->phase == 0) {
+        EdgeIndex sum = 0;
+        for (EdgeIndex i = lo; i < hi; i++)
+            sum += J->a[i];
+        J->blockSum[tid] = sum;
+        return;
+    }
+
+    EdgeIndex running = J->blockSum[tid];
+    for (EdgeIndex i = lo; i < hi; i++) {
+        EdgeIndex x = J->a[i];
+        J->a[i] = running;
+        running += x;
+    }
+}
+
+// prefixSum()
+// Exclusive prefix sum of a[0..n-1] in place: per-block sums, a serial scan
+// over the blocks, then each block rewritten from its base.
+EdgeIndex prefixSum(EdgeIndex *a, EdgeIndex n, int threads) {
+    if (a == NULL && n > 0) {
+        printf("Parallel Error: prefixSum() called on NULL array\n");
+        exit(1);
+    }
+    if (threads <= 0)
+        threads = defaultThreads();
+
+    if (threads == 1 || n < PREFIX_SERIAL) {
+        EdgeIndex running = 0;
+        for (EdgeIndex i = 0; i < n; i++) {
+            EdgeIndex x = a[i];
+            a[i] = running;
+            running += x;
+        }
+        return running;
+    }
+
+    PrefixJob J;
+    J.a = a;
+    J.n = n;
+    J.blockSum = malloc(sizeof(EdgeIndex) * (size_t) threads);
+    J.phase = 0;
+    parallelRun(threads, prefixBlock, &J);
+
+    EdgeIndex running = 0;
+    for (int t = 0; t < threads; t++) {
+        EdgeIndex x = J.blockSum[t];
+        J.blockSum[t] = running;
+        running += x;
+    }
+
+    J.phase = 1;
+    parallelRun(threads, prefixBlock, &J);
+    free(J.blockSum);
+    return running;
+}
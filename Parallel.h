@@ -0,0 +1,58 @@
+//-----------------------------------------------------------------------------
+// Parallel.h
+// Header file for thread helpers shared by the parallel graph kernels
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_PARALLEL_H
+#define GRAPHADT_PARALLEL_H
+
+#include"GraphTypes.h"
+
+// defaultThreads()
+// Returns the thread count kernels use when passed threads <= 0: the
+// GRAPHADT_THREADS environment variable if set and positive, otherwise the
+// number of online processors.
+int defaultThreads(void);
+
+// parallelRun()
+// Calls body(tid, threads, arg) once for each tid in 0..threads-1, each on its
+// own thread (tid 0 on the calling thread), and returns when all have
+// finished. threads <= 0 means defaultThreads(). The other threads come from
+// a pool kept parked between runs, grown to the largest run so far; a run
+// started while another is in progress, including one nested inside a body,
+// starts threads of its own.
+void parallelRun(int threads, void (*body)(int tid, int threads, void *arg), void *arg);
+
+// parallelFor()
+// Calls body(lo', hi', tid, arg) on disjoint ranges [lo', hi') covering
+// lo..hi-1, on at most threads threads (threads <= 0 means defaultThreads()),
+// tid being the calling thread's index in 0..threads-1. Item i costs 1, plus
+// weight[i + 1] - weight[i] if weight is not NULL, so CSR offsets weigh each
+// vertex by its degree; weight must have entries lo..hi. Each thread starts
+// with a range of equal cost and splits it in halves by cost until pieces
+// cost at most grain, keeping the upper halves in a deque that idle threads
+// steal from. A vertex is never split, but a hub ends up alone in its range
+// while the rest of its neighborhood is spread over other threads. grain <= 0
+// picks one from the total cost and the thread count.
+void parallelFor(EdgeIndex lo, EdgeIndex hi, const EdgeIndex *weight, EdgeIndex grain,
+                 void (*body)(EdgeIndex lo, EdgeIndex hi, int tid, void *arg), void *arg, int threads);
+
+// nextChunk()
+// Atomically claims the next chunk of at most chunk items from the shared
+// cursor *next, which counts up towards end. Sets *lo and *hi to the claimed
+// half-open range and returns 1, or returns 0 once the range is exhausted.
+int nextChunk(EdgeIndex *next, EdgeIndex end, EdgeIndex chunk, EdgeIndex *lo, EdgeIndex *hi);
+
+// threadSlice()
+// Sets [*lo, *hi) to thread tid's share of 0..total-1 when it is cut into
+// threads contiguous slices of equal size, the last ones possibly shorter or
+// empty. For parallelRun() bodies over items of equal cost.
+void threadSlice(EdgeIndex total, int tid, int threads, EdgeIndex *lo, EdgeIndex *hi);
+
+// prefixSum()
+// Replaces a[0..n-1] with its exclusive prefix sum, a[i] becoming the sum of
+// the old a[0..i-1], and returns the total. Splits long arrays into one block
+// per thread; threads <= 0 means defaultThreads().
+EdgeIndex prefixSum(EdgeIndex *a, EdgeIndex n, int threads);
+
+#endif //GRAPHADT_PARALLEL_H
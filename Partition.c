@@ -0,0 +1,668 @@
+//-----------------------------------------------------------------------------
+// Partition.c
+// Implementation file for graph partitioning and partitioned BFS across
+// processes
+//-----------------------------------------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "Partition.h"
+#include "Sort.h"
+
+// structs --------------------------------------------------------------------
+
+// private PartitionObj type
+typedef struct PartitionObj {
+    Vertex order;
+    int parts;
+
+    // Part p owns first[p] .. first[p + 1] - 1
+    Vertex *first;
+} PartitionObj;
+
+// private ShardObj type
+typedef struct ShardObj {
+    int part;
+    Vertex first;
+    Vertex owned;
+    Vertex ghosts;
+
+    // Out-arcs of owned vertex i are target[offset[i]] .. target[offset[i + 1]
+    // - 1], in local numbering
+    EdgeIndex *offset;
+    Vertex *target;
+
+    // Ghost owned + g is global vertex ghostGlobal[g], owned by ghostOwner[g]
+    Vertex *ghostGlobal;
+    int *ghostOwner;
+
+    Vertex *distance;
+    char *ghostSent;
+    Vertex *frontier;
+    Vertex *next;
+} ShardObj;
+
+// private PipeMesh type: every pipe of a mesh; the pipe from part p to part q
+// is fd[(p * parts + q) * 2] (read end) and fd[(p * parts + q) * 2 + 1]
+typedef struct PipeMesh {
+    int parts;
+    int *fd;
+} PipeMesh;
+
+// private Flow type: one peer's message in flight during an exchange, an
+// EdgeIndex count header followed by count vertices
+typedef struct Flow {
+    EdgeIndex header;
+    char *payload;
+    size_t length;
+    size_t done;
+} Flow;
+
+
+// Partitions -----------------------------------------------------------------
+
+// newPartition()
+// Splits 1..n into parts ranges: equal vertex counts for PARTITION_BLOCK, or
+// equal totals of degree + 1 for PARTITION_EDGES, so that isolated vertices
+// still carry some weight.
+Partition newPartition(Graph G, int parts, int strategy) {
+    if (G == NULL) {
+        printf("Partition Error: newPartition() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (parts < 1) {
+        printf("Partition Error: newPartition() called with fewer than one part\n");
+        exit(1);
+    }
+
+    Partition P = malloc(sizeof(PartitionObj));
+    Vertex n = getOrder(G);
+    P->order = n;
+    P->parts = parts;
+    P->first = malloc(sizeof(Vertex) * ((size_t) parts + 1));
+
+    if (strategy == PARTITION_EDGES) {
+        const EdgeIndex *offset;
+        const Vertex *target;
+        getAdjacency(G, &offset, &target);
+
+        // Weight before vertex v is offset[v] + (v - 1); each cut goes at the
+        // first vertex reaching its share
+        double total = (double) offset[n + 1] + (double) n;
+        Vertex v = 1;
+        P->first[0] = 1;
+        for (int p = 1; p < parts; p++) {
+            double cut = total * p / parts;
+            while (v <= n && (double) offset[v] + (double) (v - 1) < cut)
+                v++;
+            P->first[p] = v;
+        }
+    } else {
+        for (int p = 0; p < parts; p++)
+            P->first[p] = (Vertex) ((EdgeIndex) n * p / parts) + 1;
+    }
+    P->first[parts] = n + 1;
+    return P;
+}
+
+// freePartition()
+// Frees all heap memory associated with *pP, and sets *pP to NULL.
+void freePartition(Partition *pP) {
+    if (pP != NULL && *pP != NULL) {
+        free((*pP)->first);
+        free(*pP);
+        *pP = NULL;
+    }
+}
+
+// partitionParts()
+// Returns the number of parts of P.
+int partitionParts(Partition P) {
+    if (P == NULL) {
+        printf("Partition Error: partitionParts() called on NULL Partition reference\n");
+        exit(1);
+    }
+    return P->parts;
+}
+
+// partitionOwner()
+// Returns the part owning v, by binary search over the range starts.
+int partitionOwner(Partition P, Vertex v) {
+    if (P == NULL) {
+        printf("Partition Error: partitionOwner() called on NULL Partition reference\n");
+        exit(1);
+    }
+    if (v < 1 || v > P->order) {
+        printf("Partition Error: partitionOwner() called on vertex outside range of Partition\n");
+        exit(1);
+    }
+
+    // Last p with first[p] <= v
+    int lo = 0;
+    int hi = P->parts - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (P->first[mid] <= v)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+// partitionFirst()
+// Returns the first vertex of part p.
+Vertex partitionFirst(Partition P, int p) {
+    if (P == NULL) {
+        printf("Partition Error: partitionFirst() called on NULL Partition reference\n");
+        exit(1);
+    }
+    if (p < 0 || p > P->parts) {
+        printf("Partition Error: partitionFirst() called on part outside range of Partition\n");
+        exit(1);
+    }
+    return P->first[p];
+}
+
+
+// Shards ---------------------------------------------------------------------
+
+// findGhost()
+// Returns the index of v in the sorted ghost list of S.
+// Private.
+static Vertex findGhost(Shard S, Vertex v) {
+    Vertex lo = 0;
+    Vertex hi = S->ghosts - 1;
+    while (lo < hi) {
+        Vertex mid = lo + (hi - lo) / 2;
+        if (S->ghostGlobal[mid] < v)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// newShard()
+// Copies part p's adjacency out of G, renumbering it locally with the remote
+// targets collected, sorted and deduplicated into the ghost map.
+Shard newShard(Graph G, Partition P, int p) {
+    if (G == NULL) {
+        printf("Partition Error: newShard() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (P == NULL) {
+        printf("Partition Error: newShard() called on NULL Partition reference\n");
+        exit(1);
+    }
+    if (p < 0 || p >= P->parts) {
+        printf("Partition Error: newShard() called on part outside range of Partition\n");
+        exit(1);
+    }
+
+    const EdgeIndex *offset;
+    const Vertex *target;
+    getAdjacency(G, &offset, &target);
+
+    Shard S = malloc(sizeof(ShardObj));
+    Vertex first = P->first[p];
+    Vertex last = P->first[p + 1] - 1;
+    EdgeIndex base = offset[first];
+    EdgeIndex arcs = offset[last + 1] - base;
+
+    S->part = p;
+    S->first = first;
+    S->owned = last - first + 1;
+    S->offset = malloc(sizeof(EdgeIndex) * ((size_t) S->owned + 1));
+    S->target = malloc(sizeof(Vertex) * (size_t) (arcs > 0 ? arcs : 1));
+    for (Vertex i = 0; i <= S->owned; i++)
+        S->offset[i] = offset[first + i] - base;
+
+    // Remote targets become the ghost list
+    EdgeIndex remote = 0;
+    for (EdgeIndex e = 0; e < arcs; e++) {
+        Vertex v = target[base + e];
+        if (v < first || v > last)
+            S->target[remote++] = v;
+    }
+    sortVertices(S->target, remote);
+    S->ghosts = (Vertex) uniqueVertices(S->target, remote);
+    S->ghostGlobal = malloc(sizeof(Vertex) * ((size_t) S->ghosts + 1));
+    S->ghostOwner = malloc(sizeof(int) * ((size_t) S->ghosts + 1));
+    memcpy(S->ghostGlobal, S->target, sizeof(Vertex) * (size_t) S->ghosts);
+    for (Vertex g = 0; g < S->ghosts; g++)
+        S->ghostOwner[g] = partitionOwner(P, S->ghostGlobal[g]);
+
+    for (EdgeIndex e = 0; e < arcs; e++) {
+        Vertex v = target[base + e];
+        S->target[e] = v >= first && v <= last ? v - first : S->owned + findGhost(S, v);
+    }
+
+    S->distance = malloc(sizeof(Vertex) * ((size_t) S->owned + 1));
+    S->ghostSent = malloc((size_t) S->ghosts + 1);
+    S->frontier = malloc(sizeof(Vertex) * ((size_t) S->owned + 1));
+    S->next = malloc(sizeof(Vertex) * ((size_t) S->owned + 1));
+    for (Vertex i = 0; i < S->owned; i++)
+        S->distance[i] = INF;
+    return S;
+}
+
+// freeShard()
+// Frees all heap memory associated with *pS, and sets *pS to NULL.
+void freeShard(Shard *pS) {
+    if (pS != NULL && *pS != NULL) {
+        Shard S = *pS;
+        free(S->offset);
+        free(S->target);
+        free(S->ghostGlobal);
+        free(S->ghostOwner);
+        free(S->distance);
+        free(S->ghostSent);
+        free(S->frontier);
+        free(S->next);
+        free(S);
+        *pS = NULL;
+    }
+}
+
+// shardOwned()
+// Returns the number of vertices S owns.
+Vertex shardOwned(Shard S) {
+    if (S == NULL) {
+        printf("Partition Error: shardOwned() called on NULL Shard reference\n");
+        exit(1);
+    }
+    return S->owned;
+}
+
+// shardGhosts()
+// Returns the number of ghost vertices of S.
+Vertex shardGhosts(Shard S) {
+    if (S == NULL) {
+        printf("Partition Error: shardGhosts() called on NULL Shard reference\n");
+        exit(1);
+    }
+    return S->ghosts;
+}
+
+// shardDist()
+// Returns the distance to the owned global vertex v, or INF.
+Vertex shardDist(Shard S, Vertex v) {
+    if (S == NULL) {
+        printf("Partition Error: shardDist() called on NULL Shard reference\n");
+        exit(1);
+    }
+    if (v < S->first || v >= S->first + S->owned) {
+        printf("Partition Error: shardDist() called on vertex not owned by Shard\n");
+        exit(1);
+    }
+    return S->distance[v - S->first];
+}
+
+// shardBFS()
+// Level-synchronous BFS over the owned vertices. Ghosts reached in a level
+// are batched per owning part and sent once, in a single exchange per level;
+// the first entry of every message says whether the sender did anything
+// that level, and the search ends after a level where no part did.
+void shardBFS(Shard S, Transport *T, Vertex s) {
+    if (S == NULL) {
+        printf("Partition Error: shardBFS() called on NULL Shard reference\n");
+        exit(1);
+    }
+    if (T == NULL) {
+        printf("Partition Error: shardBFS() called on NULL Transport reference\n");
+        exit(1);
+    }
+
+    int parts = T->parts;
+    Vertex **send = malloc(sizeof(Vertex *) * (size_t) parts);
+    EdgeIndex *sendCount = malloc(sizeof(EdgeIndex) * (size_t) parts);
+    EdgeIndex *sendCap = malloc(sizeof(EdgeIndex) * (size_t) parts);
+    Vertex **recv = malloc(sizeof(Vertex *) * (size_t) parts);
+    EdgeIndex *recvCount = malloc(sizeof(EdgeIndex) * (size_t) parts);
+    for (int p = 0; p < parts; p++) {
+        sendCap[p] = 64;
+        send[p] = malloc(sizeof(Vertex) * (size_t) sendCap[p]);
+    }
+
+    for (Vertex i = 0; i < S->owned; i++)
+        S->distance[i] = INF;
+    memset(S->ghostSent, 0, (size_t) S->ghosts + 1);
+
+    Vertex count = 0;
+    if (s >= S->first && s < S->first + S->owned) {
+        S->distance[s - S->first] = 0;
+        S->frontier[count++] = s - S->first;
+    }
+
+    for (Vertex level = 0;; level++) {
+        Vertex found = 0;
+        int active = 0;
+        for (int p = 0; p < parts; p++)
+            sendCount[p] = 1;
+
+        for (Vertex i = 0; i < count; i++) {
+            Vertex u = S->frontier[i];
+            for (EdgeIndex e = S->offset[u]; e < S->offset[u + 1]; e++) {
+                Vertex v = S->target[e];
+                if (v < S->owned) {
+                    if (S->distance[v] == INF) {
+                        S->distance[v] = level + 1;
+                        S->next[found++] = v;
+                    }
+                    continue;
+                }
+
+                Vertex g = v - S->owned;
+                if (S->ghostSent[g])
+                    continue;
+                S->ghostSent[g] = 1;
+                int p = S->ghostOwner[g];
+                if (sendCount[p] == sendCap[p]) {
+                    sendCap[p] *= 2;
+                    send[p] = realloc(send[p], sizeof(Vertex) * (size_t) sendCap[p]);
+                }
+                send[p][sendCount[p]++] = S->ghostGlobal[g];
+                active = 1;
+            }
+        }
+        if (found > 0)
+            active = 1;
+        for (int p = 0; p < parts; p++)
+            send[p][0] = active;
+
+        T->exchange(T, send, sendCount, recv, recvCount);
+
+        for (int p = 0; p < parts; p++) {
+            if (p == T->rank)
+                continue;
+            if (recvCount[p] > 0 && recv[p][0])
+                active = 1;
+            for (EdgeIndex k = 1; k < recvCount[p]; k++) {
+                Vertex v = recv[p][k] - S->first;
+                if (S->distance[v] == INF) {
+                    S->distance[v] = level + 1;
+                    S->next[found++] = v;
+                }
+            }
+            free(recv[p]);
+        }
+        if (!active)
+            break;
+
+        Vertex *swap = S->frontier;
+        S->frontier = S->next;
+        S->next = swap;
+        count = found;
+    }
+
+    for (int p = 0; p < parts; p++)
+        free(send[p]);
+    free(send);
+    free(sendCount);
+    free(sendCap);
+    free(recv);
+    free(recvCount);
+}
+
+
+// Local processes ------------------------------------------------------------
+
+// flowBytes()
+// Returns the address of byte i of the message F, header first.
+// Private.
+static char *flowBytes(Flow *F, size_t i) {
+    if (i < sizeof(EdgeIndex))
+        return (char *) &F->header + i;
+    return F->payload + (i - sizeof(EdgeIndex));
+}
+
+// flowChunk()
+// Returns how many bytes of F can be moved contiguously from F->done.
+// Private.
+static size_t flowChunk(const Flow *F) {
+    if (F->done < sizeof(EdgeIndex))
+        return sizeof(EdgeIndex) - F->done;
+    return F->length - F->done;
+}
+
+// pipeExchange()
+// exchange() over a pipe mesh. Writes and reads with every peer are
+// interleaved under poll() on non-blocking pipes, so no pair of parts can
+// deadlock on full pipe buffers.
+// Private.
+static void pipeExchange(Transport *T, Vertex *const *send, const EdgeIndex *sendCount,
+                         Vertex **recv, EdgeIndex *recvCount) {
+    PipeMesh *M = T->state;
+    int parts = T->parts;
+    int self = T->rank;
+    Flow *out = calloc((size_t) parts, sizeof(Flow));
+    Flow *in = calloc((size_t) parts, sizeof(Flow));
+    struct pollfd *fds = malloc(sizeof(struct pollfd) * (size_t) (2 * parts));
+    int *peer = malloc(sizeof(int) * (size_t) (2 * parts));
+    int pending = 0;
+
+    for (int p = 0; p < parts; p++) {
+        recv[p] = NULL;
+        recvCount[p] = 0;
+        if (p == self)
+            continue;
+        out[p].header = sendCount[p];
+        out[p].payload = (char *) send[p];
+        out[p].length = sizeof(EdgeIndex) + sizeof(Vertex) * (size_t) sendCount[p];
+        in[p].length = sizeof(EdgeIndex);
+        pending += 2;
+    }
+
+    while (pending > 0) {
+        int k = 0;
+        for (int p = 0; p < parts; p++) {
+            if (p == self)
+                continue;
+            if (out[p].done < out[p].length) {
+                fds[k].fd = M->fd[(self * parts + p) * 2 + 1];
+                fds[k].events = POLLOUT;
+                peer[k++] = p;
+            }
+            if (in[p].done < in[p].length) {
+                fds[k].fd = M->fd[(p * parts + self) * 2];
+                fds[k].events = POLLIN;
+                peer[k++] = -1 - p;
+            }
+        }
+        if (poll(fds, (nfds_t) k, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            printf("Partition Error: exchange() poll failed\n");
+            exit(1);
+        }
+
+        for (int i = 0; i < k; i++) {
+            if (fds[i].revents == 0)
+                continue;
+            Flow *F = peer[i] >= 0 ? &out[peer[i]] : &in[-1 - peer[i]];
+            ssize_t r = peer[i] >= 0 ? write(fds[i].fd, flowBytes(F, F->done), flowChunk(F))
+                                     : read(fds[i].fd, flowBytes(F, F->done), flowChunk(F));
+            if (r < 0 && (errno == EAGAIN || errno == EINTR))
+                continue;
+            if (r <= 0) {
+                printf("Partition Error: exchange() lost connection to part %d\n",
+                       peer[i] >= 0 ? peer[i] : -1 - peer[i]);
+                exit(1);
+            }
+            F->done += (size_t) r;
+
+            // A completed header sizes the incoming payload
+            if (peer[i] < 0 && F->done == sizeof(EdgeIndex) && F->length == sizeof(EdgeIndex)) {
+                F->length += sizeof(Vertex) * (size_t) F->header;
+                F->payload = malloc(sizeof(Vertex) * (size_t) (F->header > 0 ? F->header : 1));
+            }
+            if (F->done == F->length)
+                pending--;
+        }
+    }
+
+    for (int p = 0; p < parts; p++) {
+        if (p == self)
+            continue;
+        recv[p] = (Vertex *) in[p].payload;
+        recvCount[p] = in[p].header;
+    }
+    free(out);
+    free(in);
+    free(fds);
+    free(peer);
+}
+
+// newPipeMesh()
+// Opens a pipe for every ordered pair of distinct parts.
+Transport *newPipeMesh(int parts) {
+    if (parts < 1) {
+        printf("Partition Error: newPipeMesh() called with fewer than one part\n");
+        exit(1);
+    }
+
+    PipeMesh *M = malloc(sizeof(PipeMesh));
+    M->parts = parts;
+    M->fd = malloc(sizeof(int) * (size_t) (2 * parts * parts));
+    for (int i = 0; i < 2 * parts * parts; i++)
+        M->fd[i] = -1;
+    for (int p = 0; p < parts; p++)
+        for (int q = 0; q < parts; q++)
+            if (p != q && pipe(&M->fd[(p * parts + q) * 2]) != 0) {
+                printf("Partition Error: newPipeMesh() unable to open pipes\n");
+                exit(1);
+            }
+
+    Transport *mesh = malloc(sizeof(Transport) * (size_t) parts);
+    for (int p = 0; p < parts; p++) {
+        mesh[p].rank = p;
+        mesh[p].parts = parts;
+        mesh[p].state = M;
+        mesh[p].exchange = pipeExchange;
+    }
+    return mesh;
+}
+
+// joinPipeMesh()
+// Keeps only rank's write ends and read ends open, non-blocking.
+Transport *joinPipeMesh(Transport *mesh, int rank) {
+    if (mesh == NULL) {
+        printf("Partition Error: joinPipeMesh() called on NULL Transport reference\n");
+        exit(1);
+    }
+    PipeMesh *M = mesh[0].state;
+    int parts = M->parts;
+    if (rank < 0 || rank >= parts) {
+        printf("Partition Error: joinPipeMesh() called on rank outside range of mesh\n");
+        exit(1);
+    }
+
+    for (int p = 0; p < parts; p++) {
+        for (int q = 0; q < parts; q++) {
+            int *end = &M->fd[(p * parts + q) * 2];
+            if (p == q)
+                continue;
+            for (int w = 0; w < 2; w++) {
+                int keep = w == 1 ? p == rank : q == rank;
+                if (!keep) {
+                    close(end[w]);
+                    end[w] = -1;
+                } else {
+                    fcntl(end[w], F_SETFL, fcntl(end[w], F_GETFL) | O_NONBLOCK);
+                }
+            }
+        }
+    }
+    return &mesh[rank];
+}
+
+// freePipeMesh()
+// Closes every pipe end still open and frees the mesh.
+void freePipeMesh(Transport **pMesh) {
+    if (pMesh != NULL && *pMesh != NULL) {
+        PipeMesh *M = (*pMesh)[0].state;
+        for (int i = 0; i < 2 * M->parts * M->parts; i++)
+            if (M->fd[i] >= 0)
+                close(M->fd[i]);
+        free(M->fd);
+        free(M);
+        free(*pMesh);
+        *pMesh = NULL;
+    }
+}
+
+// partitionedBFS()
+// Forks one process per part. Each builds its shard, joins the pipe mesh,
+// runs shardBFS() and writes its owned distances into a shared anonymous
+// mapping, which the parent copies out once every child has exited.
+void partitionedBFS(Graph G, Partition P, Vertex s, Vertex *distance) {
+    if (G == NULL) {
+        printf("Partition Error: partitionedBFS() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (P == NULL) {
+        printf("Partition Error: partitionedBFS() called on NULL Partition reference\n");
+        exit(1);
+    }
+    if (s < 1 || s > getOrder(G)) {
+        printf("Partition Error: partitionedBFS() called on vertex outside range of Graph\n");
+        exit(1);
+    }
+
+    // Builds the compact adjacency once, before the children share it
+    const EdgeIndex *offset;
+    const Vertex *target;
+    getAdjacency(G, &offset, &target);
+
+    Vertex n = getOrder(G);
+    size_t bytes = sizeof(Vertex) * ((size_t) n + 1);
+    Vertex *shared = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        printf("Partition Error: partitionedBFS() unable to map result array\n");
+        exit(1);
+    }
+
+    int parts = P->parts;
+    Transport *mesh = newPipeMesh(parts);
+    pid_t *child = malloc(sizeof(pid_t) * (size_t) parts);
+    fflush(NULL);
+    for (int p = 0; p < parts; p++) {
+        child[p] = fork();
+        if (child[p] < 0) {
+            printf("Partition Error: partitionedBFS() unable to fork\n");
+            exit(1);
+        }
+        if (child[p] == 0) {
+            Transport *T = joinPipeMesh(mesh, p);
+            Shard S = newShard(G, P, p);
+            shardBFS(S, T, s);
+            memcpy(shared + S->first, S->distance, sizeof(Vertex) * (size_t) S->owned);
+            _exit(0);
+        }
+    }
+    freePipeMesh(&mesh);
+
+    int failed = 0;
+    for (int p = 0; p < parts; p++) {
+        int status;
+        if (waitpid(child[p], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            failed = 1;
+    }
+    if (failed) {
+        printf("Partition Error: partitionedBFS() part process failed\n");
+        exit(1);
+    }
+
+    memcpy(distance + 1, shared + 1, sizeof(Vertex) * (size_t) n);
+    munmap(shared, bytes);
+    free(child);
+}
@@ -0,0 +1,123 @@
+//-----------------------------------------------------------------------------
+// Partition.h
+// Header file for graph partitioning and partitioned BFS across processes
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_PARTITION_H
+#define GRAPHADT_PARTITION_H
+
+#include"Graph.h"
+
+// Partitioning strategies
+#define PARTITION_BLOCK 0   // equal vertex ranges
+#define PARTITION_EDGES 1   // vertex ranges with equal degree + 1 totals
+
+// Exported types -------------------------------------------------------------
+
+// 1D partition of vertices 1..n into parts contiguous ranges.
+typedef struct PartitionObj *Partition;
+
+// One part's vertices with their out-arcs, in local numbering: owned vertices
+// are 0..owned-1, and arcs leaving the part point at ghost vertices numbered
+// from owned upwards, each mapped to its global ID and owning part.
+typedef struct ShardObj *Shard;
+
+// Message layer between the parts of a partitioned BFS. exchange() is
+// collective: every part calls it once per round, passing send[p] (count
+// sendCount[p]) for each part p, and receives in recv[p] / recvCount[p] what
+// part p sent it. recv[p] is allocated with malloc() for the caller to free;
+// entries for the calling part itself are neither sent nor received. Other
+// transports (sockets, MPI) only need to provide exchange() and state.
+typedef struct Transport {
+    int rank;
+    int parts;
+    void *state;
+    void (*exchange)(struct Transport *T, Vertex *const *send, const EdgeIndex *sendCount,
+                     Vertex **recv, EdgeIndex *recvCount);
+} Transport;
+
+
+// Partitions -----------------------------------------------------------------
+
+// newPartition()
+// Returns a partition of G's vertices into parts ranges by strategy.
+// Precondition: parts >= 1
+Partition newPartition(Graph G, int parts, int strategy);
+
+// freePartition()
+// Frees all heap memory associated with *pP, and sets *pP to NULL.
+void freePartition(Partition *pP);
+
+// partitionParts()
+// Returns the number of parts of P.
+int partitionParts(Partition P);
+
+// partitionOwner()
+// Returns the part that owns vertex v.
+// Precondition: 1 <= v <= order of P's Graph
+int partitionOwner(Partition P, Vertex v);
+
+// partitionFirst()
+// Returns the first vertex of part p; its last is partitionFirst(P, p + 1) - 1.
+// Precondition: 0 <= p <= partitionParts(P)
+Vertex partitionFirst(Partition P, int p);
+
+
+// Shards ---------------------------------------------------------------------
+
+// newShard()
+// Returns part p of G under P, with its ghost map.
+// Precondition: 0 <= p < partitionParts(P)
+Shard newShard(Graph G, Partition P, int p);
+
+// freeShard()
+// Frees all heap memory associated with *pS, and sets *pS to NULL.
+void freeShard(Shard *pS);
+
+// shardOwned()
+// Returns the number of vertices S owns.
+Vertex shardOwned(Shard S);
+
+// shardGhosts()
+// Returns the number of distinct remote vertices S has arcs to.
+Vertex shardGhosts(Shard S);
+
+// shardDist()
+// Returns the distance found by the last shardBFS() on S to the owned global
+// vertex v, or INF.
+// Precondition: v is owned by S
+Vertex shardDist(Shard S, Vertex v);
+
+// shardBFS()
+// Runs S's share of a level-synchronous BFS from global vertex s, exchanging
+// newly reached ghost vertices with the other parts through T once per
+// level. Every part must call it with the same s.
+void shardBFS(Shard S, Transport *T, Vertex s);
+
+
+// Local processes ------------------------------------------------------------
+
+// newPipeMesh()
+// Returns parts Transports connected by a pipe between every pair of parts,
+// for use by processes forked after the call: each calls joinPipeMesh() with
+// its rank, the creating process freePipeMesh() once all have been forked.
+Transport *newPipeMesh(int parts);
+
+// joinPipeMesh()
+// In the process that takes rank, closes the pipe ends other ranks use and
+// returns its Transport.
+Transport *joinPipeMesh(Transport *mesh, int rank);
+
+// freePipeMesh()
+// Closes every pipe end still open in this process and frees *pMesh, setting
+// it to NULL.
+void freePipeMesh(Transport **pMesh);
+
+// partitionedBFS()
+// Runs a BFS from s over P's parts in one forked process per part, connected
+// by a pipe mesh, and gathers the distances into distance[1..getOrder(G)].
+// They equal getDist() after BFS(G, s).
+// Precondition: 1 <= s <= getOrder(G)
+void partitionedBFS(Graph G, Partition P, Vertex s, Vertex *distance);
+
+#endif //GRAPHADT_PARTITION_H
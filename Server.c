@@ -0,0 +1,565 @@
+//-----------------------------------------------------------------------------
+// Server.c
+// Implementation file for the FindPath query server
+//-----------------------------------------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "Server.h"
+#include "Parallel.h"
+
+// Source groups a worker claims and searches at once with queryBatch(). More
+// than one pays off only where the memory system has misses to spare: on
+// skewed graphs one search's hub expansion evicts the lines the others have
+// prefetched, and on a single-core x86 VM one at a time measured fastest
+#define SERVER_INTERLEAVE 1
+
+// structs --------------------------------------------------------------------
+
+// private Request type: one parsed query line
+typedef struct Request {
+    long long source;
+    long long dest;
+    int valid;
+} Request;
+
+// private Text type: growable response buffer
+typedef struct Text {
+    char *data;
+    size_t length;
+    size_t capacity;
+} Text;
+
+// private Batch type: the queries of one submission, grouped by source
+typedef struct Batch {
+    Request *request;
+    Text *response;
+    EdgeIndex *order;
+    EdgeIndex *group;
+    EdgeIndex groups;
+    EdgeIndex next;
+} Batch;
+
+// private Worker type
+typedef struct Worker {
+    struct ServerObj *server;
+    Query query[SERVER_INTERLEAVE];
+    Vertex *path;
+} Worker;
+
+// private ServerObj type
+typedef struct ServerObj {
+    Graph graph;
+    int threads;
+    int batch;
+
+    pthread_t *thread;
+    Worker *worker;
+
+    // Hands one Batch at a time to the pool; submit serializes streams
+    pthread_mutex_t submit;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    Batch *job;
+    unsigned long generation;
+    int pending;
+    int quit;
+} ServerObj;
+
+// private Reader type: buffered line reader over a file descriptor
+typedef struct Reader {
+    int fd;
+    char *data;
+    size_t start;
+    size_t length;
+    size_t capacity;
+    int eof;
+} Reader;
+
+
+// Text -----------------------------------------------------------------------
+
+// appendText()
+// Appends the n characters of s to T, keeping T NUL-terminated.
+// Private.
+static void appendText(Text *T, const char *s, size_t n) {
+    if (T->length + n + 1 > T->capacity) {
+        size_t capacity = T->capacity > 0 ? T->capacity : 64;
+        while (T->length + n + 1 > capacity)
+            capacity *= 2;
+        T->data = realloc(T->data, capacity);
+        T->capacity = capacity;
+    }
+    memcpy(T->data + T->length, s, n);
+    T->length += n;
+    T->data[T->length] = '\0';
+}
+
+// appendNumber()
+// Appends a space (unless T is empty) followed by x in decimal.
+// Private.
+static void appendNumber(Text *T, long long x) {
+    char digits[32];
+    int n = snprintf(digits, sizeof(digits), T->length > 0 ? " %lld" : "%lld", x);
+    appendText(T, digits, (size_t) n);
+}
+
+// writeAll()
+// Writes n bytes of data to fd, retrying short writes. Returns 0 on success.
+// Private.
+static int writeAll(int fd, const char *data, size_t n) {
+    while (n > 0) {
+        ssize_t w = write(fd, data, n);
+        if (w < 0 && errno == EINTR)
+            continue;
+        if (w <= 0)
+            return -1;
+        data += w;
+        n -= (size_t) w;
+    }
+    return 0;
+}
+
+
+// Workers --------------------------------------------------------------------
+
+// answerGroup()
+// Formats the response of every request in group g of B from Q, which has
+// searched from the group's source.
+// Private.
+static void answerGroup(Worker *W, Query Q, Batch *B, EdgeIndex g) {
+    for (EdgeIndex i = B->group[g]; i < B->group[g + 1]; i++) {
+        Request *R = &B->request[B->order[i]];
+        Text *T = &B->response[B->order[i]];
+
+        appendNumber(T, R->source);
+        appendNumber(T, R->dest);
+        if (!R->valid) {
+            appendText(T, " error\n", 7);
+            continue;
+        }
+
+        Vertex d = (Vertex) R->dest;
+        Vertex dist = getQueryDist(Q, d);
+        appendNumber(T, dist);
+        if (dist != INF) {
+            // Walks parents back from d, then emits source first
+            Vertex x = d;
+            for (Vertex k = dist; k >= 0; k--) {
+                W->path[k] = x;
+                x = getQueryParent(Q, x);
+            }
+            for (Vertex k = 0; k <= dist; k++)
+                appendNumber(T, W->path[k]);
+        }
+        appendText(T, "\n", 1);
+    }
+}
+
+// answerGroups()
+// Searches from the sources of groups lo..hi-1 of B together, each stopping
+// at its destination when the group has only one, and formats their
+// responses.
+// Private.
+static void answerGroups(Worker *W, Batch *B, EdgeIndex lo, EdgeIndex hi) {
+    Query query[SERVER_INTERLEAVE];
+    Vertex source[SERVER_INTERLEAVE];
+    Vertex dest[SERVER_INTERLEAVE];
+    int count = 0;
+
+    for (EdgeIndex g = lo; g < hi; g++) {
+        Request *first = &B->request[B->order[B->group[g]]];
+        if (!first->valid)
+            continue;
+        query[count] = W->query[g - lo];
+        source[count] = (Vertex) first->source;
+        dest[count] = B->group[g + 1] - B->group[g] == 1 ? (Vertex) first->dest : NIL;
+        count++;
+    }
+    queryBatch(query, source, dest, count);
+
+    for (EdgeIndex g = lo; g < hi; g++)
+        answerGroup(W, W->query[g - lo], B, g);
+}
+
+// workerMain()
+// Worker thread body: waits for each new Batch and answers groups of it
+// until none are left.
+// Private.
+static void *workerMain(void *arg) {
+    Worker *W = arg;
+    Server S = W->server;
+    unsigned long seen = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&S->lock);
+        while (!S->quit && S->generation == seen)
+            pthread_cond_wait(&S->start, &S->lock);
+        if (S->quit) {
+            pthread_mutex_unlock(&S->lock);
+            break;
+        }
+        seen = S->generation;
+        Batch *B = S->job;
+        pthread_mutex_unlock(&S->lock);
+
+        // Fewer groups per claim when there are too few to go around
+        EdgeIndex lo;
+        EdgeIndex hi;
+        EdgeIndex chunk = B->groups / S->threads;
+        chunk = chunk < 1 ? 1 : chunk > SERVER_INTERLEAVE ? SERVER_INTERLEAVE : chunk;
+        while (nextChunk(&B->next, B->groups, chunk, &lo, &hi))
+            answerGroups(W, B, lo, hi);
+
+        pthread_mutex_lock(&S->lock);
+        if (--S->pending == 0)
+            pthread_cond_signal(&S->done);
+        pthread_mutex_unlock(&S->lock);
+    }
+    return NULL;
+}
+
+// compareKeys()
+// Orders (source, index) pairs by source, then by arrival.
+// Private.
+static int compareKeys(const void *a, const void *b) {
+    const long long *x = a;
+    const long long *y = b;
+    if (x[0] != y[0])
+        return (x[0] > y[0]) - (x[0] < y[0]);
+    return (x[1] > y[1]) - (x[1] < y[1]);
+}
+
+// runBatch()
+// Answers request[0..count-1] on the worker pool, filling response[].
+// Private.
+static void runBatch(Server S, Request *request, Text *response, int count) {
+    Batch B;
+    long long *keys = malloc(sizeof(long long) * 2 * (size_t) count);
+
+    // Invalid requests share key 0 and so form one group answered "error"
+    for (int i = 0; i < count; i++) {
+        keys[2 * i] = request[i].valid ? request[i].source : 0;
+        keys[2 * i + 1] = i;
+    }
+    qsort(keys, (size_t) count, sizeof(long long) * 2, compareKeys);
+
+    B.request = request;
+    B.response = response;
+    B.order = malloc(sizeof(EdgeIndex) * (size_t) count);
+    B.group = malloc(sizeof(EdgeIndex) * ((size_t) count + 1));
+    B.groups = 0;
+    B.next = 0;
+    for (int i = 0; i < count; i++) {
+        B.order[i] = keys[2 * i + 1];
+        if (i == 0 || keys[2 * i] != keys[2 * (i - 1)])
+            B.group[B.groups++] = i;
+    }
+    B.group[B.groups] = count;
+
+    pthread_mutex_lock(&S->submit);
+    pthread_mutex_lock(&S->lock);
+    S->job = &B;
+    S->pending = S->threads;
+    S->generation++;
+    pthread_cond_broadcast(&S->start);
+    while (S->pending > 0)
+        pthread_cond_wait(&S->done, &S->lock);
+    pthread_mutex_unlock(&S->lock);
+    pthread_mutex_unlock(&S->submit);
+
+    free(keys);
+    free(B.order);
+    free(B.group);
+}
+
+
+// Constructors-Destructors ---------------------------------------------------
+
+// newServer()
+// Returns a Server answering queries on G with threads workers and batches
+// of at most batch queries.
+Server newServer(Graph G, int threads, int batch) {
+    if (G == NULL) {
+        printf("Server Error: newServer() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (batch < 1) {
+        printf("Server Error: newServer() called with batch < 1\n");
+        exit(1);
+    }
+    if (threads <= 0)
+        threads = defaultThreads();
+
+    Server S = malloc(sizeof(ServerObj));
+    S->graph = G;
+    S->threads = threads;
+    S->batch = batch;
+    S->job = NULL;
+    S->generation = 0;
+    S->pending = 0;
+    S->quit = 0;
+    pthread_mutex_init(&S->submit, NULL);
+    pthread_mutex_init(&S->lock, NULL);
+    pthread_cond_init(&S->start, NULL);
+    pthread_cond_init(&S->done, NULL);
+
+    S->thread = malloc(sizeof(pthread_t) * (size_t) threads);
+    S->worker = malloc(sizeof(Worker) * (size_t) threads);
+    for (int t = 0; t < threads; t++) {
+        S->worker[t].server = S;
+        for (int k = 0; k < SERVER_INTERLEAVE; k++)
+            S->worker[t].query[k] = newQuery(G);
+        S->worker[t].path = malloc(sizeof(Vertex) * ((size_t) getOrder(G) + 1));
+        if (pthread_create(&S->thread[t], NULL, workerMain, &S->worker[t]) != 0) {
+            printf("Server Error: newServer() unable to create worker thread\n");
+            exit(1);
+        }
+    }
+    return S;
+}
+
+// freeServer()
+// Stops the workers and frees all heap memory associated with *pS.
+void freeServer(Server *pS) {
+    if (pS == NULL || *pS == NULL) {
+        printf("Server Error: freeServer() called on NULL Server reference\n");
+        exit(1);
+    }
+
+    Server S = *pS;
+    pthread_mutex_lock(&S->lock);
+    S->quit = 1;
+    pthread_cond_broadcast(&S->start);
+    pthread_mutex_unlock(&S->lock);
+
+    for (int t = 0; t < S->threads; t++) {
+        pthread_join(S->thread[t], NULL);
+        for (int k = 0; k < SERVER_INTERLEAVE; k++)
+            freeQuery(&S->worker[t].query[k]);
+        free(S->worker[t].path);
+    }
+
+    pthread_mutex_destroy(&S->submit);
+    pthread_mutex_destroy(&S->lock);
+    pthread_cond_destroy(&S->start);
+    pthread_cond_destroy(&S->done);
+    free(S->thread);
+    free(S->worker);
+    free(S);
+    *pS = NULL;
+}
+
+
+// Serving --------------------------------------------------------------------
+
+// parseRequest()
+// Parses the line s[0..n-1] into *R. Returns 0 for a blank line, -1 for the
+// 0 0 terminator, 1 otherwise.
+// Private.
+static int parseRequest(Server S, const char *s, size_t n, Request *R) {
+    char line[128];
+    if (n >= sizeof(line))
+        n = sizeof(line) - 1;
+    memcpy(line, s, n);
+    line[n] = '\0';
+
+    int fields = sscanf(line, "%lld %lld", &R->source, &R->dest);
+    if (fields == EOF)
+        return 0;
+    if (fields != 2) {
+        R->source = 0;
+        R->dest = 0;
+        R->valid = 0;
+        return 1;
+    }
+    if (R->source == 0 && R->dest == 0)
+        return -1;
+
+    Vertex order = getOrder(S->graph);
+    R->valid = R->source >= 1 && R->source <= order && R->dest >= 1 && R->dest <= order;
+    return 1;
+}
+
+// readRequests()
+// Fills request[] with up to max queries from R. Blocks for the first query
+// only, then takes whatever further input is already available, so a batch
+// never waits on a slow client. Sets *stop at end of input or 0 0.
+// Private.
+static int readRequests(Server S, Reader *R, Request *request, int max, int *stop) {
+    int count = 0;
+
+    for (;;) {
+        // Parses complete lines already buffered
+        while (count < max) {
+            char *line = R->data + R->start;
+            char *end = memchr(line, '\n', R->length - R->start);
+            if (end == NULL) {
+                if (!R->eof || R->start == R->length)
+                    break;
+                end = R->data + R->length;  // final line without newline
+            }
+
+            int kind = parseRequest(S, line, (size_t) (end - line), &request[count]);
+            R->start = end < R->data + R->length ? (size_t) (end - R->data) + 1 : R->length;
+            if (kind < 0) {
+                *stop = 1;
+                return count;
+            }
+            if (kind > 0)
+                count++;
+        }
+        if (count == max)
+            return count;
+        if (R->eof) {
+            *stop = 1;
+            return count;
+        }
+
+        // Once a query is in hand, only reads input that is ready now
+        if (count > 0) {
+            struct pollfd p = {R->fd, POLLIN, 0};
+            if (poll(&p, 1, 0) <= 0)
+                return count;
+        }
+
+        // Keeps the partial line, then reads more
+        memmove(R->data, R->data + R->start, R->length - R->start);
+        R->length -= R->start;
+        R->start = 0;
+        if (R->length == R->capacity) {
+            R->capacity *= 2;
+            R->data = realloc(R->data, R->capacity);
+        }
+
+        ssize_t n = read(R->fd, R->data + R->length, R->capacity - R->length);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            R->eof = 1;
+        else
+            R->length += (size_t) n;
+    }
+}
+
+// serveStream()
+// Answers queries read from in, writing responses to out, until end of input
+// or a 0 0 request.
+void serveStream(Server S, int in, int out) {
+    if (S == NULL) {
+        printf("Server Error: serveStream() called on NULL Server reference\n");
+        exit(1);
+    }
+
+    Reader R = {in, malloc(1 << 16), 0, 0, 1 << 16, 0};
+    Request *request = malloc(sizeof(Request) * (size_t) S->batch);
+    Text *response = calloc((size_t) S->batch, sizeof(Text));
+    Text all = {NULL, 0, 0};
+    int stop = 0;
+
+    while (!stop) {
+        int count = readRequests(S, &R, request, S->batch, &stop);
+        if (count == 0)
+            continue;
+
+        runBatch(S, request, response, count);
+
+        // Streams the batch back in request order with a single write
+        all.length = 0;
+        for (int i = 0; i < count; i++) {
+            appendText(&all, response[i].data, response[i].length);
+            response[i].length = 0;
+        }
+        if (writeAll(out, all.data, all.length) != 0)
+            break;
+    }
+
+    for (int i = 0; i < S->batch; i++)
+        free(response[i].data);
+    free(response);
+    free(request);
+    free(all.data);
+    free(R.data);
+}
+
+// private Connection type: argument of a socket connection thread
+typedef struct Connection {
+    Server server;
+    int fd;
+} Connection;
+
+// serveConnection()
+// Thread body serving one socket connection.
+// Private.
+static void *serveConnection(void *arg) {
+    Connection *C = arg;
+    serveStream(C->server, C->fd, C->fd);
+    close(C->fd);
+    free(C);
+    return NULL;
+}
+
+// serveSocket()
+// Listens on the Unix domain socket at path, serving each connection on its
+// own thread.
+void serveSocket(Server S, const char *path) {
+    if (S == NULL) {
+        printf("Server Error: serveSocket() called on NULL Server reference\n");
+        exit(1);
+    }
+
+    struct sockaddr_un addr;
+    if (path == NULL || strlen(path) >= sizeof(addr.sun_path)) {
+        printf("Server Error: serveSocket() called with invalid socket path\n");
+        return;
+    }
+
+    // A client hanging up mid-response must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        printf("Server Error: serveSocket() unable to create socket\n");
+        return;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        printf("Server Error: serveSocket() unable to listen on %s\n", path);
+        close(fd);
+        return;
+    }
+
+    for (;;) {
+        int client = accept(fd, NULL, NULL);
+        if (client < 0 && errno == EINTR)
+            continue;
+        if (client < 0)
+            break;
+
+        Connection *C = malloc(sizeof(Connection));
+        C->server = S;
+        C->fd = client;
+        pthread_t t;
+        if (pthread_create(&t, NULL, serveConnection, C) != 0) {
+            close(client);
+            free(C);
+            continue;
+        }
+        pthread_detach(t);
+    }
+
+    close(fd);
+    unlink(path);
+}
@@ -0,0 +1,60 @@
+//-----------------------------------------------------------------------------
+// Server.h
+// Header file for the FindPath query server
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_SERVER_H
+#define GRAPHADT_SERVER_H
+
+#include"Graph.h"
+
+/* Protocol, one query per line in each direction:
+ *
+ * request:  s d
+ * response: s d dist v1 v2 ... vk      (a shortest s-d path)
+ *           s d -1                     (d unreachable from s)
+ *           s d error                  (vertex outside range of Graph)
+ *
+ * A request of 0 0 or end of input ends the stream. Responses come back in
+ * request order.
+*/
+
+// Exported type --------------------------------------------------------------
+// A Server owns a pool of worker threads, each with private Queries
+// against one shared, unmodified Graph. Queries are gathered into batches of
+// up to batch requests, grouped by source so each distinct source costs one
+// BFS, and the groups spread over the workers, which search with
+// queryBatch(). A group with a single request stops its search at the
+// destination.
+typedef struct ServerObj *Server;
+
+
+// Constructors-Destructors ---------------------------------------------------
+
+// newServer()
+// Returns a Server answering queries on G with threads workers (threads <= 0
+// means defaultThreads()) and batches of at most batch queries.
+// Pre: batch >= 1
+Server newServer(Graph G, int threads, int batch);
+
+// freeServer()
+// Stops the workers and frees all heap memory associated with *pS, and sets
+// *pS to NULL. The Graph is not freed.
+void freeServer(Server *pS);
+
+
+// Serving --------------------------------------------------------------------
+
+// serveStream()
+// Answers queries read from file descriptor in, writing responses to out,
+// until end of input or a 0 0 request. Several streams may be served at once
+// from different threads; their batches take turns on the worker pool.
+void serveStream(Server S, int in, int out);
+
+// serveSocket()
+// Listens on the Unix domain socket at path and serves each connection with
+// serveStream() on its own thread. Returns only if the socket cannot be
+// created or accept() fails.
+void serveSocket(Server S, const char *path);
+
+#endif //GRAPHADT_SERVER_H
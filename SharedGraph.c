@@ -0,0 +1,183 @@
+//-----------------------------------------------------------------------------
+// SharedGraph.c
+// Implementation file for publishing frozen Graphs in POSIX shared memory
+//-----------------------------------------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "SharedGraph.h"
+
+#define SHM_MAGIC "GADJSHM2"
+
+// Sections start on cache line boundaries
+#define SHM_ALIGN 64
+
+// structs --------------------------------------------------------------------
+
+// private SharedHeader type: the start of a segment
+typedef struct SharedHeader {
+    char magic[8];
+    int64_t order;
+    int64_t size;
+    int64_t vertexBytes;
+    int64_t policy;
+    int64_t dropped;
+    int64_t offsetsPos;
+    int64_t targetsPos;
+    int64_t bytes;
+} SharedHeader;
+
+// private Mapping type: an attached segment, unmapped when its Graph is done
+typedef struct Mapping {
+    void *addr;
+    size_t bytes;
+} Mapping;
+
+
+// alignUp()
+// Rounds x up to a multiple of SHM_ALIGN.
+// Private.
+static int64_t alignUp(int64_t x) {
+    return (x + SHM_ALIGN - 1) / SHM_ALIGN * SHM_ALIGN;
+}
+
+// unmapSegment()
+// newGraphView() release callback for an attached segment.
+// Private.
+static void unmapSegment(void *arg) {
+    Mapping *M = arg;
+    munmap(M->addr, M->bytes);
+    free(M);
+}
+
+// publishGraph()
+// Creates the segment exclusively, sizes it, and copies the compact
+// adjacency in behind the header.
+int publishGraph(Graph G, const char *name) {
+    if (G == NULL) {
+        printf("SharedGraph Error: publishGraph() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (name == NULL) {
+        printf("SharedGraph Error: publishGraph() called on NULL name\n");
+        exit(1);
+    }
+
+    const EdgeIndex *offset;
+    const Vertex *target;
+    getAdjacency(G, &offset, &target);
+    Vertex n = getOrder(G);
+    EdgeIndex arcs = offset[n + 1];
+
+    SharedHeader H;
+    memset(&H, 0, sizeof(H));
+    H.order = n;
+    H.size = getSize(G);
+    H.vertexBytes = (int64_t) sizeof(Vertex);
+    H.policy = getEdgePolicy(G);
+    H.dropped = getDroppedEdges(G);
+    H.offsetsPos = alignUp((int64_t) sizeof(SharedHeader));
+    H.targetsPos = alignUp(H.offsetsPos + ((int64_t) n + 2) * (int64_t) sizeof(EdgeIndex));
+    H.bytes = alignUp(H.targetsPos + arcs * (int64_t) sizeof(Vertex));
+
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        if (errno == EEXIST)
+            return 0;
+        printf("SharedGraph Error: publishGraph() unable to create segment %s\n", name);
+        exit(1);
+    }
+    if (ftruncate(fd, (off_t) H.bytes) != 0) {
+        printf("SharedGraph Error: publishGraph() unable to size segment %s\n", name);
+        exit(1);
+    }
+    char *base = mmap(NULL, (size_t) H.bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        printf("SharedGraph Error: publishGraph() unable to map segment %s\n", name);
+        exit(1);
+    }
+
+    memcpy(base + H.offsetsPos, offset, sizeof(EdgeIndex) * ((size_t) n + 2));
+    memcpy(base + H.targetsPos, target, sizeof(Vertex) * (size_t) arcs);
+    memcpy(base, &H, sizeof(H));
+
+    // The magic marks the segment complete, so it goes in after everything
+    uint64_t magic;
+    memcpy(&magic, SHM_MAGIC, sizeof(magic));
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n((uint64_t *) base, magic, __ATOMIC_RELAXED);
+
+    munmap(base, (size_t) H.bytes);
+    return 1;
+}
+
+// attachGraph()
+// Maps the segment read-only and wraps it in a Graph view.
+Graph attachGraph(const char *name) {
+    if (name == NULL) {
+        printf("SharedGraph Error: attachGraph() called on NULL name\n");
+        exit(1);
+    }
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+        return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(SharedHeader)) {
+        close(fd);
+        return NULL;
+    }
+    size_t bytes = (size_t) st.st_size;
+    char *base = mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return NULL;
+
+    // The magic alone first: the acquire fence pairs with publishGraph()'s
+    // release fence only once it is seen, and orders the reads of the rest
+    uint64_t magic = __atomic_load_n((const uint64_t *) base, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (memcmp(&magic, SHM_MAGIC, sizeof(magic)) != 0) {
+        munmap(base, bytes);
+        return NULL;
+    }
+
+    SharedHeader H;
+    memcpy(&H, base, sizeof(H));
+    if (H.bytes != (int64_t) bytes) {
+        munmap(base, bytes);
+        return NULL;
+    }
+    if (H.vertexBytes != (int64_t) sizeof(Vertex)) {
+        printf("SharedGraph Error: segment %s has %d-bit vertices, this build uses %d-bit\n", name,
+               (int) (H.vertexBytes * 8), (int) (sizeof(Vertex) * 8));
+        exit(1);
+    }
+
+    Mapping *M = malloc(sizeof(Mapping));
+    M->addr = base;
+    M->bytes = bytes;
+    Graph G = newGraphView((Vertex) H.order, (const EdgeIndex *) (base + H.offsetsPos),
+                           (const Vertex *) (base + H.targetsPos), H.size, unmapSegment, M);
+    setEdgePolicy(G, (int) H.policy);
+    addDroppedEdges(G, H.dropped);
+    return G;
+}
+
+// unpublishGraph()
+// Unlinks the segment name.
+void unpublishGraph(const char *name) {
+    if (name == NULL) {
+        printf("SharedGraph Error: unpublishGraph() called on NULL name\n");
+        exit(1);
+    }
+    shm_unlink(name);
+}
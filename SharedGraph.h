@@ -0,0 +1,39 @@
+//-----------------------------------------------------------------------------
+// SharedGraph.h
+// Header file for publishing frozen Graphs in POSIX shared memory
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_SHAREDGRAPH_H
+#define GRAPHADT_SHAREDGRAPH_H
+
+#include"Graph.h"
+
+/* Segment structure (native byte order, offsets rather than pointers, so it
+ * maps at any address):
+ *
+ * header      magic "GADJSHM2", order, size, vertex bytes, edge policy,
+ *             dropped edges, offsets and targets positions, total bytes
+ * offsets     order + 2 adjacency offsets, as getAdjacency() gives them
+ * targets     neighbors of 1, neighbors of 2, ... each list ascending
+*/
+
+// publishGraph()
+// Copies G's compact adjacency, edge policy and dropped edge count into a new
+// POSIX shared memory segment called name (such as "/graph"). Returns true
+// (1), or false (0) if a segment of that name already exists. The magic is
+// written last, so attachGraph() never sees a half-written segment.
+int publishGraph(Graph G, const char *name);
+
+// attachGraph()
+// Returns a Graph over the segment name, mapped read-only, with the edge
+// policy and dropped edge count it was published with, or NULL if no
+// complete segment of that name exists. Every attached Graph has its own BFS
+// state and Queries; the adjacency itself is shared by all processes. Modifying
+// the Graph gives it a private copy. freeGraph() unmaps the segment.
+Graph attachGraph(const char *name);
+
+// unpublishGraph()
+// Removes the segment name. Graphs already attached keep working until freed.
+void unpublishGraph(const char *name);
+
+#endif //GRAPHADT_SHAREDGRAPH_H
@@ -0,0 +1,333 @@
+//-----------------------------------------------------------------------------
+// Snapshot.c
+// Implementation file for binary Graph snapshots on disk
+//-----------------------------------------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Snapshot.h"
+#include "Memory.h"
+
+#define SNAPSHOT_MAGIC "GADJSNP2"
+
+// Sections start on cache line boundaries
+#define SNAPSHOT_ALIGN 64
+
+// stdio buffer for writing, so sections go out in large sequential writes
+#define SNAPSHOT_BUFFER (1 << 20)
+
+// Vertices formatted per write of the BFS arrays
+#define SNAPSHOT_BLOCK 65536
+
+// structs --------------------------------------------------------------------
+
+// private SnapshotHeader type: the start of a snapshot file
+typedef struct SnapshotHeader {
+    char magic[8];
+    int64_t order;
+    int64_t size;
+    int64_t vertexBytes;
+    int64_t flags;
+    int64_t source;
+    int64_t policy;
+    int64_t dropped;
+    int64_t offsetsPos;
+    int64_t targetsPos;
+    int64_t targetsBytes;
+    int64_t distancePos;
+    int64_t parentPos;
+    int64_t bytes;
+} SnapshotHeader;
+
+// private Mapping type: a mapped snapshot, unmapped when its Graph is done
+typedef struct Mapping {
+    void *addr;
+    size_t bytes;
+} Mapping;
+
+
+// alignUp()
+// Rounds x up to a multiple of SNAPSHOT_ALIGN.
+// Private.
+static int64_t alignUp(int64_t x) {
+    return (x + SNAPSHOT_ALIGN - 1) / SNAPSHOT_ALIGN * SNAPSHOT_ALIGN;
+}
+
+// unmapSnapshot()
+// newGraphView() release callback for a mapped snapshot.
+// Private.
+static void unmapSnapshot(void *arg) {
+    Mapping *M = arg;
+    munmap(M->addr, M->bytes);
+    free(M);
+}
+
+// writeBytes()
+// Writes n bytes from p to out, exiting on failure.
+// Private.
+static void writeBytes(FILE *out, const void *p, size_t n) {
+    if (n > 0 && fwrite(p, 1, n, out) != n) {
+        printf("Snapshot Error: saveSnapshot() unable to write snapshot\n");
+        exit(1);
+    }
+}
+
+// syncDirectory()
+// Flushes the directory holding path to disk, so a rename() into it is
+// durable.
+// Private.
+static void syncDirectory(const char *path) {
+    const char *slash = strrchr(path, '/');
+    size_t n = slash == NULL ? 1 : slash == path ? 1 : (size_t) (slash - path);
+    char *dir = malloc(n + 1);
+    memcpy(dir, slash == NULL ? "." : path, n);
+    dir[n] = '\0';
+
+    int fd = open(dir, O_RDONLY);
+    if (fd < 0 || fsync(fd) != 0) {
+        printf("Snapshot Error: saveSnapshot() unable to sync directory %s\n", dir);
+        exit(1);
+    }
+    close(fd);
+    free(dir);
+}
+
+// padTo()
+// Writes zeros to out until it is at position pos.
+// Private.
+static void padTo(FILE *out, int64_t pos) {
+    static const char zeros[SNAPSHOT_ALIGN];
+    int64_t at = (int64_t) ftello(out);
+    if (at < pos)
+        writeBytes(out, zeros, (size_t) (pos - at));
+}
+
+// writeVarints()
+// Writes the adjacency lists of target as varint gaps and returns the bytes
+// written.
+// Private.
+static int64_t writeVarints(FILE *out, Vertex n, const EdgeIndex *offset, const Vertex *target) {
+    unsigned char buf[SNAPSHOT_ALIGN];
+    int64_t bytes = 0;
+
+    for (Vertex u = 1; u <= n; u++) {
+        Vertex prev = 0;
+        for (EdgeIndex e = offset[u]; e < offset[u + 1]; e++) {
+            uint64_t gap = (uint64_t) (target[e] - prev);
+            size_t k = 0;
+            prev = target[e];
+            while (gap >= 0x80) {
+                buf[k++] = (unsigned char) (gap | 0x80);
+                gap >>= 7;
+            }
+            buf[k++] = (unsigned char) gap;
+            writeBytes(out, buf, k);
+            bytes += (int64_t) k;
+        }
+    }
+    return bytes;
+}
+
+// readVarints()
+// Decodes the varint adjacency lists in p[0..bytes-1] into target. Returns
+// true (1), or false (0) if they run past the end.
+// Private.
+static int readVarints(const unsigned char *p, int64_t bytes, Vertex n, const EdgeIndex *offset,
+                       Vertex *target) {
+    const unsigned char *end = p + bytes;
+
+    for (Vertex u = 1; u <= n; u++) {
+        Vertex prev = 0;
+        for (EdgeIndex e = offset[u]; e < offset[u + 1]; e++) {
+            uint64_t gap = 0;
+            int shift = 0;
+            do {
+                if (p == end || shift > 63)
+                    return 0;
+                gap |= (uint64_t) (*p & 0x7F) << shift;
+                shift += 7;
+            } while (*p++ & 0x80);
+            prev = (Vertex) (prev + (Vertex) gap);
+            target[e] = prev;
+        }
+    }
+    return 1;
+}
+
+// saveSnapshot()
+// Writes the sections behind a blank header, then the header itself, and
+// renames the finished file into place.
+void saveSnapshot(Graph G, const char *path, int flags) {
+    if (G == NULL) {
+        printf("Snapshot Error: saveSnapshot() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (path == NULL) {
+        printf("Snapshot Error: saveSnapshot() called on NULL path\n");
+        exit(1);
+    }
+
+    const EdgeIndex *offset;
+    const Vertex *target;
+    getAdjacency(G, &offset, &target);
+    Vertex n = getOrder(G);
+    EdgeIndex arcs = offset[n + 1];
+
+    size_t len = strlen(path);
+    char *temp = malloc(len + 5);
+    memcpy(temp, path, len);
+    memcpy(temp + len, ".tmp", 5);
+
+    FILE *out = fopen(temp, "wb");
+    if (out == NULL) {
+        printf("Snapshot Error: saveSnapshot() unable to open %s for writing\n", temp);
+        exit(1);
+    }
+    setvbuf(out, NULL, _IOFBF, SNAPSHOT_BUFFER);
+
+    SnapshotHeader H;
+    memset(&H, 0, sizeof(H));
+    writeBytes(out, &H, sizeof(H));
+
+    H.order = n;
+    H.size = getSize(G);
+    H.vertexBytes = (int64_t) sizeof(Vertex);
+    H.flags = flags & SNAPSHOT_COMPRESS;
+    H.source = getSource(G);
+    H.policy = getEdgePolicy(G);
+    H.dropped = getDroppedEdges(G);
+
+    H.offsetsPos = alignUp((int64_t) sizeof(SnapshotHeader));
+    padTo(out, H.offsetsPos);
+    writeBytes(out, offset, sizeof(EdgeIndex) * ((size_t) n + 2));
+
+    H.targetsPos = alignUp((int64_t) ftello(out));
+    padTo(out, H.targetsPos);
+    if (H.flags & SNAPSHOT_COMPRESS) {
+        H.targetsBytes = writeVarints(out, n, offset, target);
+    } else {
+        H.targetsBytes = arcs * (int64_t) sizeof(Vertex);
+        writeBytes(out, target, (size_t) H.targetsBytes);
+    }
+
+    // BFS results, fetched a block at a time through the access functions
+    if (H.source != NIL) {
+        Vertex *block = malloc(sizeof(Vertex) * SNAPSHOT_BLOCK);
+        for (int pass = 0; pass < 2; pass++) {
+            int64_t pos = alignUp((int64_t) ftello(out));
+            padTo(out, pos);
+            if (pass == 0)
+                H.distancePos = pos;
+            else
+                H.parentPos = pos;
+
+            for (Vertex lo = 0; lo <= n; lo += SNAPSHOT_BLOCK) {
+                Vertex k = n + 1 - lo < SNAPSHOT_BLOCK ? n + 1 - lo : SNAPSHOT_BLOCK;
+                for (Vertex i = 0; i < k; i++) {
+                    Vertex u = lo + i;
+                    block[i] = u == 0 ? (pass == 0 ? INF : NIL) : (pass == 0 ? getDist(G, u) : getParent(G, u));
+                }
+                writeBytes(out, block, sizeof(Vertex) * (size_t) k);
+            }
+        }
+        free(block);
+    }
+
+    H.bytes = alignUp((int64_t) ftello(out));
+    padTo(out, H.bytes);
+
+    // The header, and with it the magic, goes in last
+    memcpy(H.magic, SNAPSHOT_MAGIC, sizeof(H.magic));
+    if (fseeko(out, 0, SEEK_SET) != 0) {
+        printf("Snapshot Error: saveSnapshot() unable to write snapshot\n");
+        exit(1);
+    }
+    writeBytes(out, &H, sizeof(H));
+
+    // On disk before the rename, so path never names a file a crash truncated
+    if (fflush(out) != 0 || fsync(fileno(out)) != 0 || fclose(out) != 0 ||
+        rename(temp, path) != 0) {
+        printf("Snapshot Error: saveSnapshot() unable to write %s\n", path);
+        exit(1);
+    }
+    syncDirectory(path);
+    free(temp);
+}
+
+// loadSnapshot()
+// Maps the file read-only, then either wraps it in a Graph view or decodes
+// its compressed targets into a compact Graph.
+Graph loadSnapshot(const char *path) {
+    if (path == NULL) {
+        printf("Snapshot Error: loadSnapshot() called on NULL path\n");
+        exit(1);
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(SnapshotHeader)) {
+        close(fd);
+        return NULL;
+    }
+    size_t bytes = (size_t) st.st_size;
+    char *base = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return NULL;
+
+    SnapshotHeader H;
+    memcpy(&H, base, sizeof(H));
+    if (memcmp(H.magic, SNAPSHOT_MAGIC, sizeof(H.magic)) != 0 || H.bytes != (int64_t) bytes) {
+        munmap(base, bytes);
+        return NULL;
+    }
+    if (H.vertexBytes != (int64_t) sizeof(Vertex)) {
+        printf("Snapshot Error: %s has %d-bit vertices, this build uses %d-bit\n", path,
+               (int) (H.vertexBytes * 8), (int) (sizeof(Vertex) * 8));
+        exit(1);
+    }
+
+    Vertex n = (Vertex) H.order;
+    const EdgeIndex *offset = (const EdgeIndex *) (base + H.offsetsPos);
+    Graph G;
+
+    if (H.flags & SNAPSHOT_COMPRESS) {
+        EdgeIndex arcs = offset[n + 1];
+        size_t adjacency = sizeof(EdgeIndex) * ((size_t) n + 2) + sizeof(Vertex) * (size_t) (arcs > 0 ? arcs : 1);
+        if (!reserveMemory(adjacency)) {
+            munmap(base, bytes);
+            return NULL;
+        }
+        EdgeIndex *ownOffset = malloc(sizeof(EdgeIndex) * ((size_t) n + 2));
+        Vertex *target = malloc(sizeof(Vertex) * (size_t) (arcs > 0 ? arcs : 1));
+        memcpy(ownOffset, offset, sizeof(EdgeIndex) * ((size_t) n + 2));
+        if (!readVarints((const unsigned char *) base + H.targetsPos, H.targetsBytes, n, ownOffset, target)) {
+            printf("Snapshot Error: %s has corrupt adjacency\n", path);
+            exit(1);
+        }
+        releaseMemory(adjacency);
+        G = newGraphCompact(n, ownOffset, target, H.size);
+    } else {
+        Mapping *M = malloc(sizeof(Mapping));
+        M->addr = base;
+        M->bytes = bytes;
+        G = newGraphView(n, offset, (const Vertex *) (base + H.targetsPos), H.size, unmapSnapshot, M);
+    }
+
+    setEdgePolicy(G, (int) H.policy);
+    addDroppedEdges(G, H.dropped);
+    if (H.source != NIL)
+        restoreBFS(G, (Vertex) H.source, (const Vertex *) (base + H.distancePos),
+                   (const Vertex *) (base + H.parentPos));
+    if (H.flags & SNAPSHOT_COMPRESS)
+        munmap(base, bytes);
+    return G;
+}
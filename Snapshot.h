@@ -0,0 +1,44 @@
+//-----------------------------------------------------------------------------
+// Snapshot.h
+// Header file for binary Graph snapshots on disk
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_SNAPSHOT_H
+#define GRAPHADT_SNAPSHOT_H
+
+#include"Graph.h"
+
+// Snapshot flags
+#define SNAPSHOT_COMPRESS 1   // delta-varint targets, decoded on load
+
+/* Snapshot file structure (native byte order, sections 64-byte aligned):
+ *
+ * header      magic "GADJSNP2", order, size, vertex bytes, flags, BFS source
+ *             (or NIL), edge policy, dropped edges, section positions, total
+ *             bytes
+ * offsets     order + 2 adjacency offsets, as getAdjacency() gives them
+ * targets     neighbors of 1, neighbors of 2, ... each list ascending; with
+ *             SNAPSHOT_COMPRESS each list is stored as LEB128 varint gaps
+ *             from the previous neighbor (the first from 0)
+ * distance    order + 1 BFS distances, if the source is not NIL
+ * parent      order + 1 BFS parents, if the source is not NIL
+*/
+
+// saveSnapshot()
+// Writes G's compact adjacency, edge policy and dropped edge count, and the
+// results of its last BFS() if any, to path with large sequential writes.
+// The file is written under a temporary name, synced to disk and renamed
+// into place, so path always holds a complete snapshot, even after a crash.
+void saveSnapshot(Graph G, const char *path, int flags);
+
+// loadSnapshot()
+// Returns the Graph saved at path, with its edge policy, dropped edge count
+// and BFS results restored, or NULL if path does not hold a complete
+// snapshot. Uncompressed snapshots are mapped read-only rather than read, so
+// loading costs little more than copying the BFS arrays; modifying the Graph
+// gives it a private copy, and freeGraph() unmaps the file. Compressed
+// snapshots are decoded only if the adjacency fits in the memory budget (see
+// Memory.h), and otherwise also give NULL.
+Graph loadSnapshot(const char *path);
+
+#endif //GRAPHADT_SNAPSHOT_H
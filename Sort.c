@@ -0,0 +1,206 @@
+//-----------------------------------------------------------------------------
+// Sort.c
+// Implementation file for vertex and key array sorting used by the graph
+// builders and graph algorithms
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Sort.h"
+#include "Parallel.h"
+
+// Ranges up to this length are finished with insertion sort
+#define INSERTION_CUTOFF 24
+
+// Keys below which sortKeys() runs on the calling thread
+#define KEYS_SERIAL (1 << 16)
+
+// structs --------------------------------------------------------------------
+
+// private RadixJob type: state shared by the threads of one sortKeys()
+typedef struct RadixJob {
+    const uint64_t *from;
+    uint64_t *to;
+    EdgeIndex n;
+
+    // count[t][b] is the number of keys in thread t's slice whose current
+    // byte is b, then its write cursor for them
+    EdgeIndex **count;
+
+    // diff[t] has the bits in which some key of thread t's slice differs
+    // from the first key
+    uint64_t *diff;
+    int digit;
+    int phase;
+} RadixJob;
+
+enum { PHASE_DIFF, PHASE_HISTOGRAM, PHASE_SCATTER };
+
+// insertionSort()
+// Sorts a[0..n-1] by insertion. Fast for the short ranges most adjacency
+// lists are.
+// Private.
+static void insertionSort(Vertex *a, EdgeIndex n) {
+    for (EdgeIndex i = 1; i < n; i++) {
+        Vertex x = a[i];
+        EdgeIndex j = i;
+        while (j > 0 && a[j - 1] > x) {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = x;
+    }
+}
+
+// sortVertices()
+// Quicksort with median-of-three pivots, recursing into the smaller side so
+// the stack stays O(log n), and insertion sort for short ranges.
+void sortVertices(Vertex *a, EdgeIndex n) {
+    while (n > INSERTION_CUTOFF) {
+        Vertex x = a[0];
+        Vertex y = a[n / 2];
+        Vertex z = a[n - 1];
+        Vertex pivot = x < y ? (y < z ? y : (x < z ? z : x)) : (x < z ? x : (y < z ? z : y));
+
+        // Hoare partition
+        EdgeIndex i = -1;
+        EdgeIndex j = n;
+        for (;;) {
+            do i++; while (a[i] < pivot);
+            do j--; while (a[j] > pivot);
+            if (i >= j)
+                break;
+            Vertex t = a[i];
+            a[i] = a[j];
+            a[j] = t;
+        }
+
+        // a[0..j] <= pivot <= a[j+1..n-1]
+        if (j + 1 < n - j - 1) {
+            sortVertices(a, j + 1);
+            a += j + 1;
+            n -= j + 1;
+        } else {
+            sortVertices(a + j + 1, n - j - 1);
+            n = j + 1;
+        }
+    }
+    insertionSort(a, n);
+}
+
+// uniqueVertices()
+// Removes adjacent repeats from the sorted array a[0..n-1].
+EdgeIndex uniqueVertices(Vertex *a, EdgeIndex n) {
+    if (n == 0)
+        return 0;
+
+    EdgeIndex k = 1;
+    for (EdgeIndex i = 1; i < n; i++)
+        if (a[i] != a[k - 1])
+            a[k++] = a[i];
+    return k;
+}
+
+// radixWorker()
+// Runs the current phase of J over thread tid's slice of the keys: finding
+// the bits that vary, counting byte J->digit, or scattering by it, stably.
+// Private.
+static void radixWorker(int tid, int threads, void *arg) {
+    RadixJob *J = arg;
+    EdgeIndex lo;
+    EdgeIndex hi;
+    EdgeIndex *count = J->count[tid];
+    int shift = 8 * J->digit;
+
+    threadSlice(J->n, tid, threads, &lo, &hi);
+
+    switch (J->phase) {
+        case PHASE_DIFF: {
+            uint64_t diff = 0;
+            for (EdgeIndex i = lo; i < hi; i++)
+                diff |= J->from[i] ^ J->from[0];
+            J->diff[tid] = diff;
+            break;
+        }
+        case PHASE_HISTOGRAM:
+            memset(count, 0, sizeof(EdgeIndex) * 256);
+            for (EdgeIndex i = lo; i < hi; i++)
+                count[(J->from[i] >> shift) & 0xFF]++;
+            break;
+        case PHASE_SCATTER:
+            for (EdgeIndex i = lo; i < hi; i++) {
+                uint64_t x = J->from[i];
+                J->to[count[(x >> shift) & 0xFF]++] = x;
+            }
+            break;
+    }
+}
+
+// sortKeys()
+// One pass finds the bytes that vary; each of those then costs a counting
+// pass and a scatter, each thread writing its slice at cursors after those of
+// lower threads.
+void sortKeys(uint64_t *a, uint64_t *tmp, EdgeIndex n, int threads) {
+    if ((a == NULL || tmp == NULL) && n > 0) {
+        printf("Sort Error: sortKeys() called on NULL array\n");
+        exit(1);
+    }
+    if (threads <= 0)
+        threads = defaultThreads();
+    if (n < KEYS_SERIAL)
+        threads = 1;
+    if (n < 2)
+        return;
+
+    RadixJob J;
+    J.n = n;
+    J.from = a;
+    J.digit = 0;
+    J.count = malloc(sizeof(EdgeIndex *) * (size_t) threads);
+    for (int t = 0; t < threads; t++)
+        J.count[t] = malloc(sizeof(EdgeIndex) * 256);
+    J.diff = malloc(sizeof(uint64_t) * (size_t) threads);
+    J.phase = PHASE_DIFF;
+    parallelRun(threads, radixWorker, &J);
+
+    uint64_t diff = 0;
+    for (int t = 0; t < threads; t++)
+        diff |= J.diff[t];
+
+    uint64_t *from = a;
+    uint64_t *to = tmp;
+    for (int d = 0; d < 8; d++) {
+        // A byte shared by all keys leaves the order as it is
+        if (((diff >> (8 * d)) & 0xFF) == 0)
+            continue;
+
+        J.from = from;
+        J.to = to;
+        J.digit = d;
+        J.phase = PHASE_HISTOGRAM;
+        parallelRun(threads, radixWorker, &J);
+
+        EdgeIndex running = 0;
+        for (int b = 0; b < 256; b++) {
+            for (int t = 0; t < threads; t++) {
+                EdgeIndex c = J.count[t][b];
+                J.count[t][b] = running;
+                running += c;
+            }
+        }
+
+        J.phase = PHASE_SCATTER;
+        parallelRun(threads, radixWorker, &J);
+        uint64_t *t = from;
+        from = to;
+        to = t;
+    }
+    if (from != a)
+        memcpy(a, from, sizeof(uint64_t) * (size_t) n);
+
+    for (int t = 0; t < threads; t++)
+        free(J.count[t]);
+    free(J.count);
+    free(J.diff);
+}
@@ -0,0 +1,29 @@
+//-----------------------------------------------------------------------------
+// Sort.h
+// Header file for vertex and key array sorting used by the graph builders and
+// graph algorithms
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_SORT_H
+#define GRAPHADT_SORT_H
+
+#include"GraphTypes.h"
+
+// sortVertices()
+// Sorts a[0..n-1] into ascending order in place. Not stable, which does not
+// matter for plain vertex IDs.
+void sortVertices(Vertex *a, EdgeIndex n);
+
+// uniqueVertices()
+// Removes adjacent repeats from the sorted array a[0..n-1], compacting it in
+// place, and returns the number of elements kept.
+EdgeIndex uniqueVertices(Vertex *a, EdgeIndex n);
+
+// sortKeys()
+// Sorts a[0..n-1] into ascending order by parallel least significant digit
+// radix sort on threads threads (threads <= 0 means defaultThreads()), using
+// tmp[0..n-1] as scratch. Bytes on which all keys agree cost no pass, so keys
+// with few significant bits sort in few passes.
+void sortKeys(uint64_t *a, uint64_t *tmp, EdgeIndex n, int threads);
+
+#endif //GRAPHADT_SORT_H
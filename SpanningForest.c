@@ -0,0 +1,342 @@
+//-----------------------------------------------------------------------------
+// SpanningForest.c
+// Implementation file for minimum spanning forests of weighted undirected
+// edge lists
+//-----------------------------------------------------------------------------
+
+#include <string.h>
+#include "SpanningForest.h"
+#include "Parallel.h"
+#include "Sort.h"
+
+// No edge picked yet
+#define NO_EDGE ((EdgeIndex) -1)
+
+// structs --------------------------------------------------------------------
+
+// private BoruvkaJob type: state shared by the threads of one boruvkaForest()
+typedef struct BoruvkaJob {
+    Vertex n;
+    const Vertex *source;
+    const Vertex *target;
+    const Weight *weight;
+
+    // Component of each vertex, always its root after a round
+    Vertex *comp;
+
+    // Root each component hooks to, then after jumping its new root
+    Vertex *next;
+
+    // Lightest edge out of each component
+    EdgeIndex *best;
+
+    // Edges still crossing components: live[0..liveCount-1], or all edges
+    // while live is NULL
+    EdgeIndex *live;
+    EdgeIndex liveCount;
+    EdgeIndex *kept;
+    EdgeIndex *partial;
+
+    EdgeIndex *forest;
+    EdgeIndex forestCount;
+    int phase;
+} BoruvkaJob;
+
+enum { PHASE_RESET, PHASE_BEST, PHASE_HOOK, PHASE_JUMP, PHASE_RELABEL, PHASE_COUNT, PHASE_KEEP };
+
+
+// weightKey()
+// Returns w's bits mapped to an unsigned integer in the same order as w.
+// Private.
+static uint32_t weightKey(const Weight *weight, EdgeIndex e) {
+    Weight w = weight != NULL ? weight[e] : 1;
+    uint32_t bits;
+    memcpy(&bits, &w, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+
+// lighter()
+// Returns true (1) if edge e comes before edge f: lower weight, ties broken
+// by position.
+// Private.
+static int lighter(const Weight *weight, EdgeIndex e, EdgeIndex f) {
+    uint32_t a = weightKey(weight, e);
+    uint32_t b = weightKey(weight, f);
+    return a < b || (a == b && e < f);
+}
+
+// findRoot()
+// Returns the root of u's set, halving the path on the way.
+// Private.
+static Vertex findRoot(Vertex *parent, Vertex u) {
+    while (parent[u] != u) {
+        parent[u] = parent[parent[u]];
+        u = parent[u];
+    }
+    return u;
+}
+
+// makeForest()
+// Returns the EdgeList of edges pick[0..count-1] of E, sorted into the order
+// they appear in E, and sets *total to their weight if total is not NULL.
+// Private.
+static EdgeList makeForest(EdgeList E, uint64_t *pick, EdgeIndex count, double *total, int threads) {
+    uint64_t *tmp = malloc(sizeof(uint64_t) * (size_t) (count > 0 ? count : 1));
+    sortKeys(pick, tmp, count, threads);
+    free(tmp);
+
+    const Vertex *source = edgeSources(E);
+    const Vertex *target = edgeTargets(E);
+    const Weight *weight = edgeWeights(E);
+    EdgeList F = newEdgeList(edgeOrder(E), count);
+    double sum = 0;
+
+    for (EdgeIndex i = 0; i < count; i++) {
+        EdgeIndex e = (EdgeIndex) pick[i];
+        Weight w = weight != NULL ? weight[e] : 1;
+        appendWeightedEdge(F, source[e], target[e], w);
+        sum += w;
+    }
+    if (total != NULL)
+        *total = sum;
+    return F;
+}
+
+
+// Kruskal --------------------------------------------------------------------
+
+// kruskalForest()
+// Sorts edge keys, weight above position, then unions in key order.
+EdgeList kruskalForest(EdgeList E, double *total, int threads) {
+    if (E == NULL) {
+        printf("SpanningForest Error: kruskalForest() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    if (edgeCount(E) > ((EdgeIndex) 1 << 32)) {
+        printf("SpanningForest Error: kruskalForest() called on more than 2^32 edges\n");
+        exit(1);
+    }
+
+    Vertex n = edgeOrder(E);
+    EdgeIndex m = edgeCount(E);
+    const Vertex *source = edgeSources(E);
+    const Vertex *target = edgeTargets(E);
+    const Weight *weight = edgeWeights(E);
+
+    uint64_t *key = malloc(sizeof(uint64_t) * (size_t) (m > 0 ? m : 1));
+    uint64_t *tmp = malloc(sizeof(uint64_t) * (size_t) (m > 0 ? m : 1));
+    if (key == NULL || tmp == NULL) {
+        printf("SpanningForest Error: kruskalForest() unable to allocate %" PRIedge " keys\n", m);
+        exit(1);
+    }
+    for (EdgeIndex e = 0; e < m; e++)
+        key[e] = (uint64_t) weightKey(weight, e) << 32 | (uint64_t) e;
+    sortKeys(key, tmp, m, threads);
+    free(tmp);
+
+    Vertex *parent = malloc(sizeof(Vertex) * ((size_t) n + 1));
+    unsigned char *rank = calloc((size_t) n + 1, 1);
+    for (Vertex u = 0; u <= n; u++)
+        parent[u] = u;
+
+    // Forest positions overwrite the keys already scanned
+    EdgeIndex count = 0;
+    for (EdgeIndex i = 0; i < m && count < (EdgeIndex) n - 1; i++) {
+        EdgeIndex e = (EdgeIndex) (key[i] & 0xFFFFFFFFu);
+        Vertex a = findRoot(parent, source[e]);
+        Vertex b = findRoot(parent, target[e]);
+        if (a == b)
+            continue;
+        if (rank[a] < rank[b]) {
+            Vertex t = a;
+            a = b;
+            b = t;
+        }
+        parent[b] = a;
+        if (rank[a] == rank[b])
+            rank[a]++;
+        key[count++] = (uint64_t) e;
+    }
+    free(parent);
+    free(rank);
+
+    EdgeList F = makeForest(E, key, count, total, threads);
+    free(key);
+    return F;
+}
+
+
+// Borůvka --------------------------------------------------------------------
+
+// offerEdge()
+// Makes e the best edge of component c if it is lighter than c's current
+// one.
+// Private.
+static void offerEdge(BoruvkaJob *J, Vertex c, EdgeIndex e) {
+    EdgeIndex cur = __atomic_load_n(&J->best[c], __ATOMIC_RELAXED);
+    while (cur == NO_EDGE || lighter(J->weight, e, cur)) {
+        if (__atomic_compare_exchange_n(&J->best[c], &cur, e, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            return;
+    }
+}
+
+// boruvkaWorker()
+// Runs the current phase of J over thread tid's share of the vertices or of
+// the live edges.
+// Private.
+static void boruvkaWorker(int tid, int threads, void *arg) {
+    BoruvkaJob *J = arg;
+    EdgeIndex lo;
+    EdgeIndex hi;
+
+    switch (J->phase) {
+        case PHASE_RESET:
+            threadSlice((EdgeIndex) J->n + 1, tid, threads, &lo, &hi);
+            for (EdgeIndex u = lo; u < hi; u++)
+                J->best[u] = NO_EDGE;
+            break;
+
+        case PHASE_BEST:
+            threadSlice(J->liveCount, tid, threads, &lo, &hi);
+            for (EdgeIndex i = lo; i < hi; i++) {
+                EdgeIndex e = J->live != NULL ? J->live[i] : i;
+                Vertex a = J->comp[J->source[e]];
+                Vertex b = J->comp[J->target[e]];
+                if (a != b) {
+                    offerEdge(J, a, e);
+                    offerEdge(J, b, e);
+                }
+            }
+            break;
+
+        case PHASE_HOOK:
+            // Two components that picked each other's edge hook the larger
+            // root under the smaller, which adds the edge once
+            threadSlice((EdgeIndex) J->n + 1, tid, threads, &lo, &hi);
+            for (Vertex c = (Vertex) lo; c < hi; c++) {
+                J->next[c] = c;
+                EdgeIndex e = J->best[c];
+                if (J->comp[c] != c || e == NO_EDGE)
+                    continue;
+                Vertex other = J->comp[J->source[e]] == c ? J->comp[J->target[e]] : J->comp[J->source[e]];
+                if (J->best[other] == e && c < other)
+                    continue;
+                J->next[c] = other;
+                J->forest[__atomic_fetch_add(&J->forestCount, 1, __ATOMIC_RELAXED)] = e;
+            }
+            break;
+
+        case PHASE_JUMP:
+            threadSlice((EdgeIndex) J->n + 1, tid, threads, &lo, &hi);
+            for (Vertex c = (Vertex) lo; c < hi; c++) {
+                Vertex r = __atomic_load_n(&J->next[c], __ATOMIC_RELAXED);
+                Vertex up;
+                while ((up = __atomic_load_n(&J->next[r], __ATOMIC_RELAXED)) != r)
+                    r = up;
+                __atomic_store_n(&J->next[c], r, __ATOMIC_RELAXED);
+            }
+            break;
+
+        case PHASE_RELABEL:
+            threadSlice((EdgeIndex) J->n + 1, tid, threads, &lo, &hi);
+            for (EdgeIndex u = lo; u < hi; u++)
+                J->comp[u] = J->next[J->comp[u]];
+            break;
+
+        case PHASE_COUNT:
+        case PHASE_KEEP: {
+            // Edges still crossing components, counted then copied in order
+            EdgeIndex k = J->phase == PHASE_KEEP ? J->partial[tid] : 0;
+            threadSlice(J->liveCount, tid, threads, &lo, &hi);
+            for (EdgeIndex i = lo; i < hi; i++) {
+                EdgeIndex e = J->live != NULL ? J->live[i] : i;
+                if (J->comp[J->source[e]] != J->comp[J->target[e]]) {
+                    if (J->phase == PHASE_KEEP)
+                        J->kept[k] = e;
+                    k++;
+                }
+            }
+            if (J->phase == PHASE_COUNT)
+                J->partial[tid] = k;
+            break;
+        }
+    }
+}
+
+// runPhase()
+// Runs one phase of J on threads threads.
+// Private.
+static void runPhase(BoruvkaJob *J, int phase, int threads) {
+    J->phase = phase;
+    parallelRun(threads, boruvkaWorker, J);
+}
+
+// boruvkaForest()
+// Rounds of lightest-edge picks, hooking, pointer jumping and filtering until
+// no edge crosses components.
+EdgeList boruvkaForest(EdgeList E, double *total, int threads) {
+    if (E == NULL) {
+        printf("SpanningForest Error: boruvkaForest() called on NULL EdgeList reference\n");
+        exit(1);
+    }
+    if (threads <= 0)
+        threads = defaultThreads();
+
+    BoruvkaJob J;
+    J.n = edgeOrder(E);
+    J.source = edgeSources(E);
+    J.target = edgeTargets(E);
+    J.weight = edgeWeights(E);
+    J.comp = malloc(sizeof(Vertex) * ((size_t) J.n + 1));
+    J.next = malloc(sizeof(Vertex) * ((size_t) J.n + 1));
+    J.best = malloc(sizeof(EdgeIndex) * ((size_t) J.n + 1));
+    J.forest = malloc(sizeof(EdgeIndex) * ((size_t) J.n + 1));
+    J.partial = malloc(sizeof(EdgeIndex) * (size_t) threads);
+    J.live = NULL;
+    J.liveCount = edgeCount(E);
+    J.forestCount = 0;
+    for (Vertex u = 0; u <= J.n; u++)
+        J.comp[u] = u;
+
+    while (J.liveCount > 0) {
+        EdgeIndex before = J.forestCount;
+        runPhase(&J, PHASE_RESET, threads);
+        runPhase(&J, PHASE_BEST, threads);
+        runPhase(&J, PHASE_HOOK, threads);
+        if (J.forestCount == before)
+            break;
+        runPhase(&J, PHASE_JUMP, threads);
+        runPhase(&J, PHASE_RELABEL, threads);
+
+        runPhase(&J, PHASE_COUNT, threads);
+        EdgeIndex kept = 0;
+        for (int t = 0; t < threads; t++) {
+            EdgeIndex k = J.partial[t];
+            J.partial[t] = kept;
+            kept += k;
+        }
+        J.kept = malloc(sizeof(EdgeIndex) * (size_t) (kept > 0 ? kept : 1));
+        if (J.kept == NULL) {
+            printf("SpanningForest Error: boruvkaForest() unable to allocate %" PRIedge " edges\n", kept);
+            exit(1);
+        }
+        runPhase(&J, PHASE_KEEP, threads);
+        free(J.live);
+        J.live = J.kept;
+        J.liveCount = kept;
+    }
+
+    uint64_t *pick = malloc(sizeof(uint64_t) * (size_t) (J.forestCount > 0 ? J.forestCount : 1));
+    for (EdgeIndex i = 0; i < J.forestCount; i++)
+        pick[i] = (uint64_t) J.forest[i];
+    EdgeList F = makeForest(E, pick, J.forestCount, total, threads);
+
+    free(pick);
+    free(J.comp);
+    free(J.next);
+    free(J.best);
+    free(J.forest);
+    free(J.partial);
+    free(J.live);
+    return F;
+}
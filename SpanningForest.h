@@ -0,0 +1,34 @@
+//-----------------------------------------------------------------------------
+// SpanningForest.h
+// Header file for minimum spanning forests of weighted undirected edge lists
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_SPANNINGFOREST_H
+#define GRAPHADT_SPANNINGFOREST_H
+
+#include"EdgeList.h"
+
+// Both algorithms read E as an undirected graph, an unweighted E having every
+// weight 1, and break ties between equal weights by position in E. Under that
+// order the minimum spanning forest is unique, so both return the same edges:
+// one fewer than its vertices for every connected component, listed in the
+// order they appear in E, with their weights. If total is not NULL it
+// receives their weight summed in double. Self-loops and repeated edges are
+// allowed. threads <= 0 means defaultThreads().
+
+// kruskalForest()
+// Sorts (weight, position) keys of all edges with sortKeys(), then scans
+// them in order through a union-find over the vertices, stopping once the
+// forest spans. Needs 16 bytes per edge while sorting.
+// Pre: edgeCount(E) <= 2^32
+EdgeList kruskalForest(EdgeList E, double *total, int threads);
+
+// boruvkaForest()
+// Borůvka rounds: every component picks its lightest edge to another in
+// parallel, the picks are added to the forest and merged by pointer jumping,
+// and edges now inside one component are dropped. The component count at
+// least halves each round. Needs no sort, and after the first round up to 16
+// bytes per edge still crossing components.
+EdgeList boruvkaForest(EdgeList E, double *total, int threads);
+
+#endif //GRAPHADT_SPANNINGFOREST_H
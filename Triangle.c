@@ -0,0 +1,239 @@
+//-----------------------------------------------------------------------------
+// Triangle.c
+// Implementation file for triangle counting and clustering coefficients
+//-----------------------------------------------------------------------------
+
+#include "Triangle.h"
+#include "Intersect.h"
+#include "Parallel.h"
+
+// structs --------------------------------------------------------------------
+
+// private TriangleJob type: state shared by the threads of one count
+typedef struct TriangleJob {
+    Vertex n;
+    const EdgeIndex *offset;
+    const Vertex *target;
+
+    // Distinct non-loop degree of each vertex, which defines the ranking
+    EdgeIndex *degree;
+
+    // Oriented adjacency: out-neighbors of higher rank, ascending by ID
+    EdgeIndex *outOffset;
+    Vertex *outTarget;
+
+    EdgeIndex longest;
+
+    EdgeIndex *perVertex;
+    EdgeIndex *partial;
+
+    // Per-thread match buffers for per-vertex counts, allocated on first use
+    Vertex **buffer;
+    int phase;
+} TriangleJob;
+
+enum { PHASE_DEGREE, PHASE_OUTDEGREE, PHASE_ORIENT, PHASE_COUNT };
+
+
+// higherRank()
+// Returns true (1) if v ranks above u: larger degree, ties broken by ID.
+// Private.
+static int higherRank(const TriangleJob *J, Vertex u, Vertex v) {
+    return J->degree[v] > J->degree[u] || (J->degree[v] == J->degree[u] && v > u);
+}
+
+// orientVertex()
+// Counts, or when out is not NULL also writes, the distinct out-neighbors of
+// u after orientation.
+// Private.
+static EdgeIndex orientVertex(const TriangleJob *J, Vertex u, Vertex *out) {
+    EdgeIndex k = 0;
+    Vertex prev = NIL;
+
+    for (EdgeIndex e = J->offset[u]; e < J->offset[u + 1]; e++) {
+        Vertex v = J->target[e];
+        if (v == prev || v == u)
+            continue;
+        prev = v;
+        if (higherRank(J, u, v)) {
+            if (out != NULL)
+                out[k] = v;
+            k++;
+        }
+    }
+    return k;
+}
+
+// countVertex()
+// Counts the triangles whose lowest-ranked vertex is u, crediting each of
+// their vertices in perVertex if requested. buf is scratch for matches.
+// Private.
+static EdgeIndex countVertex(TriangleJob *J, Vertex u, Vertex *buf) {
+    const Vertex *a = J->outTarget + J->outOffset[u];
+    EdgeIndex na = J->outOffset[u + 1] - J->outOffset[u];
+    EdgeIndex total = 0;
+
+    for (EdgeIndex i = 0; i < na; i++) {
+        Vertex v = a[i];
+        const Vertex *b = J->outTarget + J->outOffset[v];
+        EdgeIndex nb = J->outOffset[v + 1] - J->outOffset[v];
+
+        if (J->perVertex == NULL) {
+            total += intersectSorted(a, na, b, nb, NULL);
+            continue;
+        }
+
+        EdgeIndex c = intersectSorted(a, na, b, nb, buf);
+        if (c > 0) {
+            __atomic_fetch_add(&J->perVertex[u], c, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&J->perVertex[v], c, __ATOMIC_RELAXED);
+            for (EdgeIndex k = 0; k < c; k++)
+                __atomic_fetch_add(&J->perVertex[buf[k]], 1, __ATOMIC_RELAXED);
+        }
+        total += c;
+    }
+    return total;
+}
+
+// triangleRange()
+// Runs the current phase of J over vertices lo..hi-1.
+// Private.
+static void triangleRange(EdgeIndex lo, EdgeIndex hi, int tid, void *arg) {
+    TriangleJob *J = arg;
+    EdgeIndex total = 0;
+    Vertex *buf = NULL;
+
+    if (J->phase == PHASE_COUNT && J->perVertex != NULL) {
+        if (J->buffer[tid] == NULL)
+            J->buffer[tid] = malloc(sizeof(Vertex) * (size_t) (J->longest + INTERSECT_PAD));
+        buf = J->buffer[tid];
+    }
+
+    for (Vertex u = (Vertex) lo; u < hi; u++) {
+        switch (J->phase) {
+            case PHASE_DEGREE: {
+                EdgeIndex d = 0;
+                Vertex prev = NIL;
+                for (EdgeIndex e = J->offset[u]; e < J->offset[u + 1]; e++) {
+                    if (J->target[e] != prev && J->target[e] != u)
+                        d++;
+                    prev = J->target[e];
+                }
+                J->degree[u] = d;
+                break;
+            }
+            case PHASE_OUTDEGREE:
+                // Stored one slot up so the prefix sum can run in place
+                J->outOffset[u + 1] = orientVertex(J, u, NULL);
+                break;
+            case PHASE_ORIENT:
+                orientVertex(J, u, J->outTarget + J->outOffset[u]);
+                break;
+            case PHASE_COUNT:
+                total += countVertex(J, u, buf);
+                break;
+        }
+    }
+
+    J->partial[tid] += total;
+}
+
+// runPhase()
+// Runs one phase of J on threads threads. Counting weighs each vertex by its
+// oriented out-degree, the other phases by its degree, so hubs are spread
+// across threads.
+// Private.
+static void runPhase(TriangleJob *J, int phase, int threads) {
+    J->phase = phase;
+    parallelFor(1, (EdgeIndex) J->n + 1, phase == PHASE_COUNT ? J->outOffset : J->offset, 0,
+                triangleRange, J, threads);
+}
+
+// countTriangles()
+// Returns the number of triangles in G, optionally per vertex.
+EdgeIndex countTriangles(Graph G, EdgeIndex *perVertex, int threads) {
+    if (G == NULL) {
+        printf("Triangle Error: countTriangles() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (threads <= 0)
+        threads = defaultThreads();
+
+    TriangleJob J;
+    J.n = getOrder(G);
+    getAdjacency(G, &J.offset, &J.target);
+    J.degree = malloc(sizeof(EdgeIndex) * ((size_t) J.n + 1));
+    J.outOffset = malloc(sizeof(EdgeIndex) * ((size_t) J.n + 2));
+    J.perVertex = perVertex;
+    J.partial = calloc((size_t) threads, sizeof(EdgeIndex));
+    J.buffer = calloc((size_t) threads, sizeof(Vertex *));
+
+    if (perVertex != NULL)
+        for (Vertex u = 0; u <= J.n; u++)
+            perVertex[u] = 0;
+
+    runPhase(&J, PHASE_DEGREE, threads);
+    runPhase(&J, PHASE_OUTDEGREE, threads);
+
+    // Longest out-list bounds the matches of any intersection
+    J.outOffset[0] = 0;
+    J.outOffset[1] = 0;
+    J.longest = 0;
+    for (Vertex u = 1; u <= J.n; u++) {
+        if (J.outOffset[u + 1] > J.longest)
+            J.longest = J.outOffset[u + 1];
+        J.outOffset[u + 1] += J.outOffset[u];
+    }
+    J.outTarget = malloc(sizeof(Vertex) * (size_t) (J.outOffset[J.n + 1] + 1));
+
+    runPhase(&J, PHASE_ORIENT, threads);
+    runPhase(&J, PHASE_COUNT, threads);
+
+    EdgeIndex total = 0;
+    for (int t = 0; t < threads; t++)
+        total += J.partial[t];
+
+    free(J.degree);
+    free(J.outOffset);
+    free(J.outTarget);
+    free(J.partial);
+    for (int t = 0; t < threads; t++)
+        free(J.buffer[t]);
+    free(J.buffer);
+    return total;
+}
+
+// clusteringCoefficients()
+// Sets coef[u] to the local clustering coefficient of u.
+void clusteringCoefficients(Graph G, double *coef, int threads) {
+    if (G == NULL) {
+        printf("Triangle Error: clusteringCoefficients() called on NULL Graph reference\n");
+        exit(1);
+    }
+    if (coef == NULL) {
+        printf("Triangle Error: clusteringCoefficients() called on NULL output array\n");
+        exit(1);
+    }
+
+    Vertex n = getOrder(G);
+    const EdgeIndex *offset;
+    const Vertex *target;
+    EdgeIndex *triangles = malloc(sizeof(EdgeIndex) * ((size_t) n + 1));
+
+    countTriangles(G, triangles, threads);
+    getAdjacency(G, &offset, &target);
+
+    coef[0] = 0;
+    for (Vertex u = 1; u <= n; u++) {
+        EdgeIndex d = 0;
+        Vertex prev = NIL;
+        for (EdgeIndex e = offset[u]; e < offset[u + 1]; e++) {
+            if (target[e] != prev && target[e] != u)
+                d++;
+            prev = target[e];
+        }
+        coef[u] = d < 2 ? 0.0 : 2.0 * (double) triangles[u] / ((double) d * (double) (d - 1));
+    }
+
+    free(triangles);
+}
@@ -0,0 +1,29 @@
+//-----------------------------------------------------------------------------
+// Triangle.h
+// Header file for triangle counting and clustering coefficients
+//-----------------------------------------------------------------------------
+
+#ifndef GRAPHADT_TRIANGLE_H
+#define GRAPHADT_TRIANGLE_H
+
+#include"Graph.h"
+
+// These functions treat G as undirected, i.e. built with addEdge(), and ignore
+// self-loops and repeated edges. Each vertex's adjacency is oriented towards
+// neighbors of higher (degree, ID) rank, so every triangle is found exactly
+// once by intersecting two short sorted out-neighbor lists. Work is spread
+// over threads threads; threads <= 0 means defaultThreads().
+
+// countTriangles()
+// Returns the number of triangles in G. If perVertex is not NULL, it must have
+// getOrder(G) + 1 entries and perVertex[u] is set to the number of triangles
+// containing u.
+EdgeIndex countTriangles(Graph G, EdgeIndex *perVertex, int threads);
+
+// clusteringCoefficients()
+// Sets coef[u], for 1 <= u <= getOrder(G), to the local clustering
+// coefficient of u: the fraction of pairs of u's neighbors that are joined by
+// an edge, or 0 when u has fewer than two neighbors.
+void clusteringCoefficients(Graph G, double *coef, int threads);
+
+#endif //GRAPHADT_TRIANGLE_H